@@ -23,6 +23,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 
+//页表和替换器由 latch_ 保护，并行扫描的各个线程可以同时取页和释放页
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
@@ -31,6 +32,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
     if(page_id == INVALID_PAGE_ID){
     LOG(WARNING)<<"invalid page id"<<std::endl;
       return nullptr;
@@ -72,6 +74,7 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
     int flag = 1;
     frame_id_t frame_id_new;
     if((free_list_.size()==0) && (replacer_->Size()==0))
@@ -108,27 +111,43 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-    if(page_id == INVALID_PAGE_ID)
-        return true;
-    if(page_table_.find(page_id) == page_table_.end())
-        return true;
-    auto ite = page_table_.find(page_id);
-    if(pages_[ite->second].pin_count_ != 0){
-        LOG(WARNING) << "Someone is using the page" << std::endl;
-        return false;
+    return DeletePages({page_id});
+}
+
+bool BufferPoolManager::DeletePages(const std::vector<page_id_t> &page_ids) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    bool deleted = true;
+    std::vector<page_id_t> to_deallocate;
+    to_deallocate.reserve(page_ids.size());
+    for(auto page_id : page_ids){
+        if(page_id == INVALID_PAGE_ID)
+            continue;
+        auto ite = page_table_.find(page_id);
+        if(ite != page_table_.end()){
+            frame_id_t frame_id = ite->second;
+            if(pages_[frame_id].pin_count_ != 0){
+                LOG(WARNING) << "Someone is using the page" << std::endl;
+                deleted = false;
+                continue;
+            }
+            // the page is gone, its dirty content is never written back
+            replacer_->Pin(frame_id);
+            pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+            pages_[frame_id].is_dirty_ = false;
+            pages_[frame_id].ResetMemory();
+            page_table_.erase(ite);
+            free_list_.push_back(frame_id);
+        }
+        // pages not in the pool are released as well, without reading them first
+        to_deallocate.push_back(page_id);
     }
-    if(pages_[ite->second].is_dirty_)
-        FlushPage(pages_[ite->second].page_id_);
-    DeallocatePage(page_id);
-    pages_[ite->second].page_id_ = INVALID_PAGE_ID;
-    pages_[ite->second].ResetMemory();
-    page_table_.erase(page_id);
-    free_list_.push_back(ite->second);
-    return true;
+    disk_manager_->DeAllocatePages(to_deallocate);
+    return deleted;
 }
 
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
     if(page_id == INVALID_PAGE_ID){
         return false;
     }
@@ -149,6 +168,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
     if(page_id == INVALID_PAGE_ID)
         return false;
     if(page_table_.find(page_id) == page_table_.end())
@@ -68,6 +68,8 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
         Page * catalog_meta_page = buffer_pool_manager->FetchPage(CATALOG_META_PAGE_ID);
         catalog_meta_->SerializeTo(catalog_meta_page->GetData());
         buffer_pool_manager->UnpinPage(CATALOG_META_PAGE_ID,true);
+        // persist the empty catalog at once so the db file can be reopened before shutdown
+        FlushCatalogMetaPage();
     }
     else{
         Page * catalog_meta_page = buffer_pool_manager->FetchPage(CATALOG_META_PAGE_ID);
@@ -148,7 +150,7 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info, const string &index_type) {
+                                    IndexInfo *&index_info, const string &index_type, bool unique) {
     auto temp = table_names_.find(table_name);
     if(temp == table_names_.end()){
         return DB_TABLE_NOT_EXIST;
@@ -173,12 +175,18 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
           return DB_COLUMN_NAME_NOT_EXIST;
         }
     }
+    IndexMetadata *index_meta = IndexMetadata::Create(next_index_id_,index_name,table_id,key_map,unique,index_type);
+    index_info = IndexInfo::Create();
+    index_info->Init(index_meta,tables_[table_id],buffer_pool_manager_);
+    // rows already in the table go in with one sorted bottom-up build, not one descent per row
+    if(index_info->GetIndex() == nullptr || BackfillIndex(index_info, tables_[table_id], txn) != DB_SUCCESS){
+        delete index_info;
+        index_info = nullptr;
+        return DB_FAILED;
+    }
     page_id_t index_page_id;
     auto index_page = buffer_pool_manager_->NewPage(index_page_id);
-    IndexMetadata *index_meta = IndexMetadata::Create(next_index_id_,index_name,table_id,key_map);
     index_meta->SerializeTo(index_page->GetData());
-    index_info = IndexInfo::Create();
-    index_info->Init(index_meta,tables_[table_id],buffer_pool_manager_,index_type);
     buffer_pool_manager_->UnpinPage(index_page_id,true);
 
     catalog_meta_->index_meta_pages_.emplace(next_index_id_,index_page_id);
@@ -199,6 +207,21 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
 }
 
 
+dberr_t CatalogManager::BackfillIndex(IndexInfo *index_info, TableInfo *table_info, Transaction *txn) {
+    auto table_heap = table_info->GetTableHeap();
+    //索引直接从迭代器读出的行取键列编码，不另建键行
+    auto iter = table_heap->Begin(txn);
+    auto end = table_heap->End();
+    bool started = false;
+    return index_info->GetIndex()->BulkLoad(index_info->GetKeyMapping(), [&]() -> const Row * {
+        if(started && iter != end){
+            ++iter;
+        }
+        started = true;
+        return iter != end ? &*iter : nullptr;
+    }, txn);
+}
+
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
                                  IndexInfo *&index_info) const {
     auto table_name_index_name_index= index_names_.find(table_name);
@@ -239,6 +262,13 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
         }
     }
     table_id_t table_id = table_names_[table_name];
+    TableInfo *table_info = tables_[table_id];
+    //释放表堆的全部页
+    table_info->GetTableHeap()->DeleteTable();
+    if(table_info->GetTableMetadata()->GetStatisticsPageId() != INVALID_PAGE_ID){
+        buffer_pool_manager_->DeletePage(table_info->GetTableMetadata()->GetStatisticsPageId());
+    }
+    delete table_info;
     table_names_.erase(table_name);
     tables_.erase(table_id);
     auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
@@ -259,6 +289,10 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
         return DB_INDEX_NOT_FOUND;
     }
     index_id_t index_id = index_map[index_name];
+    IndexInfo *index_info = indexes_[index_id];
+    //释放索引的全部页
+    index_info->GetIndex()->Destroy();
+    delete index_info;
     index_names_[table_name].erase(index_name);
     indexes_.erase(index_id);
     auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
@@ -270,6 +304,39 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
 }
 
 
+dberr_t CatalogManager::AnalyzeTable(const string &table_name, Transaction *txn) {
+    auto table = table_names_.find(table_name);
+    if(table == table_names_.end()){
+        return DB_TABLE_NOT_EXIST;
+    }
+    TableInfo *table_info = tables_[table->second];
+    auto statistics = TableStatistics::Collect(table_info->GetTableHeap(), table_info->GetSchema(), txn);
+    auto table_meta = table_info->GetTableMetadata();
+    page_id_t statistics_page_id = table_meta->GetStatisticsPageId();
+    Page *statistics_page;
+    if(statistics_page_id == INVALID_PAGE_ID){
+        //第一次分析时分配统计页，并把页号记进表的元数据
+        statistics_page = buffer_pool_manager_->NewPage(statistics_page_id);
+        if(statistics_page == nullptr){
+            delete statistics;
+            return DB_FAILED;
+        }
+        table_meta->SetStatisticsPageId(statistics_page_id);
+        page_id_t table_meta_page_id = catalog_meta_->table_meta_pages_[table->second];
+        auto table_meta_page = buffer_pool_manager_->FetchPage(table_meta_page_id);
+        table_meta->SerializeTo(table_meta_page->GetData());
+        buffer_pool_manager_->UnpinPage(table_meta_page_id,true);
+    }
+    else{
+        statistics_page = buffer_pool_manager_->FetchPage(statistics_page_id);
+    }
+    statistics->SerializeTo(statistics_page->GetData());
+    buffer_pool_manager_->UnpinPage(statistics_page_id,true);
+    table_info->SetStatistics(statistics);
+    return DB_SUCCESS;
+}
+
+
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
     buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID);
     return DB_SUCCESS;
@@ -288,6 +355,13 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
     TableHeap * table_heap = TableHeap::Create(buffer_pool_manager_,table_meta->GetFirstPageId(),table_meta->GetSchema(),log_manager_,lock_manager_);
     TableInfo * table_info = TableInfo::Create();
     table_info->Init(table_meta,table_heap);
+    if(table_meta->GetStatisticsPageId() != INVALID_PAGE_ID){
+        auto statistics_page = buffer_pool_manager_->FetchPage(table_meta->GetStatisticsPageId());
+        TableStatistics *statistics = nullptr;
+        TableStatistics::DeserializeFrom(statistics_page->GetData(),table_meta->GetSchema(),statistics);
+        buffer_pool_manager_->UnpinPage(table_meta->GetStatisticsPageId(),false);
+        table_info->SetStatistics(statistics);
+    }
     table_names_.emplace(table_meta->GetTableName(),table_id);
     tables_.emplace(table_id,table_info);
     return DB_SUCCESS;
@@ -303,8 +377,17 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
     IndexMetadata *index_meta= nullptr;
     IndexMetadata::DeserializeFrom(page_to_load->GetData(),index_meta);
     buffer_pool_manager_->UnpinPage(page_id,false);
+    if(index_meta == nullptr || tables_.find(index_meta->GetTableId()) == tables_.end()){
+        delete index_meta;
+        return DB_FAILED;
+    }
     IndexInfo * index_info = IndexInfo::Create();
     index_info->Init(index_meta,tables_[index_meta->GetTableId()],buffer_pool_manager_);
+    // an in-memory index keeps nothing on disk, rebuild it from the rows of its table
+    if(index_meta->GetIndexType() == "art" &&
+       BackfillIndex(index_info,tables_[index_meta->GetTableId()],nullptr) != DB_SUCCESS){
+        LOG(WARNING)<<"rebuild index "<<index_meta->GetIndexName()<<" failed"<<std::endl;
+    }
     std::string table_name = tables_.find(index_meta->GetTableId())->second->GetTableName();
     auto temp = index_names_.find(table_name);
     if(temp == index_names_.end()){
@@ -1,12 +1,17 @@
 #include "catalog/indexes.h"
 
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                             const std::vector<uint32_t> &key_map)
-    : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
+                             const std::vector<uint32_t> &key_map, bool unique, const std::string &index_type)
+    : index_id_(index_id),
+      index_name_(index_name),
+      table_id_(table_id),
+      key_map_(key_map),
+      unique_(unique),
+      index_type_(index_type) {}
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name, const table_id_t table_id,
-                                     const vector<uint32_t> &key_map) {
-  return new IndexMetadata(index_id, index_name, table_id, key_map);
+                                     const vector<uint32_t> &key_map, bool unique, const string &index_type) {
+  return new IndexMetadata(index_id, index_name, table_id, key_map, unique, index_type);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -35,13 +40,22 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
         MACH_WRITE_UINT32(buf, col_index);
         buf += 4;
     }
+    // unique
+    MACH_WRITE_TO(bool, buf, unique_);
+    buf += sizeof(bool);
+    // index type
+    MACH_WRITE_UINT32(buf, index_type_.length());
+    buf += 4;
+    MACH_WRITE_STRING(buf, index_type_);
+    buf += index_type_.length();
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
 }
 
 
 uint32_t IndexMetadata::GetSerializedSize() const {
-    return (sizeof(uint32_t)*3+sizeof(index_id_t)+index_name_.length()+sizeof(table_id_t)+sizeof(uint32_t)*key_map_.size());
+    return (sizeof(uint32_t)*3+sizeof(index_id_t)+index_name_.length()+sizeof(table_id_t)+sizeof(uint32_t)*key_map_.size()
+            +sizeof(bool)+sizeof(uint32_t)+index_type_.length());
 }
 
 uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
@@ -52,7 +66,13 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
     // magic num
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM, "Failed to deserialize index info.");
+    if (magic_num != INDEX_METADATA_MAGIC_NUM) {
+        // an index of an older format is not loaded rather than misread
+        LOG(ERROR) << (magic_num == LEGACY_INDEX_METADATA_MAGIC_NUM ? "Index written in an older format, recreate it."
+                                                                      : "Failed to deserialize index info.");
+        index_meta = nullptr;
+        return buf - p;
+    }
     // index id
     index_id_t index_id = MACH_READ_FROM(index_id_t, buf);
     buf += 4;
@@ -74,34 +94,38 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
         buf += 4;
         key_map.push_back(key_index);
     }
+    // unique
+    bool unique = MACH_READ_FROM(bool, buf);
+    buf += sizeof(bool);
+    // index type
+    len = MACH_READ_UINT32(buf);
+    buf += 4;
+    std::string index_type(buf, len);
+    buf += len;
     // allocate space for index meta data
-    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map);
+    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map, unique, index_type);
     return buf - p;
 }
 
 Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
-  size_t max_size = 0;
-  for (auto col : key_schema_->GetColumns()) {
-    max_size += col->GetLength();
+  // keys are stored at the exact width of their normalized columns
+  size_t max_size = KeyManager::GetEncodedSize(key_schema_);
+  // room for the row id that keeps the keys of a non-unique index apart, hash buckets keep it beside the key
+  if (!meta_data_->unique_ && index_type != "hash") {
+    max_size += sizeof(int64_t);
+  }
+  if (max_size > 256) {
+    LOG(ERROR) << "GenericKey size is too large";
+    return nullptr;
   }
 
   if (index_type == "bptree") {
-    if (max_size <= 8)
-      max_size = 16;
-    else if (max_size <= 24)
-      max_size = 32;
-    else if (max_size <= 56)
-      max_size = 64;
-    else if (max_size <= 120)
-      max_size = 128;
-    else if (max_size <= 248)
-      max_size = 256;
-    else {
-      LOG(ERROR) << "GenericKey size is too large";
-      return nullptr;
-    }
-  } else {
-    return nullptr;
+    return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager, meta_data_->unique_);
+  } else if (index_type == "hash") {
+    return new ExtendibleHashIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager,
+                                   meta_data_->unique_);
+  } else if (index_type == "art") {
+    return new ArtIndex(meta_data_->index_id_, key_schema_, max_size, meta_data_->unique_);
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return nullptr;
 }
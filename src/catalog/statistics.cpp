@@ -0,0 +1,295 @@
+#include "catalog/statistics.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+
+bool Less(const Field &a, const Field &b) { return a.CompareLessThan(b) == CmpBool::kTrue; }
+
+bool Equal(const Field &a, const Field &b) { return a.CompareEquals(b) == CmpBool::kTrue; }
+
+bool IsNumeric(const Field &field) {
+  return field.GetTypeId() == TypeId::kTypeInt || field.GetTypeId() == TypeId::kTypeFloat;
+}
+
+double NumericValue(const Field &field) {
+  char buf[sizeof(int32_t)];
+  field.SerializeTo(buf);
+  if (field.GetTypeId() == TypeId::kTypeInt) {
+    return MACH_READ_INT32(buf);
+  }
+  return MACH_READ_FROM(float, buf);
+}
+
+}  // namespace
+
+TableStatistics *TableStatistics::Collect(TableHeap *table_heap, const Schema *schema, Transaction *txn) {
+  auto statistics = new TableStatistics();
+  size_t pages, slots;
+  table_heap->GetSize(&pages, &slots);
+  statistics->page_count_ = pages;
+  //蓄水池抽样，第 n 行以 STATISTICS_SAMPLE_ROWS / n 的概率换掉样本中的一行
+  //种子固定，同样的表每次分析得到同样的统计和计划
+  std::vector<Row> sample;
+  std::mt19937_64 random(STATISTICS_SAMPLE_ROWS);
+  for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+    statistics->row_count_++;
+    if (sample.size() < STATISTICS_SAMPLE_ROWS) {
+      sample.push_back(*iter);
+      continue;
+    }
+    uint64_t slot = random() % statistics->row_count_;
+    if (slot < STATISTICS_SAMPLE_ROWS) {
+      sample[slot] = *iter;
+    }
+  }
+  for (uint32_t c = 0; c < schema->GetColumnCount(); c++) {
+    statistics->columns_.emplace_back();
+    auto &column = statistics->columns_.back();
+    auto value = [&sample, c](size_t i) -> const Field & { return *sample[i].GetField(c); };
+    std::vector<size_t> order;
+    for (size_t i = 0; i < sample.size(); i++) {
+      if (!value(i).IsNull()) {
+        order.push_back(i);
+      }
+    }
+    if (sample.empty()) {
+      continue;
+    }
+    column.null_fraction = double(sample.size() - order.size()) / sample.size();
+    if (order.empty()) {
+      continue;
+    }
+    std::sort(order.begin(), order.end(), [&value](size_t a, size_t b) { return Less(value(a), value(b)); });
+    //相等的值排在一起，每组记下出现次数和第一次出现的位置
+    std::vector<std::pair<size_t, size_t>> groups;
+    size_t singles = 0;
+    for (size_t i = 0; i < order.size();) {
+      size_t j = i + 1;
+      while (j < order.size() && Equal(value(order[i]), value(order[j]))) {
+        j++;
+      }
+      groups.emplace_back(j - i, i);
+      singles += j - i == 1;
+      i = j;
+    }
+    double n = order.size(), d = groups.size();
+    if (sample.size() == statistics->row_count_) {
+      column.distinct_count = d;
+    } else {
+      //样本只是表的一部分，按 Haas 和 Stokes 的估计量推算全表的不同值个数
+      double total = statistics->row_count_ * (1 - column.null_fraction);
+      column.distinct_count = std::min(std::max(n * d / (n - singles + singles * n / total), d), total);
+    }
+    //出现次数多于平均的值作为常见值
+    std::stable_sort(groups.begin(), groups.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+    for (const auto &group : groups) {
+      if (column.common_values.size() == STATISTICS_COMMON_VALUES || group.first < 2 || group.first * d <= n) {
+        break;
+      }
+      column.common_values.emplace_back(value(order[group.second]));
+      column.common_fractions.push_back(double(group.first) / sample.size());
+    }
+    //等深直方图，相邻两个边界之间的值一样多
+    size_t buckets = std::min<size_t>(STATISTICS_HISTOGRAM_BUCKETS, order.size() - 1);
+    column.bounds.emplace_back(value(order.front()));
+    for (size_t k = 1; k <= buckets; k++) {
+      column.bounds.emplace_back(value(order[k * (order.size() - 1) / buckets]));
+    }
+  }
+  while (statistics->GetSerializedSize() > PAGE_SIZE && statistics->Shrink()) {
+  }
+  return statistics;
+}
+
+bool TableStatistics::Shrink() {
+  bool shrunk = false;
+  for (auto &column : columns_) {
+    size_t keep = column.common_values.size() / 2;
+    while (column.common_values.size() > keep) {
+      column.common_values.pop_back();
+      column.common_fractions.pop_back();
+      shrunk = true;
+    }
+    //只剩最小值和最大值时不再减少
+    if (column.bounds.size() <= 2) {
+      continue;
+    }
+    //隔一个边界去掉一个，始终保留最小值和最大值
+    std::vector<Field> bounds;
+    for (size_t i = 0; i + 1 < column.bounds.size(); i += 2) {
+      bounds.emplace_back(column.bounds[i]);
+    }
+    bounds.emplace_back(column.bounds.back());
+    column.bounds.swap(bounds);
+    shrunk = true;
+  }
+  return shrunk;
+}
+
+uint32_t TableStatistics::SerializeTo(char *buf) const {
+  char *p = buf;
+  uint32_t ofs = GetSerializedSize();
+  ASSERT(ofs <= PAGE_SIZE, "Failed to serialize table statistics.");
+  MACH_WRITE_UINT32(buf, TABLE_STATISTICS_MAGIC_NUM);
+  buf += 4;
+  MACH_WRITE_TO(uint64_t, buf, row_count_);
+  buf += 8;
+  MACH_WRITE_TO(uint64_t, buf, page_count_);
+  buf += 8;
+  MACH_WRITE_UINT32(buf, columns_.size());
+  buf += 4;
+  for (const auto &column : columns_) {
+    MACH_WRITE_TO(double, buf, column.null_fraction);
+    buf += 8;
+    MACH_WRITE_TO(double, buf, column.distinct_count);
+    buf += 8;
+    MACH_WRITE_UINT32(buf, column.common_values.size());
+    buf += 4;
+    for (size_t i = 0; i < column.common_values.size(); i++) {
+      buf += column.common_values[i].SerializeTo(buf);
+      MACH_WRITE_TO(double, buf, column.common_fractions[i]);
+      buf += 8;
+    }
+    MACH_WRITE_UINT32(buf, column.bounds.size());
+    buf += 4;
+    for (const auto &bound : column.bounds) {
+      buf += bound.SerializeTo(buf);
+    }
+  }
+  ASSERT(buf - p == ofs, "Unexpected serialize size.");
+  return ofs;
+}
+
+uint32_t TableStatistics::GetSerializedSize() const {
+  uint32_t size = sizeof(uint32_t) * 2 + sizeof(uint64_t) * 2;
+  for (const auto &column : columns_) {
+    size += sizeof(double) * 2 + sizeof(uint32_t) * 2;
+    for (const auto &value : column.common_values) {
+      size += value.GetSerializedSize() + sizeof(double);
+    }
+    for (const auto &bound : column.bounds) {
+      size += bound.GetSerializedSize();
+    }
+  }
+  return size;
+}
+
+uint32_t TableStatistics::DeserializeFrom(char *buf, const Schema *schema, TableStatistics *&statistics) {
+  char *p = buf;
+  uint32_t magic_num = MACH_READ_UINT32(buf);
+  buf += 4;
+  ASSERT(magic_num == TABLE_STATISTICS_MAGIC_NUM, "Failed to deserialize table statistics.");
+  statistics = new TableStatistics();
+  statistics->row_count_ = MACH_READ_FROM(uint64_t, buf);
+  buf += 8;
+  statistics->page_count_ = MACH_READ_FROM(uint64_t, buf);
+  buf += 8;
+  uint32_t column_count = MACH_READ_UINT32(buf);
+  buf += 4;
+  auto read_field = [&buf](TypeId type, std::vector<Field> *fields) {
+    Field *field = nullptr;
+    buf += Field::DeserializeFrom(buf, type, &field, false);
+    fields->emplace_back(*field);
+    delete field;
+  };
+  for (uint32_t c = 0; c < column_count; c++) {
+    TypeId type = schema->GetColumn(c)->GetType();
+    statistics->columns_.emplace_back();
+    auto &column = statistics->columns_.back();
+    column.null_fraction = MACH_READ_FROM(double, buf);
+    buf += 8;
+    column.distinct_count = MACH_READ_FROM(double, buf);
+    buf += 8;
+    uint32_t common_count = MACH_READ_UINT32(buf);
+    buf += 4;
+    for (uint32_t i = 0; i < common_count; i++) {
+      read_field(type, &column.common_values);
+      column.common_fractions.push_back(MACH_READ_FROM(double, buf));
+      buf += 8;
+    }
+    uint32_t bound_count = MACH_READ_UINT32(buf);
+    buf += 4;
+    for (uint32_t i = 0; i < bound_count; i++) {
+      read_field(type, &column.bounds);
+    }
+  }
+  return buf - p;
+}
+
+double TableStatistics::EstimateSelectivity(uint32_t col_idx, const std::string &op, const Field &value) const {
+  const auto &column = columns_[col_idx];
+  double non_null = 1 - column.null_fraction;
+  if (op == "is") {
+    return column.null_fraction;
+  }
+  if (op == "not") {
+    return non_null;
+  }
+  //与空值比较的结果都不为真
+  if (value.IsNull()) {
+    return 0;
+  }
+  double equal = EqualFraction(col_idx, value);
+  double below = non_null * FractionBelow(col_idx, value);
+  double selectivity;
+  if (op == "=") {
+    selectivity = equal;
+  } else if (op == "<>") {
+    selectivity = non_null - equal;
+  } else if (op == "<") {
+    selectivity = below;
+  } else if (op == "<=") {
+    selectivity = below + equal;
+  } else if (op == ">") {
+    selectivity = non_null - below - equal;
+  } else if (op == ">=") {
+    selectivity = non_null - below;
+  } else {
+    return non_null;
+  }
+  return std::min(std::max(selectivity, 0.0), non_null);
+}
+
+double TableStatistics::EqualFraction(uint32_t col_idx, const Field &value) const {
+  const auto &column = columns_[col_idx];
+  for (size_t i = 0; i < column.common_values.size(); i++) {
+    if (Equal(column.common_values[i], value)) {
+      return column.common_fractions[i];
+    }
+  }
+  if (column.bounds.empty() || Less(value, column.bounds.front()) || Less(column.bounds.back(), value)) {
+    return 0;
+  }
+  //不常见的值平分常见值之外的行
+  double rest = 1 - column.null_fraction -
+                std::accumulate(column.common_fractions.begin(), column.common_fractions.end(), 0.0);
+  double others = column.distinct_count - column.common_values.size();
+  return others >= 1 ? std::max(rest, 0.0) / others : 0;
+}
+
+double TableStatistics::FractionBelow(uint32_t col_idx, const Field &value) const {
+  const auto &bounds = columns_[col_idx].bounds;
+  if (bounds.empty() || !Less(bounds.front(), value)) {
+    return 0;
+  }
+  if (Less(bounds.back(), value)) {
+    return 1;
+  }
+  //值落在第 i 个桶中：bounds[i] < value <= bounds[i + 1]
+  size_t i = 0;
+  while (Less(bounds[i + 1], value)) {
+    i++;
+  }
+  //数值在桶内按大小插值，字符串算作桶的一半
+  double inside = 0.5;
+  if (IsNumeric(value)) {
+    double low = NumericValue(bounds[i]), high = NumericValue(bounds[i + 1]);
+    if (high > low) {
+      inside = (NumericValue(value) - low) / (high - low);
+    }
+  }
+  return (i + inside) / (bounds.size() - 1);
+}
@@ -20,6 +20,11 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
     buf += 4;
     // table schema
     buf += schema_->SerializeTo(buf);
+    // statistics page id
+    MACH_WRITE_UINT32(buf, TABLE_STATISTICS_PAGE_MAGIC_NUM);
+    buf += 4;
+    MACH_WRITE_TO(page_id_t, buf, statistics_page_id_);
+    buf += 4;
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
 }
@@ -27,7 +32,7 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
 
 
 uint32_t TableMetadata::GetSerializedSize() const {
-    return (sizeof(uint32_t)*2+sizeof(table_id_t)+table_name_.length()+sizeof(page_id_t)+schema_->GetSerializedSize());
+    return (sizeof(uint32_t)*3+sizeof(table_id_t)+table_name_.length()+sizeof(page_id_t)*2+schema_->GetSerializedSize());
 }
 
 uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
@@ -55,6 +60,12 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     buf += TableSchema::DeserializeFrom(buf, schema);
     // allocate space for table metadata
     table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+    // statistics page id, absent from metadata written before ANALYZE existed
+    if (MACH_READ_UINT32(buf) == TABLE_STATISTICS_PAGE_MAGIC_NUM) {
+        buf += 4;
+        table_meta->statistics_page_id_ = MACH_READ_FROM(page_id_t, buf);
+        buf += 4;
+    }
     return buf - p;
 }
 
@@ -0,0 +1,397 @@
+#include "executor/compiled_predicate.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+
+namespace {
+
+template <typename T>
+inline bool Compare(CompareOp op, T lhs, T rhs) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return lhs == rhs;
+    case CompareOp::kNotEqual:
+      return lhs != rhs;
+    case CompareOp::kLessThan:
+      return lhs < rhs;
+    case CompareOp::kLessThanEquals:
+      return lhs <= rhs;
+    case CompareOp::kGreaterThan:
+      return lhs > rhs;
+    default:
+      return lhs >= rhs;
+  }
+}
+
+//与两个 char 字段比较的顺序一致
+inline int CompareChars(const char *lhs, uint32_t lhs_length, const char *rhs, uint32_t rhs_length) {
+  int ret = memcmp(lhs, rhs, std::min(lhs_length, rhs_length));
+  if (ret == 0 && lhs_length != rhs_length) {
+    ret = lhs_length < rhs_length ? -1 : 1;
+  }
+  return ret;
+}
+
+bool ParseCompareOp(const std::string &comp_type, CompareOp *op) {
+  static const std::pair<const char *, CompareOp> ops[] = {
+      {"=", CompareOp::kEqual},         {"<>", CompareOp::kNotEqual},    {"<", CompareOp::kLessThan},
+      {"<=", CompareOp::kLessThanEquals}, {">", CompareOp::kGreaterThan}, {">=", CompareOp::kGreaterThanEquals}};
+  for (const auto &entry : ops) {
+    if (comp_type == entry.first) {
+      *op = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+//交换左右两侧后结果不变的运算符
+CompareOp Mirror(CompareOp op) {
+  switch (op) {
+    case CompareOp::kLessThan:
+      return CompareOp::kGreaterThan;
+    case CompareOp::kLessThanEquals:
+      return CompareOp::kGreaterThanEquals;
+    case CompareOp::kGreaterThan:
+      return CompareOp::kLessThan;
+    case CompareOp::kGreaterThanEquals:
+      return CompareOp::kLessThanEquals;
+    default:
+      return op;
+  }
+}
+
+//批中一行的各列
+struct BatchSource {
+  const RowBatch &batch;
+  uint32_t position;
+
+  inline bool IsNull(uint32_t column) const { return batch.GetColumn(column).IsNull(position); }
+  inline int32_t GetInt(uint32_t column) const { return batch.GetColumn(column).GetInts()[position]; }
+  inline float GetFloat(uint32_t column) const { return batch.GetColumn(column).GetFloats()[position]; }
+  inline const char *GetChars(uint32_t column) const { return batch.GetColumn(column).GetChars(position); }
+  inline uint32_t GetCharLength(uint32_t column) const { return batch.GetColumn(column).GetCharLength(position); }
+};
+
+//一整行的各个字段，直接读字段的值，不复制 Field
+struct RowSource {
+  const Row &row;
+
+  inline bool IsNull(uint32_t column) const { return row.GetField(column)->IsNull(); }
+  inline int32_t GetInt(uint32_t column) const {
+    int32_t value;
+    row.GetField(column)->SerializeTo(reinterpret_cast<char *>(&value));
+    return value;
+  }
+  inline float GetFloat(uint32_t column) const {
+    float value;
+    row.GetField(column)->SerializeTo(reinterpret_cast<char *>(&value));
+    return value;
+  }
+  inline const char *GetChars(uint32_t column) const { return row.GetField(column)->GetData(); }
+  inline uint32_t GetCharLength(uint32_t column) const { return row.GetField(column)->GetLength(); }
+};
+
+}  // namespace
+
+CompiledPredicate::CompiledPredicate(const AbstractExpressionRef &predicate) {
+  if (predicate != nullptr && !Compile(predicate)) {
+    program_.clear();
+    chars_.clear();
+    fallback_ = predicate;
+    return;
+  }
+  for (const auto &instruction : program_) {
+    switch (instruction.opcode) {
+      case PredicateOpcode::kColumnCompare:
+        columns_.push_back(instruction.right_column);
+        columns_.push_back(instruction.column);
+        break;
+      case PredicateOpcode::kConstant:
+      case PredicateOpcode::kJumpIfFalse:
+      case PredicateOpcode::kJumpIfTrue:
+        break;
+      default:
+        columns_.push_back(instruction.column);
+    }
+  }
+  std::sort(columns_.begin(), columns_.end());
+  columns_.erase(std::unique(columns_.begin(), columns_.end()), columns_.end());
+  //只由整数、浮点与常量的比较和空值判断通过 and 连接时，结果就是各条指令结果的按位与
+  vectorized_ = !program_.empty() && std::all_of(program_.begin(), program_.end(), [](const auto &instruction) {
+    switch (instruction.opcode) {
+      case PredicateOpcode::kIntCompare:
+      case PredicateOpcode::kFloatCompare:
+      case PredicateOpcode::kIsNull:
+      case PredicateOpcode::kIsNotNull:
+      case PredicateOpcode::kJumpIfFalse:
+        return true;
+      default:
+        return false;
+    }
+  });
+}
+
+bool CompiledPredicate::Compile(const AbstractExpressionRef &expr) {
+  if (expr->GetType() == ExpressionType::ComparisonExpression) {
+    return CompileComparison(expr);
+  }
+  if (expr->GetType() != ExpressionType::LogicExpression) {
+    return false;
+  }
+  //两侧都只会是比较或逻辑表达式，结果只有真假两种，可以短路
+  auto logic_type = std::dynamic_pointer_cast<LogicExpression>(expr)->logic_type_;
+  if (!Compile(expr->GetChildAt(0))) {
+    return false;
+  }
+  size_t jump = program_.size();
+  program_.push_back({logic_type == LogicType::And ? PredicateOpcode::kJumpIfFalse : PredicateOpcode::kJumpIfTrue});
+  if (!Compile(expr->GetChildAt(1))) {
+    return false;
+  }
+  program_[jump].target = program_.size();
+  return true;
+}
+
+bool CompiledPredicate::CompileComparison(const AbstractExpressionRef &expr) {
+  auto comp_type = std::dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+  auto lhs = expr->GetChildAt(0), rhs = expr->GetChildAt(1);
+  auto is_operand = [](const AbstractExpressionRef &child) {
+    if (child->GetType() == ExpressionType::ConstantExpression) {
+      return true;
+    }
+    return child->GetType() == ExpressionType::ColumnExpression &&
+           std::dynamic_pointer_cast<ColumnValueExpression>(child)->GetRowIdx() == 0;
+  };
+  if (!is_operand(lhs) || !is_operand(rhs)) {
+    return false;
+  }
+  PredicateInstruction instruction{PredicateOpcode::kConstant};
+  if (comp_type == "is" || comp_type == "not") {
+    //只看左侧是否为空
+    bool is_null = (comp_type == "is");
+    if (lhs->GetType() == ExpressionType::ConstantExpression) {
+      instruction.int_value = std::dynamic_pointer_cast<ConstantValueExpression>(lhs)->val_.IsNull() == is_null;
+    } else {
+      instruction.opcode = is_null ? PredicateOpcode::kIsNull : PredicateOpcode::kIsNotNull;
+      instruction.column = std::dynamic_pointer_cast<ColumnValueExpression>(lhs)->GetColIdx();
+    }
+    program_.push_back(instruction);
+    return true;
+  }
+  CompareOp op;
+  if (!ParseCompareOp(comp_type, &op) || lhs->GetReturnType() != rhs->GetReturnType()) {
+    return false;
+  }
+  if (lhs->GetType() == ExpressionType::ConstantExpression) {
+    if (rhs->GetType() == ExpressionType::ConstantExpression) {
+      //两侧都是常量，编译时直接算出结果
+      instruction.int_value = (expr->Evaluate(nullptr).CompareEquals(Field(kTypeInt, 1)) == CmpBool::kTrue);
+      program_.push_back(instruction);
+      return true;
+    }
+    std::swap(lhs, rhs);
+    op = Mirror(op);
+  }
+  instruction.op = op;
+  instruction.type = lhs->GetReturnType();
+  instruction.column = std::dynamic_pointer_cast<ColumnValueExpression>(lhs)->GetColIdx();
+  if (rhs->GetType() == ExpressionType::ColumnExpression) {
+    instruction.opcode = PredicateOpcode::kColumnCompare;
+    instruction.right_column = std::dynamic_pointer_cast<ColumnValueExpression>(rhs)->GetColIdx();
+    program_.push_back(instruction);
+    return true;
+  }
+  const Field &value = std::dynamic_pointer_cast<ConstantValueExpression>(rhs)->val_;
+  if (value.IsNull()) {
+    //和空值比较永远不成立
+    instruction.opcode = PredicateOpcode::kConstant;
+    program_.push_back(instruction);
+    return true;
+  }
+  switch (instruction.type) {
+    case TypeId::kTypeInt:
+      instruction.opcode = PredicateOpcode::kIntCompare;
+      value.SerializeTo(reinterpret_cast<char *>(&instruction.int_value));
+      break;
+    case TypeId::kTypeFloat:
+      instruction.opcode = PredicateOpcode::kFloatCompare;
+      value.SerializeTo(reinterpret_cast<char *>(&instruction.float_value));
+      break;
+    case TypeId::kTypeChar:
+      instruction.opcode = PredicateOpcode::kCharCompare;
+      instruction.char_offset = chars_.size();
+      instruction.char_length = value.GetLength();
+      chars_.append(value.GetData(), value.GetLength());
+      break;
+    default:
+      return false;
+  }
+  program_.push_back(instruction);
+  return true;
+}
+
+bool CompiledPredicate::Evaluate(const Row &row) const {
+  if (fallback_ != nullptr) {
+    return fallback_->Evaluate(&row).CompareEquals(Field(kTypeInt, 1)) == CmpBool::kTrue;
+  }
+  return Run(RowSource{row});
+}
+
+bool CompiledPredicate::Evaluate(const TupleView &tuple) const {
+  ASSERT(fallback_ == nullptr, "Predicate is not compiled.");
+  //TupleView 的接口与其他来源一致，直接在序列化的数据上运行
+  return Run(tuple);
+}
+
+void CompiledPredicate::Filter(RowBatch *batch) const {
+  if (AcceptsAll()) {
+    return;
+  }
+  if (vectorized_) {
+    FilterVectorized(batch);
+    return;
+  }
+  auto &selection = batch->GetSelection();
+  size_t kept = 0;
+  if (fallback_ != nullptr) {
+    Row row;
+    for (size_t i = 0; i < selection.size(); i++) {
+      batch->GetFullRow(i, &row);
+      if (Evaluate(row)) {
+        selection[kept++] = selection[i];
+      }
+    }
+  } else {
+    for (auto position : selection) {
+      if (Run(BatchSource{*batch, position})) {
+        selection[kept++] = position;
+      }
+    }
+  }
+  selection.resize(kept);
+}
+
+void CompiledPredicate::FilterVectorized(RowBatch *batch) const {
+  const auto &kernels = FilterKernels::Best();
+  auto &selection = batch->GetSelection();
+  size_t words = (batch->Size() + 63) / 64;
+  std::vector<uint64_t> selected(words, 0), bitmap(words);
+  if (selection.size() == batch->Size()) {
+    //整批都被选中，直接置满
+    std::fill(selected.begin(), selected.end(), ~0ULL);
+    if (batch->Size() % 64 != 0) {
+      selected.back() = (1ULL << (batch->Size() % 64)) - 1;
+    }
+  } else {
+    for (auto position : selection) {
+      selected[position >> 6] |= 1ULL << (position & 63);
+    }
+  }
+  for (const auto &instruction : program_) {
+    if (instruction.opcode == PredicateOpcode::kJumpIfFalse) {
+      continue;
+    }
+    const auto &column = batch->GetColumn(instruction.column);
+    const uint64_t *nulls = column.GetNulls();
+    switch (instruction.opcode) {
+      case PredicateOpcode::kIntCompare:
+        kernels.compare_ints(column.GetInts(), column.Size(), instruction.op, instruction.int_value, bitmap.data());
+        for (size_t w = 0; w < words; w++) {
+          selected[w] &= bitmap[w] & ~nulls[w];
+        }
+        break;
+      case PredicateOpcode::kFloatCompare:
+        kernels.compare_floats(column.GetFloats(), column.Size(), instruction.op, instruction.float_value,
+                               bitmap.data());
+        for (size_t w = 0; w < words; w++) {
+          selected[w] &= bitmap[w] & ~nulls[w];
+        }
+        break;
+      case PredicateOpcode::kIsNull:
+        for (size_t w = 0; w < words; w++) {
+          selected[w] &= nulls[w];
+        }
+        break;
+      default:
+        for (size_t w = 0; w < words; w++) {
+          selected[w] &= ~nulls[w];
+        }
+        break;
+    }
+  }
+  //位图转回升序的选择向量
+  selection.clear();
+  for (size_t w = 0; w < words; w++) {
+    for (uint64_t word = selected[w]; word != 0; word &= word - 1) {
+      selection.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+    }
+  }
+}
+
+template <typename Source>
+bool CompiledPredicate::Run(const Source &source) const {
+  bool result = true;
+  size_t pc = 0;
+  while (pc < program_.size()) {
+    const auto &instruction = program_[pc++];
+    switch (instruction.opcode) {
+      case PredicateOpcode::kConstant:
+        result = instruction.int_value != 0;
+        break;
+      case PredicateOpcode::kIntCompare:
+        result = !source.IsNull(instruction.column) &&
+                 Compare(instruction.op, source.GetInt(instruction.column), instruction.int_value);
+        break;
+      case PredicateOpcode::kFloatCompare:
+        result = !source.IsNull(instruction.column) &&
+                 Compare(instruction.op, source.GetFloat(instruction.column), instruction.float_value);
+        break;
+      case PredicateOpcode::kCharCompare:
+        result = !source.IsNull(instruction.column) &&
+                 Compare(instruction.op,
+                         CompareChars(source.GetChars(instruction.column), source.GetCharLength(instruction.column),
+                                      chars_.data() + instruction.char_offset, instruction.char_length),
+                         0);
+        break;
+      case PredicateOpcode::kColumnCompare: {
+        uint32_t left = instruction.column, right = instruction.right_column;
+        if (source.IsNull(left) || source.IsNull(right)) {
+          result = false;
+        } else if (instruction.type == TypeId::kTypeInt) {
+          result = Compare(instruction.op, source.GetInt(left), source.GetInt(right));
+        } else if (instruction.type == TypeId::kTypeFloat) {
+          result = Compare(instruction.op, source.GetFloat(left), source.GetFloat(right));
+        } else {
+          result = Compare(instruction.op,
+                           CompareChars(source.GetChars(left), source.GetCharLength(left), source.GetChars(right),
+                                        source.GetCharLength(right)),
+                           0);
+        }
+        break;
+      }
+      case PredicateOpcode::kIsNull:
+        result = source.IsNull(instruction.column);
+        break;
+      case PredicateOpcode::kIsNotNull:
+        result = !source.IsNull(instruction.column);
+        break;
+      case PredicateOpcode::kJumpIfFalse:
+        if (!result) {
+          pc = instruction.target;
+        }
+        break;
+      case PredicateOpcode::kJumpIfTrue:
+        if (result) {
+          pc = instruction.target;
+        }
+        break;
+    }
+  }
+  return result;
+}
@@ -14,6 +14,12 @@ void DeleteExecutor::Init() {
   table_name = plan_->GetTableName();
   exec_ctx_->GetCatalog()->GetTable(table_name,table_info);
   table_heap = table_info->GetTableHeap();
+  flag = 0;
+  //索引列表只取一次，删除每一行时都要用
+  indexes.clear();
+  exec_ctx_->GetCatalog()->GetTableIndexes(table_name,indexes);
+  //要用子节点批中的整行维护索引
+  child_executor_->RequireFullRows();
   child_executor_->Init();
 }
 
@@ -21,18 +27,23 @@ bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   if(flag==1){
     return false;
   }
-  std::vector<IndexInfo *> indexes;
   int count = 0;//记录受影响的行数
   Row row_to_del;
   RowId rowid_to_del;
-  vector<Field> values_;
-  while(child_executor_->Next(&row_to_del, &rowid_to_del)){
-    exec_ctx_->GetCatalog()->GetTableIndexes(table_name,indexes);
-    table_heap->MarkDelete(rowid_to_del, nullptr);
-    for(auto index:indexes){
-      index->GetIndex()->RemoveEntry(row_to_del,rowid_to_del, nullptr);
+  RowBatch batch;
+  //按批从子节点取整行，索引键从整行中取
+  while(child_executor_->NextBatch(&batch)){
+    for(size_t row_i = 0; row_i < batch.SelectedCount(); row_i++){
+      batch.GetFullRow(row_i, &row_to_del);
+      rowid_to_del = row_to_del.GetRowId();
+      table_heap->MarkDelete(rowid_to_del, nullptr);
+      for(auto index:indexes){
+        Row key_row;
+        row_to_del.GetKeyFromRow(table_info->GetSchema(), index->GetIndexKeySchema(), key_row);
+        index->GetIndex()->RemoveEntry(key_row,rowid_to_del, nullptr);
+      }
+      count++;
     }
-    count++;
   }
   std::vector<Field> values;
   values.emplace_back(Field(kTypeInt,count));
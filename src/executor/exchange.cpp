@@ -0,0 +1,60 @@
+#include "executor/exchange.h"
+
+Exchange::Exchange(size_t morsel_count, size_t window) : slots_(morsel_count), window_(window) {}
+
+bool Exchange::TakeMorsel(size_t *morsel) {
+  std::unique_lock<std::mutex> lock(latch_);
+  consumed_.wait(lock, [this] { return closed_ || next_morsel_ >= slots_.size() || next_morsel_ < current_ + window_; });
+  if (closed_ || next_morsel_ >= slots_.size()) {
+    return false;
+  }
+  *morsel = next_morsel_++;
+  return true;
+}
+
+bool Exchange::Push(size_t morsel, RowBatch &&batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (closed_) {
+    return false;
+  }
+  slots_[morsel].batches.push_back(std::move(batch));
+  //只有消费者正在等的那一段需要唤醒它
+  if (morsel == current_) {
+    produced_.notify_one();
+  }
+  return true;
+}
+
+void Exchange::Finish(size_t morsel) {
+  std::unique_lock<std::mutex> lock(latch_);
+  slots_[morsel].finished = true;
+  if (morsel == current_) {
+    produced_.notify_one();
+  }
+}
+
+bool Exchange::Pop(RowBatch *batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (current_ < slots_.size()) {
+    auto &slot = slots_[current_];
+    produced_.wait(lock, [&slot] { return !slot.batches.empty() || slot.finished; });
+    if (!slot.batches.empty()) {
+      *batch = std::move(slot.batches.front());
+      slot.batches.pop_front();
+      return true;
+    }
+    //这一段读完了，后面的段可以开始
+    current_++;
+    consumed_.notify_all();
+  }
+  return false;
+}
+
+void Exchange::Close() {
+  std::unique_lock<std::mutex> lock(latch_);
+  closed_ = true;
+  for (auto &slot : slots_) {
+    slot.batches.clear();
+  }
+  consumed_.notify_all();
+}
@@ -8,9 +8,15 @@
 
 #include "common/result_writer.h"
 #include "executor/executors/delete_executor.h"
+#include "executor/executors/hash_aggregation_executor.h"
+#include "executor/executors/hash_join_executor.h"
+#include "executor/executors/index_nested_loop_join_executor.h"
 #include "executor/executors/index_scan_executor.h"
 #include "executor/executors/insert_executor.h"
+#include "executor/executors/limit_executor.h"
+#include "executor/executors/parallel_seq_scan_executor.h"
 #include "executor/executors/seq_scan_executor.h"
+#include "executor/executors/sort_executor.h"
 #include "executor/executors/update_executor.h"
 #include "executor/executors/values_executor.h"
 #include "glog/logging.h"
@@ -46,7 +52,11 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      auto seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+      if (seq_scan_plan->parallel_) {
+        return std::make_unique<ParallelSeqScanExecutor>(exec_ctx, seq_scan_plan);
+      }
+      return std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan);
     }
     // Create a new index scan executor
     case PlanType::IndexScan: {
@@ -72,6 +82,33 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
     case PlanType::Values: {
       return std::make_unique<ValuesExecutor>(exec_ctx, dynamic_cast<const ValuesPlanNode *>(plan.get()));
     }
+    case PlanType::HashJoin: {
+      auto hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(plan.get());
+      auto left_executor = CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan());
+      auto right_executor = CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan());
+      return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left_executor),
+                                                std::move(right_executor));
+    }
+    case PlanType::Aggregation: {
+      auto aggregation_plan = dynamic_cast<const AggregationPlanNode *>(plan.get());
+      auto child_executor = CreateExecutor(exec_ctx, aggregation_plan->GetChildPlan());
+      return std::make_unique<HashAggregationExecutor>(exec_ctx, aggregation_plan, std::move(child_executor));
+    }
+    case PlanType::Limit: {
+      auto limit_plan = dynamic_cast<const LimitPlanNode *>(plan.get());
+      auto child_executor = CreateExecutor(exec_ctx, limit_plan->GetChildPlan());
+      return std::make_unique<LimitExecutor>(exec_ctx, limit_plan, std::move(child_executor));
+    }
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan.get());
+      auto child_executor = CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+    case PlanType::IndexNestedLoopJoin: {
+      auto join_plan = dynamic_cast<const IndexNestedLoopJoinPlanNode *>(plan.get());
+      auto outer_executor = CreateExecutor(exec_ctx, join_plan->GetOuterPlan());
+      return std::make_unique<IndexNestedLoopJoinExecutor>(exec_ctx, join_plan, std::move(outer_executor));
+    }
     default:
       throw std::logic_error("Unsupported plan type.");
   }
@@ -79,25 +116,124 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
 
 dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<Row> *result_set, Transaction *txn,
                                    ExecuteContext *exec_ctx) {
+  auto collect = [result_set](const RowBatch &batch) {
+    if (result_set != nullptr) {
+      for (size_t i = 0; i < batch.SelectedCount(); i++) {
+        result_set->emplace_back();
+        batch.GetRow(i, &result_set->back());
+      }
+    }
+  };
+  dberr_t result = ExecutePlan(plan, collect, txn, exec_ctx);
+  if (result != DB_SUCCESS && result_set != nullptr) {
+    result_set->clear();
+  }
+  return result;
+}
+
+dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan,
+                                   const std::function<void(const RowBatch &)> &consume,
+                                   [[maybe_unused]] Transaction *txn, ExecuteContext *exec_ctx) {
   // Construct the executor for the abstract plan node
   auto executor = CreateExecutor(exec_ctx, plan);
 
   try {
     executor->Init();
-    RowId rid{};
-    Row row{};
-    while (executor->Next(&row, &rid)) {
-      if (result_set != nullptr) {
-        result_set->push_back(row);
-      }
+    RowBatch batch;
+    while (executor->NextBatch(&batch)) {
+      consume(batch);
     }
   } catch (const exception &ex) {
     std::cout << "Error Encountered in Executor Execution: " << ex.what() << std::endl;
-    if (result_set != nullptr) {
-      result_set->clear();
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteSelect(const AbstractPlanNodeRef &plan, ExecuteContext *context, size_t *row_count) {
+  auto schema = plan->OutputSchema();
+  uint32_t column_count = schema->GetColumnCount();
+  ResultWriter writer(std::cout);
+  std::vector<std::string> cells(column_count);
+  std::vector<bool> nulls(column_count);
+  //表格先攒下前几行定出列宽，之后的行读到就输出
+  std::vector<std::vector<std::string>> sample;
+  std::vector<int> data_width(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    data_width[i] = int(schema->GetColumn(i)->GetName().length());
+  }
+  bool header_written = false;
+  auto write_row = [&](const std::vector<std::string> &row_cells) {
+    if (output_format_ != OutputFormat::Table) {
+      writer.WriteDelimitedRow(output_format_, row_cells, nulls);
+      return;
     }
+    writer.BeginRow();
+    for (uint32_t i = 0; i < column_count; i++) {
+      writer.WriteCell(row_cells[i], data_width[i]);
+    }
+    writer.EndRow();
+  };
+  auto write_header = [&]() {
+    std::vector<std::string> names;
+    for (const auto &column : schema->GetColumns()) {
+      names.push_back(column->GetName());
+    }
+    header_written = true;
+    if (output_format_ != OutputFormat::Table) {
+      writer.WriteDelimitedRow(output_format_, names, std::vector<bool>(column_count, false));
+      return;
+    }
+    writer.Divider(data_width);
+    writer.BeginRow();
+    for (uint32_t i = 0; i < column_count; i++) {
+      writer.WriteHeaderCell(names[i], data_width[i]);
+    }
+    writer.EndRow();
+    writer.Divider(data_width);
+    for (const auto &sampled : sample) {
+      write_row(sampled);
+    }
+    sample.clear();
+  };
+  //CSV 和 TSV 不需要列宽，表头直接输出
+  if (output_format_ != OutputFormat::Table) {
+    write_header();
+  }
+  *row_count = 0;
+  Row row;
+  auto print = [&](const RowBatch &batch) {
+    for (size_t i = 0; i < batch.SelectedCount(); i++) {
+      batch.GetRow(i, &row);
+      for (uint32_t j = 0; j < column_count; j++) {
+        nulls[j] = row.GetField(j)->IsNull();
+        cells[j] = row.GetField(j)->toString();
+      }
+      (*row_count)++;
+      if (header_written) {
+        write_row(cells);
+        continue;
+      }
+      for (uint32_t j = 0; j < column_count; j++) {
+        data_width[j] = max(data_width[j], int(cells[j].size()));
+      }
+      sample.push_back(cells);
+      if (sample.size() >= RESULT_SAMPLE_ROWS) {
+        write_header();
+      }
+    }
+    //每批行都立即输出，不等查询结束
+    std::cout.flush();
+  };
+  if (ExecutePlan(plan, print, nullptr, context) != DB_SUCCESS) {
     return DB_FAILED;
   }
+  if (output_format_ == OutputFormat::Table && *row_count > 0) {
+    if (!header_written) {
+      write_header();
+    }
+    writer.Divider(data_width);
+  }
   return DB_SUCCESS;
 }
 
@@ -130,6 +266,10 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteCreateIndex(ast, context.get());
     case kNodeDropIndex:
       return ExecuteDropIndex(ast, context.get());
+    case kNodeVacuumIndex:
+      return ExecuteVacuumIndex(ast, context.get());
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context.get());
     case kNodeTrxBegin:
       return ExecuteTrxBegin(ast, context.get());
     case kNodeTrxCommit:
@@ -146,10 +286,18 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   // Plan the query.
   Planner planner(context.get());
   std::vector<Row> result_set{};
+  size_t row_count = 0;
   try {
     planner.PlanQuery(ast);
-    // Execute the query.
-    ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
+    // Execute the query, the rows of a select are printed as they are produced.
+    if (ast->type_ == kNodeSelect) {
+      if (ExecuteSelect(planner.plan_, context.get(), &row_count) != DB_SUCCESS) {
+        return DB_FAILED;
+      }
+    } else {
+      ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
+      row_count = result_set.size();
+    }
   } catch (const exception &ex) {
     std::cout << "Error Encountered in Planner: " << ex.what() << std::endl;
     return DB_FAILED;
@@ -157,51 +305,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   auto stop_time = std::chrono::system_clock::now();
   double duration_time =
       double((std::chrono::duration_cast<std::chrono::milliseconds>(stop_time - start_time)).count());
-  // Return the result set as string.
-  std::stringstream ss;
-  ResultWriter writer(ss);
-
-  if (planner.plan_->GetType() == PlanType::SeqScan || planner.plan_->GetType() == PlanType::IndexScan) {
-    auto schema = planner.plan_->OutputSchema();
-    auto num_of_columns = schema->GetColumnCount();
-    if (!result_set.empty()) {
-      // find the max width for each column
-      vector<int> data_width(num_of_columns, 0);
-      for (const auto &row : result_set) {
-        for (uint32_t i = 0; i < num_of_columns; i++) {
-          data_width[i] = max(data_width[i], int(row.GetField(i)->toString().size()));
-        }
-      }
-      int k = 0;
-      for (const auto &column : schema->GetColumns()) {
-        data_width[k] = max(data_width[k], int(column->GetName().length()));
-        k++;
-      }
-      // Generate header for the result set.
-      writer.Divider(data_width);
-      k = 0;
-      writer.BeginRow();
-      for (const auto &column : schema->GetColumns()) {
-        writer.WriteHeaderCell(column->GetName(), data_width[k++]);
-      }
-      writer.EndRow();
-      writer.Divider(data_width);
-
-      // Transforming result set into strings.
-      for (const auto &row : result_set) {
-        writer.BeginRow();
-        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
-          writer.WriteCell(row.GetField(i)->toString(), data_width[i]);
-        }
-        writer.EndRow();
-      }
-      writer.Divider(data_width);
-    }
-    writer.EndInformation(result_set.size(), duration_time, true);
-  } else {
-    writer.EndInformation(result_set.size(), duration_time, false);
-  }
-  std::cout << writer.stream_.rdbuf();
+  ResultWriter writer(std::cout);
+  writer.EndInformation(row_count, duration_time, ast->type_ == kNodeSelect);
   return DB_SUCCESS;
 }
 
@@ -397,6 +502,10 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   if(result == DB_TABLE_ALREADY_EXIST){
     return DB_TABLE_ALREADY_EXIST;
   }
+  //没有主键就不建主键索引，空键的唯一索引会让第二行起的插入全部冲突
+  if(primary_keys.empty()){
+    return DB_SUCCESS;
+  }
   string index_name = table_name+"_primary_key_index";//
   IndexInfo *index_info;
   dbs_[current_db_]->catalog_mgr_->CreateIndex(table_name,index_name,primary_keys, nullptr,index_info,"bptree");
@@ -448,13 +557,47 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     LOG(WARNING)<<"unknown mistake"<<std::endl;
     return DB_FAILED;
   }
+  //USING 子句可选，btree 为默认
+  string index_type = "bptree";
+  if(temp->next_ != nullptr && temp->next_->child_ != nullptr){
+    string type_name = temp->next_->child_->val_;
+    if(type_name == "hash" || type_name == "art"){
+      index_type = type_name;
+    }
+    else if(type_name != "btree" && type_name != "bptree"){
+      LOG(WARNING)<<"Unsupported index type "<<type_name<<"."<<std::endl;
+      return DB_FAILED;
+    }
+  }
   temp=temp->child_;
   while(temp != nullptr){
     index_keys.push_back(temp->val_);
     temp = temp->next_;
   }
+  //主键索引之外，只有单个unique列上的索引是唯一索引，其余索引允许重复键
+  bool unique = false;
+  TableInfo *table_info;
+  IndexInfo *primary_index;
+  vector<string> primary_keys;
+  if(dbs_[current_db_]->catalog_mgr_->GetIndex(table_name,table_name+"_primary_key_index",primary_index) == DB_SUCCESS){
+    for(auto col:primary_index->GetIndexKeySchema()->GetColumns()){
+      primary_keys.push_back(col->GetName());
+    }
+  }
+  if(dbs_[current_db_]->catalog_mgr_->GetTable(table_name,table_info) == DB_SUCCESS){
+    uint32_t col_index;
+    if(index_keys == primary_keys){
+      unique = true;
+    }
+    else if(index_keys.size() == 1 && table_info->GetSchema()->GetColumnIndex(index_keys[0],col_index) == DB_SUCCESS){
+      //联合主键中的列也被标记为unique，但单独看并不唯一
+      bool in_composite_key = primary_keys.size() > 1 &&
+                              find(primary_keys.begin(),primary_keys.end(),index_keys[0]) != primary_keys.end();
+      unique = table_info->GetSchema()->GetColumn(col_index)->IsUnique() && !in_composite_key;
+    }
+  }
   IndexInfo *index_info;
-  dberr_t result = dbs_[current_db_]->catalog_mgr_->CreateIndex(table_name,index_name,index_keys, nullptr,index_info,"bptree");
+  dberr_t result = dbs_[current_db_]->catalog_mgr_->CreateIndex(table_name,index_name,index_keys, nullptr,index_info,index_type,unique);
   return result;
 }
 
@@ -481,6 +624,58 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_INDEX_NOT_FOUND;
 }
 
+dberr_t ExecuteEngine::ExecuteVacuumIndex(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuumIndex" << std::endl;
+#endif
+  if(current_db_.empty()){
+    LOG(WARNING)<<"No database selected."<<std::endl;
+    return DB_FAILED;
+  }
+  string index_name = ast->child_->val_;
+  std::vector<TableInfo *> tables;
+  dbs_[current_db_]->catalog_mgr_->GetTables(tables);
+  for(auto table : tables){
+    std::vector<IndexInfo *> indexes;
+    dbs_[current_db_]->catalog_mgr_->GetTableIndexes(table->GetTableName(),indexes);
+    for(auto index : indexes){
+      if(index->GetIndexName() != index_name){
+        continue;
+      }
+      //只有 B+ 树会推迟合并，其他索引没有需要整理的页
+      if(index->GetIndexType() != "bptree"){
+        return DB_SUCCESS;
+      }
+      return reinterpret_cast<BPlusTreeIndex *>(index->GetIndex())->Vacuum(nullptr);
+    }
+  }
+  return DB_INDEX_NOT_FOUND;
+}
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  if(current_db_.empty()){
+    LOG(WARNING)<<"No database selected."<<std::endl;
+    return DB_FAILED;
+  }
+  auto catalog = dbs_[current_db_]->catalog_mgr_;
+  if(ast->child_ != nullptr){
+    return catalog->AnalyzeTable(ast->child_->val_, nullptr);
+  }
+  //不指定表时分析所有的表
+  std::vector<TableInfo *> tables;
+  catalog->GetTables(tables);
+  for(auto table : tables){
+    dberr_t result = catalog->AnalyzeTable(table->GetTableName(), nullptr);
+    if(result != DB_SUCCESS){
+      return result;
+    }
+  }
+  return DB_SUCCESS;
+}
+
 
 dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
@@ -0,0 +1,189 @@
+#include "executor/filter_kernels.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MINISQL_AVX2_KERNELS
+#endif
+
+namespace {
+
+template <CompareOp op, typename T>
+inline bool CompareValue(T lhs, T rhs) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return lhs == rhs;
+    case CompareOp::kNotEqual:
+      return lhs != rhs;
+    case CompareOp::kLessThan:
+      return lhs < rhs;
+    case CompareOp::kLessThanEquals:
+      return lhs <= rhs;
+    case CompareOp::kGreaterThan:
+      return lhs > rhs;
+    default:
+      return lhs >= rhs;
+  }
+}
+
+template <CompareOp op, typename T>
+void CompareScalar(const T *values, size_t count, T constant, uint64_t *bitmap) {
+  for (size_t base = 0; base < count; base += 64) {
+    size_t n = std::min<size_t>(64, count - base);
+    uint64_t word = 0;
+    for (size_t i = 0; i < n; i++) {
+      word |= static_cast<uint64_t>(CompareValue<op>(values[base + i], constant)) << i;
+    }
+    bitmap[base / 64] = word;
+  }
+}
+
+template <typename T>
+void CompareScalarDispatch(const T *values, size_t count, CompareOp op, T constant, uint64_t *bitmap) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return CompareScalar<CompareOp::kEqual>(values, count, constant, bitmap);
+    case CompareOp::kNotEqual:
+      return CompareScalar<CompareOp::kNotEqual>(values, count, constant, bitmap);
+    case CompareOp::kLessThan:
+      return CompareScalar<CompareOp::kLessThan>(values, count, constant, bitmap);
+    case CompareOp::kLessThanEquals:
+      return CompareScalar<CompareOp::kLessThanEquals>(values, count, constant, bitmap);
+    case CompareOp::kGreaterThan:
+      return CompareScalar<CompareOp::kGreaterThan>(values, count, constant, bitmap);
+    default:
+      return CompareScalar<CompareOp::kGreaterThanEquals>(values, count, constant, bitmap);
+  }
+}
+
+#ifdef MINISQL_AVX2_KERNELS
+
+//AVX2 只有相等和大于两种整数比较，其余由它们取反或交换得到：invert 表示结果还要按位取反
+template <CompareOp op>
+__attribute__((target("avx2"))) inline __m256i IntMask(__m256i values, __m256i constant) {
+  switch (op) {
+    case CompareOp::kEqual:
+    case CompareOp::kNotEqual:
+      return _mm256_cmpeq_epi32(values, constant);
+    case CompareOp::kGreaterThan:
+    case CompareOp::kLessThanEquals:
+      return _mm256_cmpgt_epi32(values, constant);
+    default:
+      return _mm256_cmpgt_epi32(constant, values);
+  }
+}
+
+template <CompareOp op>
+__attribute__((target("avx2"))) void CompareIntsAvx2(const int32_t *values, size_t count, int32_t constant,
+                                                      uint64_t *bitmap) {
+  constexpr bool invert =
+      (op == CompareOp::kNotEqual || op == CompareOp::kLessThanEquals || op == CompareOp::kGreaterThanEquals);
+  __m256i broadcast = _mm256_set1_epi32(constant);
+  size_t words = count / 64;
+  for (size_t w = 0; w < words; w++) {
+    uint64_t word = 0;
+    for (int k = 0; k < 8; k++) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + w * 64 + k * 8));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(IntMask<op>(block, broadcast))));
+      word |= static_cast<uint64_t>(mask) << (k * 8);
+    }
+    bitmap[w] = invert ? ~word : word;
+  }
+  //不足 64 个的尾部用标量处理
+  CompareScalar<op>(values + words * 64, count - words * 64, constant, bitmap + words);
+}
+
+//浮点比较直接有对应的谓词，不等于对 NaN 为真，与标量的 != 一致
+template <CompareOp op>
+__attribute__((target("avx2"))) inline __m256 FloatMask(__m256 values, __m256 constant) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return _mm256_cmp_ps(values, constant, _CMP_EQ_OQ);
+    case CompareOp::kNotEqual:
+      return _mm256_cmp_ps(values, constant, _CMP_NEQ_UQ);
+    case CompareOp::kLessThan:
+      return _mm256_cmp_ps(values, constant, _CMP_LT_OQ);
+    case CompareOp::kLessThanEquals:
+      return _mm256_cmp_ps(values, constant, _CMP_LE_OQ);
+    case CompareOp::kGreaterThan:
+      return _mm256_cmp_ps(values, constant, _CMP_GT_OQ);
+    default:
+      return _mm256_cmp_ps(values, constant, _CMP_GE_OQ);
+  }
+}
+
+template <CompareOp op>
+__attribute__((target("avx2"))) void CompareFloatsAvx2(const float *values, size_t count, float constant,
+                                                        uint64_t *bitmap) {
+  __m256 broadcast = _mm256_set1_ps(constant);
+  size_t words = count / 64;
+  for (size_t w = 0; w < words; w++) {
+    uint64_t word = 0;
+    for (int k = 0; k < 8; k++) {
+      __m256 block = _mm256_loadu_ps(values + w * 64 + k * 8);
+      auto mask = static_cast<uint32_t>(_mm256_movemask_ps(FloatMask<op>(block, broadcast)));
+      word |= static_cast<uint64_t>(mask) << (k * 8);
+    }
+    bitmap[w] = word;
+  }
+  CompareScalar<op>(values + words * 64, count - words * 64, constant, bitmap + words);
+}
+
+void CompareIntsAvx2Dispatch(const int32_t *values, size_t count, CompareOp op, int32_t constant, uint64_t *bitmap) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return CompareIntsAvx2<CompareOp::kEqual>(values, count, constant, bitmap);
+    case CompareOp::kNotEqual:
+      return CompareIntsAvx2<CompareOp::kNotEqual>(values, count, constant, bitmap);
+    case CompareOp::kLessThan:
+      return CompareIntsAvx2<CompareOp::kLessThan>(values, count, constant, bitmap);
+    case CompareOp::kLessThanEquals:
+      return CompareIntsAvx2<CompareOp::kLessThanEquals>(values, count, constant, bitmap);
+    case CompareOp::kGreaterThan:
+      return CompareIntsAvx2<CompareOp::kGreaterThan>(values, count, constant, bitmap);
+    default:
+      return CompareIntsAvx2<CompareOp::kGreaterThanEquals>(values, count, constant, bitmap);
+  }
+}
+
+void CompareFloatsAvx2Dispatch(const float *values, size_t count, CompareOp op, float constant, uint64_t *bitmap) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return CompareFloatsAvx2<CompareOp::kEqual>(values, count, constant, bitmap);
+    case CompareOp::kNotEqual:
+      return CompareFloatsAvx2<CompareOp::kNotEqual>(values, count, constant, bitmap);
+    case CompareOp::kLessThan:
+      return CompareFloatsAvx2<CompareOp::kLessThan>(values, count, constant, bitmap);
+    case CompareOp::kLessThanEquals:
+      return CompareFloatsAvx2<CompareOp::kLessThanEquals>(values, count, constant, bitmap);
+    case CompareOp::kGreaterThan:
+      return CompareFloatsAvx2<CompareOp::kGreaterThan>(values, count, constant, bitmap);
+    default:
+      return CompareFloatsAvx2<CompareOp::kGreaterThanEquals>(values, count, constant, bitmap);
+  }
+}
+
+#endif  // MINISQL_AVX2_KERNELS
+
+}  // namespace
+
+const FilterKernels &FilterKernels::Scalar() {
+  static const FilterKernels kernels{"scalar", CompareScalarDispatch<int32_t>, CompareScalarDispatch<float>};
+  return kernels;
+}
+
+const FilterKernels *FilterKernels::Avx2() {
+#ifdef MINISQL_AVX2_KERNELS
+  static const FilterKernels kernels{"avx2", CompareIntsAvx2Dispatch, CompareFloatsAvx2Dispatch};
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported ? &kernels : nullptr;
+#else
+  return nullptr;
+#endif
+}
+
+const FilterKernels &FilterKernels::Best() {
+  static const FilterKernels &best = (Avx2() != nullptr ? *Avx2() : Scalar());
+  return best;
+}
@@ -0,0 +1,444 @@
+#include "executor/executors/hash_aggregation_executor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "executor/executors/parallel_seq_scan_executor.h"
+#include "planner/expressions/column_value_expression.h"
+
+namespace {
+// FNV-1a over the key bytes, finished with the murmur3 mix as the hash join does
+uint64_t HashBytes(const char *data, size_t size) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+int32_t ToInt(int64_t value) {
+  if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+    throw std::out_of_range("the aggregate " + std::to_string(value) + " does not fit in an int");
+  }
+  return static_cast<int32_t>(value);
+}
+}  // namespace
+
+size_t HashAggregationExecutor::GroupTable::Find(const char *key, size_t size, uint64_t hash, bool insert) {
+  if (slots_.empty()) {
+    if (!insert) {
+      return kNoGroup;
+    }
+    slots_.assign(16, kNoGroup);
+  }
+  size_t mask = slots_.size() - 1;
+  size_t slot = hash & mask;
+  for (; slots_[slot] != kNoGroup; slot = (slot + 1) & mask) {
+    size_t group = slots_[slot];
+    if (hashes_[group] == hash && GetKeySize(group) == size && (size == 0 || memcmp(GetKey(group), key, size) == 0)) {
+      return group;
+    }
+  }
+  if (!insert) {
+    return kNoGroup;
+  }
+  size_t group = hashes_.size();
+  slots_[slot] = group;
+  hashes_.push_back(hash);
+  key_bytes_.insert(key_bytes_.end(), key, key + size);
+  key_offsets_.push_back(key_bytes_.size());
+  accumulators_.resize(accumulators_.size() + aggregate_count_);
+  //键、两个槽位、哈希值、键偏移和累加器
+  memory_ += size + 3 * sizeof(size_t) + sizeof(uint64_t) + aggregate_count_ * sizeof(Accumulator);
+  if (hashes_.size() * 2 > slots_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+void HashAggregationExecutor::GroupTable::Grow() {
+  slots_.assign(slots_.size() * 2, kNoGroup);
+  size_t mask = slots_.size() - 1;
+  for (size_t group = 0; group < hashes_.size(); group++) {
+    size_t slot = hashes_[group] & mask;
+    while (slots_[slot] != kNoGroup) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = group;
+  }
+}
+
+HashAggregationExecutor::HashAggregationExecutor(ExecuteContext *exec_ctx, const AggregationPlanNode *plan,
+                                                 std::unique_ptr<AbstractExecutor> child, size_t memory_budget)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)), memory_budget_(memory_budget) {}
+
+void HashAggregationExecutor::Init() {
+  ResetBatchAdapter();
+  key_columns_.clear();
+  key_types_.clear();
+  for (const auto &group_by : plan_->GetGroupBys()) {
+    auto column = dynamic_pointer_cast<ColumnValueExpression>(group_by);
+    key_columns_.push_back(column->GetColIdx());
+    key_types_.push_back(column->GetReturnType());
+  }
+  aggregate_types_.clear();
+  aggregate_columns_.clear();
+  aggregate_arg_types_.clear();
+  for (const auto &expr : plan_->GetAggregates()) {
+    auto aggregate = dynamic_pointer_cast<AggregateExpression>(expr);
+    aggregate_types_.push_back(aggregate->GetAggregationType());
+    if (aggregate->GetChildren().empty()) {
+      aggregate_columns_.push_back(0);
+      aggregate_arg_types_.push_back(TypeId::kTypeInt);
+      continue;
+    }
+    auto column = dynamic_pointer_cast<ColumnValueExpression>(aggregate->GetChildAt(0));
+    aggregate_columns_.push_back(column->GetColIdx());
+    aggregate_arg_types_.push_back(column->GetReturnType());
+  }
+  partials_.clear();
+  partitions_.clear();
+  next_partition_ = 0;
+  output_group_ = 0;
+  child_->Init();
+  auto parallel_scan = dynamic_cast<ParallelSeqScanExecutor *>(child_.get());
+  if (parallel_scan != nullptr) {
+    //各扫描线程先在自己的表中预聚合，预算平分
+    for (size_t i = 0; i < parallel_scan->GetWorkerCount(); i++) {
+      partials_.emplace_back(aggregate_types_.size());
+    }
+    size_t budget = memory_budget_ / partials_.size();
+    parallel_scan->ScanInto(
+        [this, budget](size_t worker, RowBatch *batch) { Aggregate(&partials_[worker], batch, budget); });
+  } else {
+    partials_.emplace_back(aggregate_types_.size());
+    RowBatch batch;
+    while (child_->NextBatch(&batch)) {
+      Aggregate(&partials_[0], &batch, memory_budget_);
+    }
+  }
+  //各线程的组合并到第一个表中
+  GroupTable *table = &partials_[0].table;
+  for (size_t i = 1; i < partials_.size(); i++) {
+    for (size_t group = 0; group < partials_[i].table.GetGroupCount(); group++) {
+      Merge(table, &partials_[i].table, group);
+    }
+    partials_[i].table = GroupTable(aggregate_types_.size());
+  }
+  //没有分组列时，即使没有输入也输出一行
+  if (key_columns_.empty() && table->GetGroupCount() == 0) {
+    table->Find(nullptr, 0, HashBytes(nullptr, 0), true);
+  }
+  bool spilled = std::any_of(partials_.begin(), partials_.end(), [](const Partial &partial) {
+    return !partial.spills.empty();
+  });
+  if (!spilled) {
+    output_table_ = table;
+    return;
+  }
+  //内存中的组按溢出时的分区拆开，每个分区与其溢出的行一起完成
+  output_table_ = nullptr;
+  for (uint32_t i = 0; i < SPILL_PARTITIONS; i++) {
+    partitions_.emplace_back(aggregate_types_.size());
+  }
+  for (size_t group = 0; group < table->GetGroupCount(); group++) {
+    Merge(&partitions_[(table->GetHash(group) >> 32) % SPILL_PARTITIONS].table, table, group);
+  }
+  *table = GroupTable(aggregate_types_.size());
+}
+
+void HashAggregationExecutor::Aggregate(Partial *partial, RowBatch *batch, size_t budget) {
+  auto &selection = batch->GetSelection();
+  auto &table = partial->table;
+  auto &groups = partial->groups;
+  groups.assign(selection.size(), 0);
+  if (key_columns_.empty()) {
+    //没有分组列时只有一个键为空的组
+    if (table.GetGroupCount() == 0) {
+      table.Find(nullptr, 0, HashBytes(nullptr, 0), true);
+    }
+  }
+  for (size_t i = 0; i < selection.size() && !key_columns_.empty(); i++) {
+    uint32_t position = selection[i];
+    auto &key = partial->key;
+    key.clear();
+    //每列先写一个字节标明是否为空，字符串再写长度，不同的键编码一定不同
+    for (auto key_column : key_columns_) {
+      const ColumnVector &column = batch->GetOutputColumn(key_column);
+      if (column.IsNull(position)) {
+        key.push_back(1);
+        continue;
+      }
+      key.push_back(0);
+      switch (column.GetType()) {
+        case TypeId::kTypeInt:
+          key.append(reinterpret_cast<const char *>(&column.GetInts()[position]), sizeof(int32_t));
+          break;
+        case TypeId::kTypeFloat: {
+          //-0.0与0.0相等，编码也要相同
+          float value = column.GetFloats()[position] == 0.0f ? 0.0f : column.GetFloats()[position];
+          key.append(reinterpret_cast<const char *>(&value), sizeof(float));
+          break;
+        }
+        default: {
+          uint32_t length = column.GetCharLength(position);
+          key.append(reinterpret_cast<const char *>(&length), sizeof(length));
+          key.append(column.GetChars(position), length);
+        }
+      }
+    }
+    uint64_t hash = HashBytes(key.data(), key.size());
+    bool spilling = !partial->spills.empty();
+    groups[i] = table.Find(key.data(), key.size(), hash, !spilling);
+    if (groups[i] != GroupTable::kNoGroup) {
+      if (!spilling && table.GetMemoryUsage() > budget) {
+        for (uint32_t p = 0; p < SPILL_PARTITIONS; p++) {
+          partial->spills.push_back(
+              std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), child_->GetOutputSchema()));
+        }
+      }
+      continue;
+    }
+    //超出预算后，新组的行写到其分区，留到最后再聚合；分区用哈希的高位，低位留给表内的槽位
+    batch->GetRow(i, &partial->row);
+    partial->spills[(hash >> 32) % SPILL_PARTITIONS]->Append(partial->row);
+  }
+  for (size_t a = 0; a < aggregate_types_.size(); a++) {
+    if (aggregate_types_[a] == AggregationType::CountStar) {
+      //count(*) 不读任何列，只有一个组时直接加上整批的行数
+      if (key_columns_.empty()) {
+        table.GetAccumulators(0)[a].count += selection.size();
+        continue;
+      }
+      for (auto group : groups) {
+        if (group != GroupTable::kNoGroup) {
+          table.GetAccumulators(group)[a].count++;
+        }
+      }
+      continue;
+    }
+    const ColumnVector &column = batch->GetOutputColumn(aggregate_columns_[a]);
+    for (size_t i = 0; i < selection.size(); i++) {
+      if (groups[i] != GroupTable::kNoGroup && !column.IsNull(selection[i])) {
+        Update(&table.GetAccumulators(groups[i])[a], a, column, selection[i]);
+      }
+    }
+  }
+}
+
+void HashAggregationExecutor::Update(Accumulator *accumulator, size_t a, const ColumnVector &column,
+                                     uint32_t position) const {
+  auto agg_type = aggregate_types_[a];
+  bool first = accumulator->count++ == 0;
+  if (agg_type == AggregationType::Count) {
+    return;
+  }
+  bool sum = agg_type == AggregationType::Sum || agg_type == AggregationType::Avg;
+  bool min = agg_type == AggregationType::Min;
+  switch (column.GetType()) {
+    case TypeId::kTypeInt: {
+      int32_t value = column.GetInts()[position];
+      if (sum) {
+        accumulator->int_value += value;
+      } else if (first || (min ? value < accumulator->int_value : value > accumulator->int_value)) {
+        accumulator->int_value = value;
+      }
+      break;
+    }
+    case TypeId::kTypeFloat: {
+      float value = column.GetFloats()[position];
+      if (sum) {
+        accumulator->float_value += value;
+      } else if (first || (min ? value < accumulator->float_value : value > accumulator->float_value)) {
+        accumulator->float_value = value;
+      }
+      break;
+    }
+    default: {
+      //字符串只会取 min 或 max
+      const char *data = column.GetChars(position);
+      uint32_t length = column.GetCharLength(position);
+      int compared = accumulator->chars.compare(0, std::string::npos, data, length);
+      if (first || (min ? compared > 0 : compared < 0)) {
+        accumulator->chars.assign(data, length);
+      }
+    }
+  }
+}
+
+void HashAggregationExecutor::Merge(GroupTable *into, GroupTable *from, size_t group) const {
+  size_t target = into->Find(from->GetKey(group), from->GetKeySize(group), from->GetHash(group), true);
+  Accumulator *to = into->GetAccumulators(target);
+  Accumulator *other = from->GetAccumulators(group);
+  for (size_t a = 0; a < aggregate_types_.size(); a++) {
+    if (other[a].count == 0) {
+      continue;
+    }
+    bool first = to[a].count == 0;
+    to[a].count += other[a].count;
+    switch (aggregate_types_[a]) {
+      case AggregationType::CountStar:
+      case AggregationType::Count:
+        break;
+      case AggregationType::Sum:
+      case AggregationType::Avg:
+        to[a].int_value += other[a].int_value;
+        to[a].float_value += other[a].float_value;
+        break;
+      default: {
+        bool min = aggregate_types_[a] == AggregationType::Min;
+        if (aggregate_arg_types_[a] == TypeId::kTypeInt) {
+          if (first || (min ? other[a].int_value < to[a].int_value : other[a].int_value > to[a].int_value)) {
+            to[a].int_value = other[a].int_value;
+          }
+        } else if (aggregate_arg_types_[a] == TypeId::kTypeFloat) {
+          if (first || (min ? other[a].float_value < to[a].float_value : other[a].float_value > to[a].float_value)) {
+            to[a].float_value = other[a].float_value;
+          }
+        } else {
+          int compared = to[a].chars.compare(other[a].chars);
+          if (first || (min ? compared > 0 : compared < 0)) {
+            to[a].chars = std::move(other[a].chars);
+          }
+        }
+      }
+    }
+  }
+}
+
+Field HashAggregationExecutor::Result(const Accumulator &accumulator, size_t a) const {
+  auto agg_type = aggregate_types_[a];
+  auto arg_type = aggregate_arg_types_[a];
+  if (agg_type == AggregationType::CountStar || agg_type == AggregationType::Count) {
+    return Field(TypeId::kTypeInt, ToInt(accumulator.count));
+  }
+  //没有非空值时结果为空
+  if (accumulator.count == 0) {
+    return Field(agg_type == AggregationType::Avg ? TypeId::kTypeFloat : arg_type);
+  }
+  if (agg_type == AggregationType::Avg) {
+    double sum = arg_type == TypeId::kTypeInt ? accumulator.int_value : accumulator.float_value;
+    return Field(TypeId::kTypeFloat, static_cast<float>(sum / accumulator.count));
+  }
+  switch (arg_type) {
+    case TypeId::kTypeInt:
+      return Field(TypeId::kTypeInt, ToInt(accumulator.int_value));
+    case TypeId::kTypeFloat:
+      return Field(TypeId::kTypeFloat, static_cast<float>(accumulator.float_value));
+    default:
+      return Field(TypeId::kTypeChar, const_cast<char *>(accumulator.chars.c_str()), accumulator.chars.size(), true);
+  }
+}
+
+Row HashAggregationExecutor::MakeOutputRow(GroupTable *table, size_t group) const {
+  std::vector<Field> fields;
+  //从键中解出各分组列的值
+  const char *key = table->GetKey(group);
+  for (auto type : key_types_) {
+    if (*key++ == 1) {
+      fields.emplace_back(type);
+      continue;
+    }
+    switch (type) {
+      case TypeId::kTypeInt: {
+        int32_t value;
+        memcpy(&value, key, sizeof(value));
+        key += sizeof(value);
+        fields.emplace_back(type, value);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        float value;
+        memcpy(&value, key, sizeof(value));
+        key += sizeof(value);
+        fields.emplace_back(type, value);
+        break;
+      }
+      default: {
+        uint32_t length;
+        memcpy(&length, key, sizeof(length));
+        key += sizeof(length);
+        fields.emplace_back(type, const_cast<char *>(key), length, true);
+        key += length;
+      }
+    }
+  }
+  Accumulator *accumulators = table->GetAccumulators(group);
+  for (size_t a = 0; a < aggregate_types_.size(); a++) {
+    fields.emplace_back(Result(accumulators[a], a));
+  }
+  Row aggregated(fields);
+  std::vector<Field> output;
+  output.reserve(plan_->GetOutputExprs().size());
+  for (const auto &expr : plan_->GetOutputExprs()) {
+    output.emplace_back(expr->Evaluate(&aggregated));
+  }
+  return Row(output);
+}
+
+void HashAggregationExecutor::Close() {
+  child_->Close();
+  output_table_ = nullptr;
+  partials_.clear();
+  partitions_.clear();
+}
+
+bool HashAggregationExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool HashAggregationExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (output_table_ != nullptr && output_group_ < output_table_->GetGroupCount()) {
+      batch->Append(MakeOutputRow(output_table_, output_group_++));
+      continue;
+    }
+    if (!NextPartition()) {
+      break;
+    }
+  }
+  return batch->Size() > 0;
+}
+
+bool HashAggregationExecutor::NextPartition() {
+  if (next_partition_ >= partitions_.size()) {
+    return false;
+  }
+  //上一个分区已经输出完，释放它的组
+  if (next_partition_ > 0) {
+    partitions_[next_partition_ - 1].table = GroupTable(aggregate_types_.size());
+  }
+  auto &partition = partitions_[next_partition_];
+  RowBatch batch;
+  batch.Reset(child_->GetOutputSchema());
+  Row row;
+  for (auto &partial : partials_) {
+    if (partial.spills.empty()) {
+      continue;
+    }
+    auto &spill = partial.spills[next_partition_];
+    spill->Rewind();
+    while (spill->Read(&row)) {
+      batch.Append(row);
+      //一个分区超出预算也整体聚合，键严重倾斜时不再继续细分
+      if (batch.IsFull()) {
+        Aggregate(&partition, &batch, std::numeric_limits<size_t>::max());
+        batch.Clear();
+      }
+    }
+    spill.reset();
+  }
+  if (batch.Size() > 0) {
+    Aggregate(&partition, &batch, std::numeric_limits<size_t>::max());
+  }
+  output_table_ = &partition.table;
+  output_group_ = 0;
+  next_partition_++;
+  return true;
+}
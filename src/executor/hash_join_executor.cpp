@@ -0,0 +1,307 @@
+#include "executor/executors/hash_join_executor.h"
+
+namespace {
+constexpr size_t kEnd = static_cast<size_t>(-1);
+}  // namespace
+
+HashJoinExecutor::HashJoinExecutor(ExecuteContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                                   size_t memory_budget)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_(std::move(left)),
+      right_(std::move(right)),
+      memory_budget_(memory_budget) {}
+
+void HashJoinExecutor::Init() {
+  ResetBatchAdapter();
+  left_->Init();
+  right_->Init();
+  build_rows_.clear();
+  heads_.clear();
+  chain_.clear();
+  build_hashes_.clear();
+  probe_rows_.clear();
+  probe_cursor_ = 0;
+  probe_child_ = nullptr;
+  probe_batch_.Clear();
+  probe_batch_cursor_ = 0;
+  has_probe_row_ = false;
+  left_partitions_.clear();
+  right_partitions_.clear();
+  next_partition_ = 0;
+  probe_file_ = nullptr;
+  Side left(left_.get());
+  Side right(right_.get());
+  //两边轮流读入，先读完的一边较小，用它建哈希表
+  while (left.bytes + right.bytes <= memory_budget_) {
+    if (!Pull(&left)) {
+      Build(std::move(left.rows), true);
+      probe_rows_ = std::move(right.rows);
+      probe_child_ = right_.get();
+      return;
+    }
+    if (!Pull(&right)) {
+      Build(std::move(right.rows), false);
+      probe_rows_ = std::move(left.rows);
+      probe_child_ = left_.get();
+      return;
+    }
+  }
+  Spill(&left, &right);
+}
+
+void HashJoinExecutor::Close() {
+  left_->Close();
+  right_->Close();
+  build_rows_.clear();
+  heads_.clear();
+  chain_.clear();
+  build_hashes_.clear();
+  probe_rows_.clear();
+  probe_child_ = nullptr;
+  has_probe_row_ = false;
+  left_partitions_.clear();
+  right_partitions_.clear();
+  probe_file_ = nullptr;
+}
+
+bool HashJoinExecutor::Pull(Side *side) {
+  RowBatch batch;
+  if (!side->child->NextBatch(&batch)) {
+    return false;
+  }
+  auto schema = const_cast<Schema *>(side->child->GetOutputSchema());
+  for (size_t i = 0; i < batch.SelectedCount(); i++) {
+    Row row;
+    batch.GetRow(i, &row);
+    side->bytes += row.GetSerializedSize(schema);
+    side->rows.push_back(std::move(row));
+  }
+  return true;
+}
+
+uint64_t HashJoinExecutor::HashKeys(const Row &row, const std::vector<AbstractExpressionRef> &keys,
+                                    std::vector<Field> *values, bool *has_null) {
+  // FNV-1a over the key values, finished with the murmur3 mix as the hash indexes do
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](const char *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      hash ^= static_cast<uint8_t>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+  };
+  values->clear();
+  *has_null = false;
+  for (const auto &key : keys) {
+    values->emplace_back(key->Evaluate(&row));
+    const Field &value = values->back();
+    if (value.IsNull()) {
+      *has_null = true;
+      continue;
+    }
+    if (value.GetTypeId() == TypeId::kTypeChar) {
+      mix(value.GetData(), value.GetLength());
+      continue;
+    }
+    char data[sizeof(int32_t)];
+    value.SerializeTo(data);
+    //-0.0与0.0相等，哈希也要相同
+    if (value.GetTypeId() == TypeId::kTypeFloat) {
+      float number;
+      memcpy(&number, data, sizeof(float));
+      if (number == 0.0f) {
+        memset(data, 0, sizeof(data));
+      }
+    }
+    mix(data, sizeof(data));
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+void HashJoinExecutor::Build(std::vector<Row> &&rows, bool build_left) {
+  build_left_ = build_left;
+  build_rows_ = std::move(rows);
+  const auto &keys = build_left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  size_t buckets = 1;
+  while (buckets < build_rows_.size()) {
+    buckets <<= 1;
+  }
+  bucket_mask_ = buckets - 1;
+  heads_.assign(buckets, kEnd);
+  chain_.assign(build_rows_.size(), kEnd);
+  build_hashes_.assign(build_rows_.size(), 0);
+  //倒序插入链表头，每个桶内仍按读入顺序排列
+  for (size_t i = build_rows_.size(); i-- > 0;) {
+    bool has_null;
+    uint64_t hash = HashKeys(build_rows_[i], keys, &build_keys_, &has_null);
+    if (has_null) {
+      continue;
+    }
+    build_hashes_[i] = hash;
+    chain_[i] = heads_[hash & bucket_mask_];
+    heads_[hash & bucket_mask_] = i;
+  }
+}
+
+bool HashJoinExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool HashJoinExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (!has_probe_row_) {
+      if (!NextProbeRow()) {
+        break;
+      }
+      bool has_null;
+      probe_hash_ = HashKeys(probe_row_, build_left_ ? plan_->GetRightKeys() : plan_->GetLeftKeys(), &probe_keys_,
+                             &has_null);
+      //空值不与任何行相等
+      if (has_null) {
+        continue;
+      }
+      match_ = heads_[probe_hash_ & bucket_mask_];
+      has_probe_row_ = true;
+    }
+    Probe(batch);
+  }
+  return batch->Size() > 0;
+}
+
+void HashJoinExecutor::Probe(RowBatch *batch) {
+  const auto &keys = build_left_ ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  auto predicate = plan_->GetPredicate();
+  while (match_ != kEnd && !batch->IsFull()) {
+    size_t i = match_;
+    match_ = chain_[i];
+    if (build_hashes_[i] != probe_hash_) {
+      continue;
+    }
+    bool has_null;
+    HashKeys(build_rows_[i], keys, &build_keys_, &has_null);
+    bool equal = true;
+    for (size_t k = 0; k < build_keys_.size() && equal; k++) {
+      equal = build_keys_[k].CompareEquals(probe_keys_[k]) == CmpBool::kTrue;
+    }
+    if (!equal) {
+      continue;
+    }
+    const Row *left = build_left_ ? &build_rows_[i] : &probe_row_;
+    const Row *right = build_left_ ? &probe_row_ : &build_rows_[i];
+    if (predicate != nullptr &&
+        predicate->EvaluateJoin(left, right).CompareEquals(Field(kTypeInt, 1)) != CmpBool::kTrue) {
+      continue;
+    }
+    std::vector<Field> fields;
+    fields.reserve(plan_->GetOutputExprs().size());
+    for (const auto &expr : plan_->GetOutputExprs()) {
+      fields.emplace_back(expr->EvaluateJoin(left, right));
+    }
+    batch->Append(Row(fields));
+  }
+  has_probe_row_ = match_ != kEnd;
+}
+
+bool HashJoinExecutor::NextProbeRow() {
+  while (true) {
+    if (probe_cursor_ < probe_rows_.size()) {
+      probe_row_ = std::move(probe_rows_[probe_cursor_++]);
+      return true;
+    }
+    if (!probe_rows_.empty()) {
+      probe_rows_.clear();
+      probe_cursor_ = 0;
+    }
+    if (probe_child_ != nullptr) {
+      if (probe_batch_cursor_ < probe_batch_.SelectedCount()) {
+        probe_batch_.GetRow(probe_batch_cursor_++, &probe_row_);
+        return true;
+      }
+      probe_batch_cursor_ = 0;
+      if (!probe_child_->NextBatch(&probe_batch_)) {
+        probe_child_ = nullptr;
+        probe_batch_.Clear();
+      }
+      continue;
+    }
+    if (probe_file_ != nullptr && probe_file_->Read(&probe_row_)) {
+      return true;
+    }
+    probe_file_ = nullptr;
+    if (!NextPartition()) {
+      return false;
+    }
+  }
+}
+
+void HashJoinExecutor::Spill(Side *left, Side *right) {
+  auto bpm = exec_ctx_->GetBufferPoolManager();
+  for (uint32_t i = 0; i < SPILL_PARTITIONS; i++) {
+    left_partitions_.push_back(std::make_unique<SpillFile>(bpm, left_->GetOutputSchema()));
+    right_partitions_.push_back(std::make_unique<SpillFile>(bpm, right_->GetOutputSchema()));
+  }
+  auto partition = [this](Side *side, const std::vector<AbstractExpressionRef> &keys,
+                          std::vector<std::unique_ptr<SpillFile>> *files) {
+    auto write = [this, &keys, files](const Row &row) {
+      bool has_null;
+      uint64_t hash = HashKeys(row, keys, &build_keys_, &has_null);
+      //键含空值的行不会有匹配，直接丢弃
+      if (!has_null) {
+        //分区用哈希的高位，低位留给分区内的哈希表
+        (*files)[(hash >> 32) % SPILL_PARTITIONS]->Append(row);
+      }
+    };
+    for (const auto &row : side->rows) {
+      write(row);
+    }
+    side->rows.clear();
+    RowBatch batch;
+    Row row;
+    while (side->child->NextBatch(&batch)) {
+      for (size_t i = 0; i < batch.SelectedCount(); i++) {
+        batch.GetRow(i, &row);
+        write(row);
+      }
+    }
+  };
+  partition(left, plan_->GetLeftKeys(), &left_partitions_);
+  partition(right, plan_->GetRightKeys(), &right_partitions_);
+}
+
+bool HashJoinExecutor::NextPartition() {
+  while (next_partition_ < left_partitions_.size()) {
+    //上一对分区已经连接完，释放其页
+    if (next_partition_ > 0) {
+      left_partitions_[next_partition_ - 1].reset();
+      right_partitions_[next_partition_ - 1].reset();
+    }
+    auto &left = left_partitions_[next_partition_];
+    auto &right = right_partitions_[next_partition_];
+    next_partition_++;
+    if (left->GetRowCount() == 0 || right->GetRowCount() == 0) {
+      continue;
+    }
+    //一个分区超出预算也整体读入，键严重倾斜时不再继续细分
+    bool build_left = left->GetByteSize() <= right->GetByteSize();
+    SpillFile *build = build_left ? left.get() : right.get();
+    std::vector<Row> rows;
+    rows.reserve(build->GetRowCount());
+    Row row;
+    build->Rewind();
+    while (build->Read(&row)) {
+      rows.push_back(std::move(row));
+    }
+    Build(std::move(rows), build_left);
+    probe_file_ = build_left ? right.get() : left.get();
+    probe_file_->Rewind();
+    return true;
+  }
+  left_partitions_.clear();
+  right_partitions_.clear();
+  return false;
+}
@@ -0,0 +1,128 @@
+#include "executor/executors/index_nested_loop_join_executor.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "index/b_plus_tree_index.h"
+
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(ExecuteContext *exec_ctx,
+                                                         const IndexNestedLoopJoinPlanNode *plan,
+                                                         std::unique_ptr<AbstractExecutor> outer)
+    : AbstractExecutor(exec_ctx), plan_(plan), outer_(std::move(outer)) {}
+
+void IndexNestedLoopJoinExecutor::Init() {
+  ResetBatchAdapter();
+  outer_->Init();
+  exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableName(), table_info_);
+  inner_predicate_ = CompiledPredicate(plan_->GetInnerPredicate());
+  joined_.clear();
+  joined_cursor_ = 0;
+}
+
+void IndexNestedLoopJoinExecutor::Close() {
+  outer_->Close();
+  joined_.clear();
+  joined_cursor_ = 0;
+  inner_rows_.clear();
+}
+
+bool IndexNestedLoopJoinExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool IndexNestedLoopJoinExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (joined_cursor_ == joined_.size()) {
+      joined_.clear();
+      joined_cursor_ = 0;
+      if (!JoinOuterBatch()) {
+        break;
+      }
+      continue;
+    }
+    batch->Append(joined_[joined_cursor_++]);
+  }
+  return batch->Size() > 0;
+}
+
+bool IndexNestedLoopJoinExecutor::JoinOuterBatch() {
+  if (!outer_->NextBatch(&outer_batch_)) {
+    return false;
+  }
+  auto key_columns = plan_->GetIndex()->GetIndexKeySchema()->GetColumns();
+  std::vector<Row> outer_rows;
+  std::vector<std::vector<Field>> keys;
+  for (size_t i = 0; i < outer_batch_.SelectedCount(); i++) {
+    Row row;
+    outer_batch_.GetRow(i, &row);
+    std::vector<Field> key;
+    bool matchable = true;
+    for (size_t k = 0; k < plan_->GetOuterKeys().size() && matchable; k++) {
+      key.emplace_back(plan_->GetOuterKeys()[k]->Evaluate(&row));
+      //空值不与任何行相等，比键列还长的字符串也不可能相等
+      matchable = !key.back().IsNull() && (key.back().GetTypeId() != TypeId::kTypeChar ||
+                                           key.back().GetLength() <= key_columns[k]->GetLength());
+    }
+    if (matchable) {
+      outer_rows.push_back(std::move(row));
+      keys.push_back(std::move(key));
+    }
+  }
+  //按键排序后依次查找，相邻的查找落在相同或相邻的叶子上
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto less = [&keys](size_t a, size_t b) {
+    for (size_t k = 0; k < keys[a].size(); k++) {
+      if (keys[a][k].CompareLessThan(keys[b][k]) == CmpBool::kTrue) {
+        return true;
+      }
+      if (keys[a][k].CompareGreaterThan(keys[b][k]) == CmpBool::kTrue) {
+        return false;
+      }
+    }
+    return false;
+  };
+  std::stable_sort(order.begin(), order.end(), less);
+  auto predicate = plan_->GetPredicate();
+  for (size_t n = 0; n < order.size(); n++) {
+    size_t i = order[n];
+    //与上一个键相同时沿用上次找到的行
+    if (n == 0 || less(order[n - 1], i)) {
+      Lookup(keys[i]);
+    }
+    for (const auto &inner : inner_rows_) {
+      if (predicate != nullptr &&
+          predicate->EvaluateJoin(&outer_rows[i], &inner).CompareEquals(Field(kTypeInt, 1)) != CmpBool::kTrue) {
+        continue;
+      }
+      std::vector<Field> fields;
+      fields.reserve(plan_->GetOutputExprs().size());
+      for (const auto &expr : plan_->GetOutputExprs()) {
+        fields.emplace_back(expr->EvaluateJoin(&outer_rows[i], &inner));
+      }
+      joined_.emplace_back(fields);
+    }
+  }
+  return true;
+}
+
+void IndexNestedLoopJoinExecutor::Lookup(const std::vector<Field> &keys) {
+  inner_rows_.clear();
+  rids_.clear();
+  auto index = plan_->GetIndex();
+  auto txn = exec_ctx_->GetTransaction();
+  if (keys.size() < index->GetIndexKeySchema()->GetColumnCount()) {
+    //只给出键的前几列，只有 B+ 树能按前缀查找
+    reinterpret_cast<BPlusTreeIndex *>(index->GetIndex())->ScanPrefix(keys, rids_, txn);
+  } else {
+    std::vector<Field> key_fields(keys.begin(), keys.end());
+    index->GetIndex()->ScanKey(Row(key_fields), rids_, txn, "=");
+  }
+  for (auto rid : rids_) {
+    Row inner(rid);
+    if (table_info_->GetTableHeap()->GetTuple(&inner, txn) && inner_predicate_.Evaluate(inner)) {
+      inner_rows_.push_back(std::move(inner));
+    }
+  }
+}
@@ -1,5 +1,6 @@
 #include "executor/executors/index_scan_executor.h"
-#include <algorithm>
+#include <map>
+#include "index/b_plus_tree_index.h"
 #include "planner/expressions/constant_value_expression.h"
 
 /**
@@ -9,88 +10,106 @@ IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPl
     : AbstractExecutor(exec_ctx), plan_(plan) {
 
 }
-bool CompareRowId(RowId &a, RowId &b){
-  if(a.GetPageId() < b.GetPageId() || (a.GetPageId() == b.GetPageId() && a.GetSlotNum() < b.GetSlotNum())) return true;
-  else return false;
-}
 void IndexScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(),info);
-  FindPredicates(plan_->GetPredicate());
-  while(!expressions.empty()){
-    //获取当前要检查的表达式
-    auto operator_value = reinterpret_cast<ComparisonExpression *>(expressions.top().get())->GetComparisonType();
-    auto column =  expressions.top().get()->GetChildAt(0);
-    auto const_num =  expressions.top().get()->GetChildAt(1);
-    uint32_t col_id =  dynamic_cast<ColumnValueExpression *>(column.get())->GetColIdx();
-    //查找对应的索引
-    for(auto index: plan_->indexes_){
-      vector<RowId> new_result;
-      if(index->GetIndexKeySchema()->GetColumn(0)->GetTableInd() == col_id){
-        auto &num_value = reinterpret_cast<ConstantValueExpression *>(const_num.get())->val_;
-        Row *key = new Row(*new vector<Field>(1, num_value));
-        index->GetIndex()->ScanKey(*key, new_result, nullptr, operator_value);
-        int i;
-        if(result.empty()){
-          result.assign(new_result.begin(), new_result.end());
-        }
-        else{
-          sort(new_result.begin(), new_result.end(),CompareRowId);
-          sort(result.begin(), result.end(),CompareRowId);
-          result.resize(min(result.size(), new_result.size()));
-          auto it = set_intersection(result.begin(),result.end(),new_result.begin(),new_result.end(), result.begin(), CompareRowId);
-          result.resize(it - result.begin());
-        }
+  result.clear();
+  key_rows.clear();
+  if(plan_->index_only_ || plan_->key_order_){
+    //行按索引键的顺序输出
+    ScanIndex(plan_->indexes_[0], plan_->key_predicates_[0], result);
+  }
+  else{
+    //同一组索引找到的行求并，各组之间求交，最后按页号顺序读堆表
+    std::map<uint32_t, RowIdBitmap> groups;
+    for(size_t i = 0; i < plan_->indexes_.size(); i++){
+      vector<RowId> rids;
+      ScanIndex(plan_->indexes_[i], plan_->key_predicates_[i], rids);
+      auto &group = groups[plan_->probe_groups_.empty() ? i : plan_->probe_groups_[i]];
+      for(const auto &rid: rids){
+        group.Add(rid);
+      }
+    }
+    if(!groups.empty()){
+      auto matched = groups.begin();
+      for(auto it = std::next(matched); it != groups.end() && !matched->second.Empty(); ++it){
+        matched->second.IntersectWith(it->second);
       }
+      matched->second.AppendTo(&result);
     }
-    expressions.pop();
   }
   result_i =0;
+  schema_index.clear();
+  for (auto output_column : plan_->OutputSchema()->GetColumns()) {
+    uint32_t column_index;
+    if (info->GetSchema()->GetColumnIndex(output_column->GetName(), column_index) == DB_SUCCESS) {
+      schema_index.push_back(column_index);
+    }
+  }
+  compiled_predicate = CompiledPredicate(plan_->need_filter_ ? plan_->GetPredicate() : nullptr);
+  ResetBatchAdapter();
+}
+
+void IndexScanExecutor::ScanIndex(IndexInfo *index, const vector<AbstractExpressionRef> &predicates,
+                                  vector<RowId> &rids) {
+  //等值条件组成键前缀，范围条件约束紧随其后的一列
+  vector<Field> key_prefix;
+  const Field *lower = nullptr, *upper = nullptr;
+  bool lower_inclusive = true, upper_inclusive = true;
+  for(const auto &predicate: predicates){
+    auto operator_value = reinterpret_cast<ComparisonExpression *>(predicate.get())->GetComparisonType();
+    auto &num_value = reinterpret_cast<ConstantValueExpression *>(predicate->GetChildAt(1).get())->val_;
+    if(operator_value == "="){
+      key_prefix.emplace_back(num_value);
+    }
+    else if(operator_value == ">" || operator_value == ">="){
+      lower = &num_value;
+      lower_inclusive = (operator_value == ">=");
+    }
+    else{
+      upper = &num_value;
+      upper_inclusive = (operator_value == "<=");
+    }
+  }
+  //哈希索引和 ART 索引只用于整个键上的等值查询
+  if(index->GetIndexType() != "bptree"){
+    Row key(key_prefix);
+    index->GetIndex()->ScanKey(key, rids, nullptr, "=");
+    return;
+  }
+  auto tree_index = reinterpret_cast<BPlusTreeIndex *>(index->GetIndex());
+  tree_index->ScanPrefix(key_prefix, rids, nullptr, lower, lower_inclusive, upper, upper_inclusive,
+                         plan_->index_only_ ? &key_rows : nullptr);
 }
 
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
-  Row *new_row = nullptr;
-  int flag;
-  while(result_i < result.size()) {
-    flag = 0;
+  return NextFromBatch(row, rid);
+}
+
+bool IndexScanExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(info->GetSchema(), schema_index);
+  while(!batch->IsFull() && result_i < result.size()) {
     RowId row_id = result[result_i];
-    new_row = new Row(row_id);
-    if (!info->GetTableHeap()->GetTuple(new_row, nullptr)) {
-      return false;
+    Row new_row(row_id);
+    if (plan_->index_only_) {
+      //覆盖索引：直接用索引键拼出整行，未被索引的列留空
+      for (auto column : info->GetSchema()->GetColumns()) {
+        new_row.GetFields().push_back(new Field(column->GetType()));
+      }
+      auto key_columns = plan_->indexes_[0]->GetIndexKeySchema()->GetColumns();
+      for (uint32_t i = 0; i < key_columns.size(); i++) {
+        Field *&field = new_row.GetFields()[key_columns[i]->GetTableInd()];
+        delete field;
+        field = new Field(*key_rows[result_i].GetField(i));
+      }
+    }
+    else if (!info->GetTableHeap()->GetTuple(&new_row, nullptr)) {
+      result_i = result.size();
+      break;
     }
     result_i++;
-    if (plan_->need_filter_) {
-      if (plan_->GetPredicate()->Evaluate(new_row).CompareEquals(Field(kTypeInt, 1))) {
-        flag=1;
-        break;
-      }
-    } else{flag=1;
-      break;}
-  }
-  if(flag == 1){}
-  else return false;
-
-  vector<Field> fields;
-  for (auto output_column : plan_->OutputSchema()->GetColumns()) {
-    for (auto column : info->GetSchema()->GetColumns()) {
-      if (output_column->GetName() == column->GetName()) fields.push_back(*new_row->GetField(column->GetTableInd()));
+    if (compiled_predicate.Evaluate(new_row)) {
+      batch->Append(new_row);
     }
   }
-  *row = Row(fields);
-  *rid = RowId(new_row->GetRowId());
-  delete new_row;
-  return true;
+  return batch->Size() > 0;
 }
-void IndexScanExecutor::FindPredicates(AbstractExpressionRef predicate){
-  if(predicate->GetType()==  ExpressionType::ComparisonExpression){
-    expressions.push(predicate);
-    return ;
-  }
-  else if(predicate->GetType() ==  ExpressionType::LogicExpression){
-    auto children= predicate->GetChildren();
-    for(auto child :children){
-      FindPredicates(child);
-    }
-    return ;
-  }
-  else return;
-}
\ No newline at end of file
@@ -10,6 +10,8 @@ InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *p
 
 void InsertExecutor::Init() {
   flag=0;
+  //插入的是子节点批中的整行
+  child_executor_->RequireFullRows();
   child_executor_->Init();
   string table_name = plan_->GetTableName();
   exec_ctx_->GetCatalog()->GetTableIndexes(table_name,indexes);
@@ -25,8 +27,12 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   RowId rowid_to_ins;
   vector<Field> values_;
   values_.clear();
-  while(child_executor_->Next(&row_to_ins, &rowid_to_ins)){
-    table_info->GetTableHeap()->InsertTuple(row_to_ins, nullptr);
+  RowBatch batch;
+  //按批从子节点取行
+  while(child_executor_->NextBatch(&batch)){
+    for(size_t row_i = 0; row_i < batch.SelectedCount(); row_i++){
+      batch.GetFullRow(row_i, &row_to_ins);
+      table_info->GetTableHeap()->InsertTuple(row_to_ins, nullptr);
 //    for(auto index:indexes){
 //      for(int i = 0;i < index->GetIndexKeySchema()->GetColumnCount();i++){
 //        for(int j = 0;j < table_info->GetSchema()->GetColumnCount();j++){
@@ -37,24 +43,34 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
 //      }
 //      index->GetIndex()->InsertEntry(Row(values_),rowid_to_ins, nullptr);
 //    }
-    for(auto index:indexes){
-            vector<Field> key_inf;
-            for (auto col:index->GetIndexKeySchema()->GetColumns()){
-              uint32_t col_index;
-              table_info->GetSchema()->GetColumnIndex(col->GetName(),col_index);
-              key_inf.push_back(*(row_to_ins.GetField(col_index)));
+      for(auto index:indexes){
+              vector<Field> key_inf;
+              for (auto col:index->GetIndexKeySchema()->GetColumns()){
+                uint32_t col_index;
+                table_info->GetSchema()->GetColumnIndex(col->GetName(),col_index);
+                key_inf.push_back(*(row_to_ins.GetField(col_index)));
+              }
+              Row key_row(key_inf);
+              key_row.SetRowId(row_to_ins.GetRowId());
+              rowid_to_ins = row_to_ins.GetRowId();
+              auto status=index->GetIndex()->InsertEntry(key_row,rowid_to_ins, nullptr);
+              if (status != DB_SUCCESS) {
+                //撤销已经写入其他索引的条目
+                for(auto inserted:indexes){
+                  if(inserted == index) break;
+                  vector<Field> inserted_key;
+                  for (auto col:inserted->GetIndexKeySchema()->GetColumns()){
+                    inserted_key.push_back(*(row_to_ins.GetField(col->GetTableInd())));
+                  }
+                  inserted->GetIndex()->RemoveEntry(Row(inserted_key),rowid_to_ins, nullptr);
+                }
+                table_info->GetTableHeap()->MarkDelete(row_to_ins.GetRowId(), nullptr);
+                LOG(ERROR) << "Duplicate primary key or unique column.";
+                return false;
+              }
             }
-            Row key_row(key_inf);
-            key_row.SetRowId(row_to_ins.GetRowId());
-            rowid_to_ins = row_to_ins.GetRowId();
-            auto status=index->GetIndex()->InsertEntry(key_row,rowid_to_ins, nullptr);
-            if (status != DB_SUCCESS) {
-              table_info->GetTableHeap()->MarkDelete(row_to_ins.GetRowId(), nullptr);
-              LOG(ERROR) << "Duplicate primary key or unique column.";
-              return false;
-            }
-          }
-    count++;
+      count++;
+    }
   }
   std::vector<Field> values;
   values.clear();
@@ -0,0 +1,52 @@
+#include "executor/executors/limit_executor.h"
+
+#include <algorithm>
+
+LimitExecutor::LimitExecutor(ExecuteContext *exec_ctx, const LimitPlanNode *plan,
+                             std::unique_ptr<AbstractExecutor> child)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)) {}
+
+void LimitExecutor::Init() {
+  ResetBatchAdapter();
+  pulled_ = 0;
+  size_t offset = plan_->GetOffset();
+  size_t limit = plan_->GetLimit();
+  //offset 加 limit 超出 size_t 时不设上限；一行都不要时子节点也不必初始化
+  if (limit == 0) {
+    wanted_ = 0;
+    return;
+  }
+  wanted_ = limit > LimitPlanNode::kNoLimit - offset ? LimitPlanNode::kNoLimit : offset + limit;
+  child_->Init();
+}
+
+bool LimitExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool LimitExecutor::NextBatch(RowBatch *batch) {
+  size_t offset = plan_->GetOffset();
+  while (pulled_ < wanted_) {
+    //只向子节点要还需要的行数，扫描不会多读
+    size_t capacity = batch->GetCapacity();
+    batch->SetCapacity(std::min(capacity, wanted_ - pulled_));
+    bool produced = child_->NextBatch(batch);
+    batch->SetCapacity(capacity);
+    if (!produced) {
+      return false;
+    }
+    auto &selection = batch->GetSelection();
+    size_t first = pulled_ < offset ? std::min(offset - pulled_, selection.size()) : 0;
+    size_t last = std::min(selection.size(), wanted_ - pulled_);
+    pulled_ += last;
+    selection.erase(selection.begin() + last, selection.end());
+    selection.erase(selection.begin(), selection.begin() + first);
+    if (pulled_ == wanted_) {
+      child_->Close();
+    }
+    if (!selection.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,128 @@
+#include "executor/executors/parallel_seq_scan_executor.h"
+
+#include <algorithm>
+#include <atomic>
+
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan,
+                                                 size_t worker_count)
+    : AbstractExecutor(exec_ctx), plan_(plan), max_workers_(worker_count) {
+  if (max_workers_ == 0) {
+    max_workers_ = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, SCAN_MAX_WORKERS);
+  }
+}
+
+ParallelSeqScanExecutor::~ParallelSeqScanExecutor() { Stop(); }
+
+void ParallelSeqScanExecutor::Init() {
+  Stop();
+  ResetBatchAdapter();
+  TableInfo *table_info = nullptr;
+  exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info);
+  pages_.clear();
+  table_info->GetTableHeap()->GetPageIds(&pages_);
+  morsel_count_ = (pages_.size() + SCAN_MORSEL_PAGES - 1) / SCAN_MORSEL_PAGES;
+  size_t worker_count = std::max<size_t>(1, std::min(max_workers_, morsel_count_));
+  for (size_t i = 0; i < worker_count; i++) {
+    scans_.push_back(std::make_unique<SeqScanExecutor>(exec_ctx_, plan_));
+    if (full_rows_) {
+      scans_.back()->RequireFullRows();
+    }
+    scans_.back()->Init();
+  }
+  started_ = false;
+}
+
+void ParallelSeqScanExecutor::Start() {
+  started_ = true;
+  //只有一段时直接在当前线程扫描，不必起线程
+  if (scans_.size() == 1) {
+    return;
+  }
+  //每个线程最多领先消费者两段
+  exchange_ = std::make_unique<Exchange>(morsel_count_, 2 * scans_.size());
+  for (auto &scan : scans_) {
+    workers_.emplace_back(&ParallelSeqScanExecutor::Work, this, scan.get());
+  }
+}
+
+void ParallelSeqScanExecutor::Work(SeqScanExecutor *scan) {
+  size_t morsel;
+  while (exchange_->TakeMorsel(&morsel)) {
+    ScanMorsel(scan, morsel);
+    RowBatch batch;
+    bool open = true;
+    while (open && scan->NextBatch(&batch)) {
+      open = exchange_->Push(morsel, std::move(batch));
+      batch = RowBatch();
+    }
+    exchange_->Finish(morsel);
+  }
+  //放掉最后一段的页
+  scan->ScanPages(INVALID_PAGE_ID, INVALID_PAGE_ID);
+}
+
+void ParallelSeqScanExecutor::ScanMorsel(SeqScanExecutor *scan, size_t morsel) {
+  size_t end = (morsel + 1) * SCAN_MORSEL_PAGES;
+  scan->ScanPages(pages_[morsel * SCAN_MORSEL_PAGES], end < pages_.size() ? pages_[end] : INVALID_PAGE_ID);
+}
+
+void ParallelSeqScanExecutor::ScanInto(const std::function<void(size_t worker, RowBatch *batch)> &consume) {
+  started_ = true;
+  if (scans_.size() == 1) {
+    RowBatch batch;
+    while (scans_[0]->NextBatch(&batch)) {
+      consume(0, &batch);
+    }
+    return;
+  }
+  //不必按页序交付，各线程领到下一段就扫描，批直接交给 consume
+  std::atomic<size_t> next_morsel{0};
+  for (size_t i = 0; i < scans_.size(); i++) {
+    workers_.emplace_back([this, &consume, &next_morsel, i] {
+      RowBatch batch;
+      for (size_t morsel = next_morsel++; morsel < morsel_count_; morsel = next_morsel++) {
+        ScanMorsel(scans_[i].get(), morsel);
+        while (scans_[i]->NextBatch(&batch)) {
+          consume(i, &batch);
+        }
+      }
+      scans_[i]->ScanPages(INVALID_PAGE_ID, INVALID_PAGE_ID);
+    });
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void ParallelSeqScanExecutor::Stop() {
+  if (exchange_ != nullptr) {
+    exchange_->Close();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  exchange_.reset();
+  scans_.clear();
+}
+
+void ParallelSeqScanExecutor::Close() {
+  Stop();
+  //不再启动线程
+  started_ = true;
+}
+
+bool ParallelSeqScanExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool ParallelSeqScanExecutor::NextBatch(RowBatch *batch) {
+  if (!started_) {
+    Start();
+  }
+  if (exchange_ == nullptr) {
+    return !scans_.empty() && scans_[0]->NextBatch(batch);
+  }
+  return exchange_->Pop(batch);
+}
@@ -0,0 +1,149 @@
+#include "executor/row_batch.h"
+
+void ColumnVector::Clear() {
+  size_ = 0;
+  ints_.clear();
+  floats_.clear();
+  chars_.clear();
+  offsets_.resize(1);
+  nulls_.clear();
+}
+
+void ColumnVector::Append(const Field &field) {
+  ASSERT(field.GetTypeId() == type_, "Field type does not match the column.");
+  if (field.IsNull()) {
+    AppendNull();
+    return;
+  }
+  switch (type_) {
+    case TypeId::kTypeInt: {
+      int32_t value;
+      field.SerializeTo(reinterpret_cast<char *>(&value));
+      AppendInt(value);
+      break;
+    }
+    case TypeId::kTypeFloat: {
+      float value;
+      field.SerializeTo(reinterpret_cast<char *>(&value));
+      AppendFloat(value);
+      break;
+    }
+    case TypeId::kTypeChar:
+      AppendChars(field.GetData(), field.GetLength());
+      break;
+    default:
+      ASSERT(false, "Unsupported column type.");
+  }
+}
+
+Field *ColumnVector::NewField(size_t i) const {
+  if (IsNull(i)) {
+    return new Field(type_);
+  }
+  switch (type_) {
+    case TypeId::kTypeInt:
+      return new Field(type_, ints_[i]);
+    case TypeId::kTypeFloat:
+      return new Field(type_, floats_[i]);
+    default: {
+      // an empty string still needs a non-null pointer, or the field reads as null
+      uint32_t length = GetCharLength(i);
+      return new Field(type_, const_cast<char *>(length == 0 ? "" : GetChars(i)), length, true);
+    }
+  }
+}
+
+void RowBatch::Reset(const Schema *schema, const std::vector<uint32_t> &projection) {
+  if (schema != nullptr && typed_ && columns_.size() == schema->GetColumnCount()) {
+    bool same_layout = true;
+    for (uint32_t i = 0; i < columns_.size() && same_layout; i++) {
+      same_layout = (columns_[i].GetType() == schema->GetColumn(i)->GetType());
+    }
+    // the same columns as before, keep their memory
+    if (same_layout) {
+      Clear();
+      projection_ = projection.empty() ? all_columns_ : projection;
+      return;
+    }
+  }
+  columns_.clear();
+  all_columns_.clear();
+  row_ids_.clear();
+  selection_.clear();
+  typed_ = (schema != nullptr);
+  if (!typed_) {
+    return;
+  }
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    columns_.emplace_back(schema->GetColumn(i)->GetType());
+    all_columns_.push_back(i);
+  }
+  projection_ = projection.empty() ? all_columns_ : projection;
+}
+
+void RowBatch::Clear() {
+  for (auto &column : columns_) {
+    column.Clear();
+  }
+  row_ids_.clear();
+  selection_.clear();
+}
+
+void RowBatch::Append(const Row &row) {
+  if (!typed_) {
+    // rows of an executor without a schema, e.g. values, take the types of the first row
+    for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+      columns_.emplace_back(row.GetField(i)->GetTypeId());
+      all_columns_.push_back(i);
+    }
+    projection_ = all_columns_;
+    typed_ = true;
+  }
+  ASSERT(row.GetFieldCount() == columns_.size(), "Row does not match the batch layout.");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(*row.GetField(i));
+  }
+  selection_.push_back(row_ids_.size());
+  row_ids_.push_back(row.GetRowId());
+}
+
+void RowBatch::AppendTuple(const TupleView &tuple, RowId rid, const std::vector<uint32_t> &columns) {
+  for (auto i : columns) {
+    auto &column = columns_[i];
+    if (tuple.IsNull(i)) {
+      column.AppendNull();
+      continue;
+    }
+    switch (column.GetType()) {
+      case TypeId::kTypeInt:
+        column.AppendInt(tuple.GetInt(i));
+        break;
+      case TypeId::kTypeFloat:
+        column.AppendFloat(tuple.GetFloat(i));
+        break;
+      default:
+        column.AppendChars(tuple.GetChars(i), tuple.GetCharLength(i));
+    }
+  }
+  selection_.push_back(row_ids_.size());
+  row_ids_.push_back(rid);
+}
+
+void RowBatch::GetRow(size_t i, Row *row) const {
+  Materialize(selection_[i], projection_, row);
+}
+
+void RowBatch::GetFullRow(size_t i, Row *row) const {
+  Materialize(selection_[i], all_columns_, row);
+}
+
+void RowBatch::Materialize(uint32_t position, const std::vector<uint32_t> &columns, Row *row) const {
+  row->destroy();
+  auto &fields = row->GetFields();
+  fields.reserve(columns.size());
+  for (auto column : columns) {
+    ASSERT(position < columns_[column].Size(), "Column was not decoded into the batch.");
+    fields.push_back(columns_[column].NewField(position));
+  }
+  row->SetRowId(row_ids_[position]);
+}
@@ -0,0 +1,179 @@
+#include "executor/rowid_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/macros.h"
+
+bool RowIdBitmap::Container::Contains(uint32_t slot) const {
+  if (dense) {
+    return slot / 64 < words.size() && (words[slot / 64] >> (slot % 64) & 1);
+  }
+  return std::binary_search(slots.begin(), slots.end(), slot);
+}
+
+void RowIdBitmap::Container::Add(uint32_t slot) {
+  ASSERT(slot <= UINT16_MAX, "Slot number out of range.");
+  if (dense) {
+    if (slot / 64 >= words.size()) {
+      words.resize(slot / 64 + 1, 0);
+    }
+    uint64_t bit = uint64_t(1) << (slot % 64);
+    count += (words[slot / 64] & bit) == 0;
+    words[slot / 64] |= bit;
+    return;
+  }
+  auto it = std::lower_bound(slots.begin(), slots.end(), slot);
+  if (it == slots.end() || *it != slot) {
+    slots.insert(it, static_cast<uint16_t>(slot));
+    count++;
+    Normalize();
+  }
+}
+
+void RowIdBitmap::Container::Normalize() {
+  if (!dense && count > kSparseLimit) {
+    ToDense();
+  } else if (dense && count <= kSparseLimit) {
+    slots.clear();
+    for (size_t w = 0; w < words.size(); w++) {
+      for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+        slots.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+    words.clear();
+    dense = false;
+  }
+}
+
+void RowIdBitmap::Container::ToDense() {
+  words.assign(slots.empty() ? 0 : slots.back() / 64 + 1, 0);
+  for (auto slot : slots) {
+    words[slot / 64] |= uint64_t(1) << (slot % 64);
+  }
+  slots.clear();
+  dense = true;
+}
+
+void RowIdBitmap::Container::Intersect(const Container &other) {
+  if (dense && other.dense) {
+    //逐字求与，超出较短一方的字都为 0
+    words.resize(std::min(words.size(), other.words.size()));
+    count = 0;
+    for (size_t w = 0; w < words.size(); w++) {
+      words[w] &= other.words[w];
+      count += __builtin_popcountll(words[w]);
+    }
+  } else if (dense) {
+    //结果不会多于稀疏一方，直接取它的槽号
+    std::vector<uint16_t> kept;
+    std::copy_if(other.slots.begin(), other.slots.end(), std::back_inserter(kept),
+                 [this](uint16_t slot) { return Contains(slot); });
+    slots.swap(kept);
+    words.clear();
+    count = slots.size();
+    dense = false;
+  } else {
+    auto end = std::remove_if(slots.begin(), slots.end(), [&other](uint16_t slot) { return !other.Contains(slot); });
+    slots.erase(end, slots.end());
+    count = slots.size();
+  }
+  Normalize();
+}
+
+void RowIdBitmap::Container::Union(const Container &other) {
+  if (!dense && !other.dense) {
+    std::vector<uint16_t> merged;
+    merged.reserve(slots.size() + other.slots.size());
+    std::set_union(slots.begin(), slots.end(), other.slots.begin(), other.slots.end(), std::back_inserter(merged));
+    slots.swap(merged);
+    count = slots.size();
+    Normalize();
+    return;
+  }
+  if (!dense) {
+    //先转成位图再合并
+    ToDense();
+  }
+  if (other.dense) {
+    if (other.words.size() > words.size()) {
+      words.resize(other.words.size(), 0);
+    }
+    for (size_t w = 0; w < other.words.size(); w++) {
+      words[w] |= other.words[w];
+    }
+  } else if (!other.slots.empty()) {
+    if (other.slots.back() / 64 >= words.size()) {
+      words.resize(other.slots.back() / 64 + 1, 0);
+    }
+    for (auto slot : other.slots) {
+      words[slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+  }
+  count = 0;
+  for (auto word : words) {
+    count += __builtin_popcountll(word);
+  }
+}
+
+void RowIdBitmap::Add(const RowId &rid) {
+  auto &container = pages_[rid.GetPageId()];
+  size_t before = container.count;
+  container.Add(rid.GetSlotNum());
+  size_ += container.count - before;
+}
+
+bool RowIdBitmap::Contains(const RowId &rid) const {
+  auto it = pages_.find(rid.GetPageId());
+  return it != pages_.end() && it->second.Contains(rid.GetSlotNum());
+}
+
+void RowIdBitmap::IntersectWith(const RowIdBitmap &other) {
+  //两边的页号都有序，同时向前走
+  size_ = 0;
+  auto it = pages_.begin();
+  auto other_it = other.pages_.begin();
+  while (it != pages_.end()) {
+    while (other_it != other.pages_.end() && other_it->first < it->first) {
+      ++other_it;
+    }
+    if (other_it == other.pages_.end() || other_it->first != it->first) {
+      it = pages_.erase(it);
+      continue;
+    }
+    it->second.Intersect(other_it->second);
+    if (it->second.count == 0) {
+      it = pages_.erase(it);
+      continue;
+    }
+    size_ += it->second.count;
+    ++it;
+  }
+}
+
+void RowIdBitmap::UnionWith(const RowIdBitmap &other) {
+  for (const auto &page : other.pages_) {
+    auto &container = pages_[page.first];
+    size_ -= container.count;
+    container.Union(page.second);
+    size_ += container.count;
+  }
+}
+
+void RowIdBitmap::AppendTo(std::vector<RowId> *rids) const {
+  rids->reserve(rids->size() + size_);
+  for (const auto &page : pages_) {
+    const auto &container = page.second;
+    if (!container.dense) {
+      for (auto slot : container.slots) {
+        rids->emplace_back(page.first, slot);
+      }
+      continue;
+    }
+    for (size_t w = 0; w < container.words.size(); w++) {
+      for (uint64_t word = container.words[w]; word != 0; word &= word - 1) {
+        rids->emplace_back(page.first, static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+  }
+}
@@ -5,7 +5,7 @@
 
 SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
-      plan_(plan),ite(RowId(INVALID_PAGE_ID,0), nullptr),end(RowId(INVALID_PAGE_ID,0), nullptr){
+      plan_(plan){
 }
 
 void SeqScanExecutor::Init() {
@@ -29,9 +29,10 @@ void SeqScanExecutor::Init() {
   //    LOG(WARNING)<<out_schema->GetColumn(i)->GetName()<<std::endl;
   //  }
   exec_ctx_->GetCatalog()->GetTable(table_name,table_info);
-  ite = table_info->GetTableHeap()->Begin(nullptr);
-  end = table_info->GetTableHeap()->End();
-  values.reserve(out_schema->GetColumnCount());
+  compiled_predicate = CompiledPredicate(plan_->GetPredicate());
+  ResetBatchAdapter();
+  scanner = std::make_unique<TableScanner>(table_info->GetTableHeap());
+  tuple = std::make_unique<TupleView>(table_info->GetSchema());
   int count1=table_info->GetSchema()->GetColumnCount();
   int count2=out_schema->GetColumnCount();
   int i,j;
@@ -43,39 +44,58 @@ void SeqScanExecutor::Init() {
       }
     }
   }
+  //只解码输出的列；谓词没编译成功时要在整行上求值，也解码所有列
+  decode_columns.clear();
+  if(full_rows || !compiled_predicate.IsCompiled()){
+    for(uint32_t k=0;k<table_info->GetSchema()->GetColumnCount();k++){
+      decode_columns.push_back(k);
+    }
+  }
+  else{
+    decode_columns = schema_index;
+  }
+  locate_limit = 0;
+  for(auto column: decode_columns){
+    locate_limit = std::max(locate_limit, column+1);
+  }
+  for(auto column: compiled_predicate.GetColumns()){
+    locate_limit = std::max(locate_limit, column+1);
+  }
+}
+
+void SeqScanExecutor::ScanPages(page_id_t first_page_id, page_id_t end_page_id) {
+  //先释放上一段的页
+  scanner.reset();
+  scanner = std::make_unique<TableScanner>(table_info->GetTableHeap(), first_page_id, end_page_id);
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
-  //LOG(WARNING)<<ite->GetRowId().GetPageId()<<" "<<ite->GetRowId().GetSlotNum()<<std::endl;
-  while(1){
-    if(ite == end){
-      return false;
-    }
-    (*rid) = RowId(ite->GetRowId());
-    row->SetRowId(*rid);
-    table_info->GetTableHeap()->GetTuple(row, nullptr);
-    if(plan_->GetPredicate() != nullptr){
-      if(plan_->GetPredicate()->Evaluate(row).CompareEquals(Field(kTypeInt,1))){
-        ite++;
-        int i;
-        vector<Field> field;
-        field.clear();
-        for(i=0;i<out_schema->GetColumnCount();i++){
-          field.push_back(*(row->GetField(schema_index[i])));
-        }
-        (*row) = Row(field);
-        //row = new Row(field);
-        //(*row) = Row(*(ite));
-        row->SetRowId(*rid);
-        return true;
+  return NextFromBatch(row, rid);
+}
+
+bool SeqScanExecutor::NextBatch(RowBatch *batch) {
+  //批按整张表的列建立，只有 decode_columns 中的列有值
+  batch->Reset(table_info->GetSchema(), schema_index);
+  if(!compiled_predicate.IsCompiled()){
+    //整批解码后在整行上过滤，一整批都不满足时继续读下一批
+    while(true){
+      while(!batch->IsFull() && scanner->Next()){
+        tuple->Reset(scanner->GetTupleData(), locate_limit);
+        batch->AppendTuple(*tuple, scanner->GetRowId(), decode_columns);
       }
-      else{
-        ite++;
+      compiled_predicate.Filter(batch);
+      if(batch->SelectedCount() > 0 || !batch->IsFull()){
+        return batch->SelectedCount() > 0;
       }
+      batch->Clear();
     }
-    else{
-      ite++;
-      return true;
+  }
+  while(!batch->IsFull() && scanner->Next()){
+    //直接在页内的序列化数据上过滤，不满足谓词的行不构造任何 Field
+    tuple->Reset(scanner->GetTupleData(), locate_limit);
+    if(compiled_predicate.Evaluate(*tuple)){
+      batch->AppendTuple(*tuple, scanner->GetRowId(), decode_columns);
     }
   }
-}
\ No newline at end of file
+  return batch->Size() > 0;
+}
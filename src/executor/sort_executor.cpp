@@ -0,0 +1,225 @@
+#include "executor/executors/sort_executor.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "planner/expressions/column_value_expression.h"
+
+SortExecutor::SortExecutor(ExecuteContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> child,
+                           size_t memory_budget)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)), memory_budget_(memory_budget) {}
+
+void SortExecutor::Init() {
+  ResetBatchAdapter();
+  key_columns_.clear();
+  descending_.clear();
+  for (const auto &order_by : plan_->GetOrderBys()) {
+    key_columns_.push_back(dynamic_pointer_cast<ColumnValueExpression>(order_by.second)->GetColIdx());
+    descending_.push_back(order_by.first == OrderByType::Desc);
+  }
+  rows_.clear();
+  order_.clear();
+  bytes_ = 0;
+  runs_.clear();
+  heads_.clear();
+  merge_heap_.clear();
+  cursor_ = 0;
+  emitted_ = 0;
+  child_->Init();
+  size_t limit = plan_->GetLimit();
+  top_n_ = limit != SortPlanNode::kNoLimit;
+  //堆顶是留下的行中最靠后的一行
+  auto heap_less = [this](size_t a, size_t b) { return Less(rows_[a], rows_[b]); };
+  auto schema = const_cast<Schema *>(child_->GetOutputSchema());
+  RowBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.SelectedCount(); i++) {
+      Row row;
+      batch.GetRow(i, &row);
+      if (!top_n_) {
+        bytes_ += row.GetSerializedSize(schema);
+        rows_.push_back(std::move(row));
+        if (bytes_ > memory_budget_) {
+          SpillRun();
+        }
+        continue;
+      }
+      if (order_.size() < limit) {
+        bytes_ += row.GetSerializedSize(schema);
+        rows_.push_back(std::move(row));
+        order_.push_back(rows_.size() - 1);
+        std::push_heap(order_.begin(), order_.end(), heap_less);
+      } else if (limit > 0 && Less(row, rows_[order_.front()])) {
+        //新行排在堆顶之前，替换掉堆顶
+        std::pop_heap(order_.begin(), order_.end(), heap_less);
+        Row &last = rows_[order_.back()];
+        bytes_ = bytes_ - last.GetSerializedSize(schema) + row.GetSerializedSize(schema);
+        last = row;
+        std::push_heap(order_.begin(), order_.end(), heap_less);
+      }
+      //要留下的行太多，改用外部排序
+      if (bytes_ > memory_budget_) {
+        top_n_ = false;
+        SpillRun();
+      }
+    }
+  }
+  if (runs_.empty()) {
+    SortRows();
+    return;
+  }
+  if (!rows_.empty()) {
+    SpillRun();
+  }
+  while (runs_.size() > SORT_MERGE_WAYS) {
+    MergePass();
+  }
+  StartMerge(0, runs_.size());
+}
+
+bool SortExecutor::Less(const Row &a, const Row &b) const {
+  for (size_t k = 0; k < key_columns_.size(); k++) {
+    const Field *x = a.GetField(key_columns_[k]);
+    const Field *y = b.GetField(key_columns_[k]);
+    if (descending_[k]) {
+      std::swap(x, y);
+    }
+    //空值排在所有值之前
+    if (x->IsNull() || y->IsNull()) {
+      if (x->IsNull() != y->IsNull()) {
+        return x->IsNull();
+      }
+      continue;
+    }
+    if (x->CompareLessThan(*y) == CmpBool::kTrue) {
+      return true;
+    }
+    if (x->CompareGreaterThan(*y) == CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return false;
+}
+
+void SortExecutor::SortRows() {
+  order_.resize(rows_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+  //排序键相同的行保持读入的顺序
+  std::stable_sort(order_.begin(), order_.end(), [this](size_t a, size_t b) { return Less(rows_[a], rows_[b]); });
+}
+
+void SortExecutor::SpillRun() {
+  SortRows();
+  auto run = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), child_->GetOutputSchema());
+  //有 limit 时每段只需写出最前面的行
+  size_t count = std::min(order_.size(), plan_->GetLimit());
+  for (size_t i = 0; i < count; i++) {
+    run->Append(rows_[order_[i]]);
+  }
+  runs_.push_back(std::move(run));
+  rows_.clear();
+  order_.clear();
+  bytes_ = 0;
+}
+
+void SortExecutor::MergePass() {
+  std::vector<std::unique_ptr<SpillFile>> merged;
+  //相邻的段合并在一起，合并后的段仍按原来的先后排列
+  for (size_t first = 0; first < runs_.size(); first += SORT_MERGE_WAYS) {
+    size_t last = std::min<size_t>(first + SORT_MERGE_WAYS, runs_.size());
+    auto run = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), child_->GetOutputSchema());
+    StartMerge(first, last);
+    Row row;
+    for (size_t count = 0; count < plan_->GetLimit() && NextMerged(&row); count++) {
+      run->Append(row);
+    }
+    for (size_t i = first; i < last; i++) {
+      runs_[i].reset();
+    }
+    merged.push_back(std::move(run));
+  }
+  runs_ = std::move(merged);
+}
+
+void SortExecutor::StartMerge(size_t first, size_t last) {
+  heads_.clear();
+  heads_.resize(runs_.size());
+  merge_heap_.clear();
+  for (size_t i = first; i < last; i++) {
+    runs_[i]->Rewind();
+    if (runs_[i]->Read(&heads_[i])) {
+      merge_heap_.push_back(i);
+    }
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(), [this](size_t a, size_t b) { return HeadAfter(a, b); });
+}
+
+bool SortExecutor::HeadAfter(size_t a, size_t b) const {
+  //键相同时靠前的段先出，与在内存中排序的结果一致
+  return Less(heads_[b], heads_[a]) || (!Less(heads_[a], heads_[b]) && a > b);
+}
+
+bool SortExecutor::NextMerged(Row *row) {
+  if (merge_heap_.empty()) {
+    return false;
+  }
+  auto later = [this](size_t a, size_t b) { return HeadAfter(a, b); };
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), later);
+  size_t run = merge_heap_.back();
+  *row = heads_[run];
+  if (runs_[run]->Read(&heads_[run])) {
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(), later);
+  } else {
+    merge_heap_.pop_back();
+  }
+  return true;
+}
+
+void SortExecutor::Output(const Row &row, RowBatch *batch) const {
+  uint32_t column_count = GetOutputSchema()->GetColumnCount();
+  if (row.GetFieldCount() == column_count) {
+    batch->Append(row);
+    return;
+  }
+  //排序键读到的列不输出
+  std::vector<Field> fields;
+  fields.reserve(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    fields.emplace_back(*row.GetField(i));
+  }
+  batch->Append(Row(fields));
+}
+
+void SortExecutor::Close() {
+  child_->Close();
+  rows_.clear();
+  order_.clear();
+  cursor_ = 0;
+  //段在合并时各占着一页
+  runs_.clear();
+  heads_.clear();
+  merge_heap_.clear();
+}
+
+bool SortExecutor::Next(Row *row, RowId *rid) {
+  return NextFromBatch(row, rid);
+}
+
+bool SortExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  Row row;
+  while (!batch->IsFull() && emitted_ < plan_->GetLimit()) {
+    if (runs_.empty()) {
+      if (cursor_ == order_.size()) {
+        break;
+      }
+      Output(rows_[order_[cursor_++]], batch);
+    } else if (NextMerged(&row)) {
+      Output(row, batch);
+    } else {
+      break;
+    }
+    emitted_++;
+  }
+  return batch->Size() > 0;
+}
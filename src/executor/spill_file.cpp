@@ -0,0 +1,108 @@
+#include "executor/spill_file.h"
+
+#include <algorithm>
+
+SpillFile::SpillFile(BufferPoolManager *bpm, const Schema *schema)
+    : bpm_(bpm), schema_(const_cast<Schema *>(schema)) {}
+
+SpillFile::~SpillFile() {
+  if (pinned_ < pages_.size()) {
+    bpm_->UnpinPage(pages_[pinned_], !reading_);
+  }
+  bpm_->DeletePages(pages_);
+}
+
+void SpillFile::Append(const Row &row) {
+  ASSERT(!reading_, "Spill file is being read.");
+  uint32_t size = row.GetSerializedSize(schema_);
+  buffer_.resize(sizeof(uint32_t) + size);
+  memcpy(buffer_.data(), &size, sizeof(uint32_t));
+  row.SerializeTo(buffer_.data() + sizeof(uint32_t), schema_);
+  Write(buffer_.data(), buffer_.size());
+  row_count_++;
+  byte_size_ += size;
+}
+
+void SpillFile::AppendRecord(const char *data, size_t size) {
+  ASSERT(!reading_, "Spill file is being read.");
+  Write(data, size);
+  row_count_++;
+  byte_size_ += size;
+}
+
+bool SpillFile::ReadRecord(char *data, size_t size) {
+  ASSERT(reading_, "Spill file is not rewound.");
+  if (rows_read_ == row_count_) {
+    return false;
+  }
+  ReadBytes(data, size);
+  rows_read_++;
+  return true;
+}
+
+void SpillFile::Rewind() {
+  Pin(0, !reading_);
+  reading_ = true;
+  rows_read_ = 0;
+}
+
+bool SpillFile::Read(Row *row) {
+  ASSERT(reading_, "Spill file is not rewound.");
+  if (rows_read_ == row_count_) {
+    return false;
+  }
+  uint32_t size;
+  ReadBytes(reinterpret_cast<char *>(&size), sizeof(uint32_t));
+  buffer_.resize(size);
+  ReadBytes(buffer_.data(), size);
+  row->DeserializeFrom(buffer_.data(), schema_);
+  rows_read_++;
+  return true;
+}
+
+void SpillFile::Write(const char *data, size_t size) {
+  while (size > 0) {
+    //当前页写满后接一个新页
+    if (pinned_ == pages_.size() || offset_ == PAGE_SIZE) {
+      if (pinned_ < pages_.size()) {
+        bpm_->UnpinPage(pages_[pinned_], true);
+      }
+      page_id_t page_id;
+      Page *page = bpm_->NewPage(page_id);
+      ASSERT(page != nullptr, "No free frame to spill to.");
+      pages_.push_back(page_id);
+      pinned_ = pages_.size() - 1;
+      data_ = page->GetData();
+      offset_ = 0;
+    }
+    size_t length = std::min(size, PAGE_SIZE - offset_);
+    memcpy(data_ + offset_, data, length);
+    offset_ += length;
+    data += length;
+    size -= length;
+  }
+}
+
+void SpillFile::ReadBytes(char *data, size_t size) {
+  while (size > 0) {
+    if (offset_ == PAGE_SIZE) {
+      Pin(pinned_ + 1, false);
+    }
+    size_t length = std::min(size, PAGE_SIZE - offset_);
+    memcpy(data, data_ + offset_, length);
+    offset_ += length;
+    data += length;
+    size -= length;
+  }
+}
+
+void SpillFile::Pin(size_t index, bool dirty) {
+  if (pinned_ < pages_.size()) {
+    bpm_->UnpinPage(pages_[pinned_], dirty);
+  }
+  pinned_ = std::min(index, pages_.size());
+  offset_ = 0;
+  if (pinned_ < pages_.size()) {
+    data_ = bpm_->FetchPage(pages_[pinned_])->GetData();
+  }
+}
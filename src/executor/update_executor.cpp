@@ -4,6 +4,9 @@
 
 #include "executor/executors/update_executor.h"
 
+#include <stdexcept>
+#include <string>
+
 UpdateExecutor::UpdateExecutor(ExecuteContext *exec_ctx, const UpdatePlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
@@ -13,6 +16,11 @@ void UpdateExecutor::Init() {
   string table_name = plan_->GetTableName();
   exec_ctx_->GetCatalog()->GetTable(table_name,table_info);
   flag=0;
+  moved_ = RowIdBitmap();
+  index_info_.clear();
+  exec_ctx_->GetCatalog()->GetTableIndexes(table_name,index_info_);
+  //要用子节点批中的整行维护索引
+  child_executor_->RequireFullRows();
   child_executor_->Init();
 }
 
@@ -20,24 +28,64 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   if(flag==1){
     return false;
   }
-  std::vector<IndexInfo *> indexes;
   Row old_row;
   Row new_row;
   RowId rowid;
   vector<Field> values_;
-  exec_ctx_->GetCatalog()->GetTableIndexes(plan_->GetTableName(),indexes);
-  while(child_executor_->Next(&old_row, &rowid)){
-    old_row.SetRowId(rowid);
-    new_row = GenerateUpdatedTuple(old_row);
-    new_row.SetRowId(rowid);
-    if(!table_info->GetTableHeap()->UpdateTuple(new_row,rowid, nullptr)){
-      return false;
+  RowBatch batch;
+  while(child_executor_->NextBatch(&batch)){
+    for(size_t row_i = 0; row_i < batch.SelectedCount(); row_i++){
+      batch.GetFullRow(row_i, &old_row);
+      rowid = old_row.GetRowId();
+      if(moved_.Contains(rowid)){
+        continue;
+      }
+      new_row = GenerateUpdatedTuple(old_row);
+      new_row.SetRowId(rowid);
+      auto heap = table_info->GetTableHeap();
+      bool moved = false;
+      if(!heap->UpdateTuple(new_row,rowid, nullptr)){
+        //原页放不下变长后的元组，删去旧元组再插到别处，行号随之改变
+        if(!heap->MarkDelete(rowid, nullptr)){
+          throw std::runtime_error("failed to update the row at page " + std::to_string(rowid.GetPageId()));
+        }
+        if(!heap->InsertTuple(new_row, nullptr)){
+          heap->RollbackDelete(rowid, nullptr);
+          throw std::runtime_error("the updated row does not fit in a page");
+        }
+        moved_.Add(new_row.GetRowId());
+        moved = true;
+      }
+      RowId new_rowid = new_row.GetRowId();
+      //每一行都要把旧键换成新键
+      for(size_t i = 0; i < index_info_.size(); i++){
+        auto index = index_info_[i];
+        Row old_key, new_key;
+        old_row.GetKeyFromRow(table_info->GetSchema(), index->GetIndexKeySchema(), old_key);
+        new_row.GetKeyFromRow(table_info->GetSchema(), index->GetIndexKeySchema(), new_key);
+        index->GetIndex()->RemoveEntry(old_key,rowid, nullptr);
+        if(index->GetIndex()->InsertEntry(new_key,new_rowid, nullptr) != DB_SUCCESS){
+          //新键冲突，此前已换成新键的索引都换回旧键，再恢复旧元组
+          index->GetIndex()->InsertEntry(old_key,rowid, nullptr);
+          for(size_t j = 0; j < i; j++){
+            Row switched_old, switched_new;
+            old_row.GetKeyFromRow(table_info->GetSchema(), index_info_[j]->GetIndexKeySchema(), switched_old);
+            new_row.GetKeyFromRow(table_info->GetSchema(), index_info_[j]->GetIndexKeySchema(), switched_new);
+            index_info_[j]->GetIndex()->RemoveEntry(switched_new,new_rowid, nullptr);
+            index_info_[j]->GetIndex()->InsertEntry(switched_old,rowid, nullptr);
+          }
+          if(moved){
+            heap->ApplyDelete(new_rowid, nullptr);
+            heap->RollbackDelete(rowid, nullptr);
+          } else {
+            heap->UpdateTuple(old_row,rowid, nullptr);
+          }
+          LOG(ERROR) << "Duplicate primary key or unique column.";
+          return false;
+        }
+      }
     }
   }
-  for(auto index:indexes){
-    index->GetIndex()->RemoveEntry(old_row,rowid, nullptr);
-    index->GetIndex()->InsertEntry(new_row,rowid, nullptr);
-  }
   flag = 1;
   return true;
 }
@@ -9,18 +9,23 @@ ValuesExecutor::ValuesExecutor(ExecuteContext *exec_ctx, const ValuesPlanNode *p
 
 void ValuesExecutor::Init() {
   value_size_ = plan_->GetValues().size();
+  cursor_ = 0;
+  ResetBatchAdapter();
 }
 
 bool ValuesExecutor::Next(Row *row, RowId *rid) {
-  if (cursor_ < value_size_) {
+  return NextFromBatch(row, rid);
+}
+
+bool ValuesExecutor::NextBatch(RowBatch *batch) {
+  batch->Reset(plan_->OutputSchema());
+  while (!batch->IsFull() && cursor_ < value_size_) {
     std::vector<Field> values;
-    auto exprs = plan_->GetValues().at(cursor_);
-    for (auto expr : exprs) {
+    for (const auto &expr : plan_->GetValues().at(cursor_)) {
       values.emplace_back(expr->Evaluate(nullptr));
     }
-    *row = Row{values};
+    batch->Append(Row{values});
     cursor_++;
-    return true;
   }
-  return false;
+  return batch->Size() > 0;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <list>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "page/disk_file_meta_page.h"
@@ -28,10 +29,18 @@ class BufferPoolManager {
 
   bool DeletePage(page_id_t page_id);
 
+  /**
+   * Delete many pages at once, their bits are cleared with one bitmap write per extent.
+   * @return false if some page is still pinned, it is kept and the others are deleted anyway
+   */
+  bool DeletePages(const std::vector<page_id_t> &page_ids);
+
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
 
+  size_t GetPoolSize() const { return pool_size_; }
+
  private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
@@ -84,7 +84,7 @@ class CatalogManager {
 
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info,
-                      const string &index_type);
+                      const string &index_type, bool unique = true);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -94,6 +94,11 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Collect the statistics of a table, replacing those of its last analysis, and write them to its statistics page.
+   */
+  dberr_t AnalyzeTable(const std::string &table_name, Transaction *txn);
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
@@ -103,6 +108,8 @@ class CatalogManager {
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
 
+  dberr_t BackfillIndex(IndexInfo *index_info, TableInfo *table_info, Transaction *txn);
+
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
  private:
@@ -6,7 +6,9 @@
 #include "catalog/table.h"
 #include "common/macros.h"
 #include "common/rowid.h"
+#include "index/art_index.h"
 #include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
 #include "index/generic_key.h"
 #include "record/schema.h"
 
@@ -15,7 +17,8 @@ class IndexMetadata {
 
  public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                               const std::vector<uint32_t> &key_map);
+                               const std::vector<uint32_t> &key_map, bool unique = true,
+                               const std::string &index_type = "bptree");
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -33,18 +36,29 @@ class IndexMetadata {
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline bool IsUnique() const { return unique_; }
+
+  inline const std::string &GetIndexType() const { return index_type_; }
+
  private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                         const std::vector<uint32_t> &key_map);
+                         const std::vector<uint32_t> &key_map, bool unique, const std::string &index_type);
 
  private:
-  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  /**
+   * Index metadata written before the unique flag, the index type and the normalized key encoding carried the old
+   * magic number, its index pages cannot be read any more
+   */
+  static constexpr uint32_t LEGACY_INDEX_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344529;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
+  bool unique_;                   /** Whether two entries may share a key */
+  std::string index_type_;        /** "bptree", "hash" or "art" */
 };
 
 /**
@@ -61,14 +75,14 @@ class IndexInfo {
   }
 
 
-  void Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPoolManager *buffer_pool_manager,const string &index_type = "bptree") {
+  void Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPoolManager *buffer_pool_manager) {
     // Step1: init index metadata and table info
     // Step2: mapping index key to key schema
     // Step3: call CreateIndex to create the index
     meta_data_ = meta_data;
     table_info_ = table_info;
     key_schema_ = Schema::ShallowCopySchema(table_info->GetSchema(),meta_data->key_map_);
-    index_ = CreateIndex(buffer_pool_manager,index_type);
+    index_ = CreateIndex(buffer_pool_manager,meta_data->index_type_);
   }
 
   inline Index *GetIndex() { return index_; }
@@ -76,6 +90,9 @@ class IndexInfo {
   std::string GetIndexName() { return meta_data_->GetIndexName(); }
   index_id_t GetIndexId() {return meta_data_->index_id_;}
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
+  const std::vector<uint32_t> &GetKeyMapping() const { return meta_data_->GetKeyMapping(); }
+  bool IsUnique() { return meta_data_->IsUnique(); }
+  const std::string &GetIndexType() { return meta_data_->GetIndexType(); }
 
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, key_schema_{nullptr} {}
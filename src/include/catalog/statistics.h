@@ -0,0 +1,84 @@
+#ifndef MINISQL_STATISTICS_H
+#define MINISQL_STATISTICS_H
+
+#include <string>
+#include <vector>
+
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * What ANALYZE learned about the values of one column.
+ */
+struct ColumnStatistics {
+  /** The share of the rows whose value is null */
+  double null_fraction{0};
+  /** The distinct non-null values, estimated from the sample when the table is larger */
+  double distinct_count{0};
+  /** The most common values, most common first, and the share of the rows holding each */
+  std::vector<Field> common_values;
+  std::vector<double> common_fractions;
+  /**
+   * An equi-depth histogram of the non-null values: bounds[0] is the smallest value, bounds.back() the
+   * largest, and each bucket between two consecutive bounds holds the same share of the values.
+   */
+  std::vector<Field> bounds;
+};
+
+/**
+ * The statistics of a table collected by ANALYZE: its size, and for every column the share of nulls,
+ * the number of distinct values, the most common values and a histogram. The planner estimates from
+ * them the share of the rows a predicate keeps.
+ *
+ * Every row is counted, the column statistics come from a sample of up to STATISTICS_SAMPLE_ROWS rows.
+ * The statistics are kept on a page of their own, the histograms shrinking until they fit.
+ */
+class TableStatistics {
+ public:
+  /**
+   * Scan a table and compute its statistics.
+   * @return The statistics, owned by the caller
+   */
+  static TableStatistics *Collect(TableHeap *table_heap, const Schema *schema, Transaction *txn);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  /**
+   * @param schema The schema of the table, giving the types of the values
+   */
+  static uint32_t DeserializeFrom(char *buf, const Schema *schema, TableStatistics *&statistics);
+
+  inline uint64_t GetRowCount() const { return row_count_; }
+
+  inline uint64_t GetPageCount() const { return page_count_; }
+
+  inline const ColumnStatistics &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /**
+   * @param op A comparison of ComparisonExpression: =, <>, <, <=, >, >=, or is and not with a null value
+   * @return The share of the rows whose value of column col_idx compares to value as op says
+   */
+  double EstimateSelectivity(uint32_t col_idx, const std::string &op, const Field &value) const;
+
+ private:
+  TableStatistics() = default;
+
+  /** @return The share of the rows whose value of column col_idx equals value */
+  double EqualFraction(uint32_t col_idx, const Field &value) const;
+
+  /** @return The share of the non-null values of column col_idx below value, read from the histogram */
+  double FractionBelow(uint32_t col_idx, const Field &value) const;
+
+  /** Halve the histograms and the most common values, false once there is nothing left to drop */
+  bool Shrink();
+
+  static constexpr uint32_t TABLE_STATISTICS_MAGIC_NUM = 271828;
+  uint64_t row_count_{0};
+  uint64_t page_count_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+#endif  // MINISQL_STATISTICS_H
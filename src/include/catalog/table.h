@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "catalog/statistics.h"
 #include "glog/logging.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
@@ -37,6 +38,11 @@ class TableMetadata {
 
   inline Schema *GetSchema() const { return schema_; }
 
+  /** @return The page holding the statistics of the table, INVALID_PAGE_ID until it is analyzed */
+  inline page_id_t GetStatisticsPageId() const { return statistics_page_id_; }
+
+  inline void SetStatisticsPageId(page_id_t page_id) { statistics_page_id_ = page_id; }
+
  private:
   TableMetadata() = delete;
 
@@ -44,10 +50,13 @@ class TableMetadata {
 
  private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  /** Marks the statistics page id after the schema, metadata written before ANALYZE existed lacks it */
+  static constexpr uint32_t TABLE_STATISTICS_PAGE_MAGIC_NUM = 314159;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  page_id_t statistics_page_id_{INVALID_PAGE_ID};
 };
 
 /**
@@ -60,6 +69,7 @@ class TableInfo {
   ~TableInfo() {
     delete table_meta_;
     delete table_heap_;
+    delete statistics_;
   }
 
   void Init(TableMetadata *table_meta, TableHeap *table_heap) {
@@ -77,12 +87,24 @@ class TableInfo {
 
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
+  inline TableMetadata *GetTableMetadata() const { return table_meta_; }
+
+  /** @return The statistics collected by the last ANALYZE of the table, nullptr if it was never analyzed */
+  inline const TableStatistics *GetStatistics() const { return statistics_; }
+
+  /** Replace the statistics of the table, taking ownership of statistics */
+  void SetStatistics(TableStatistics *statistics) {
+    delete statistics_;
+    statistics_ = statistics;
+  }
+
  private:
   explicit TableInfo(){};
 
  private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStatistics *statistics_{nullptr};
 };
 
 #endif  // MINISQL_TABLE_H
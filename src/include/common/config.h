@@ -15,6 +15,26 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index
 
 static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr double INDEX_FILL_FACTOR = 0.9;        // share of each page filled by a bulk index build
+static constexpr bool INDEX_LAZY_DELETE = true;         // defer B+ tree merges until VACUUM INDEX
+static constexpr double INDEX_MERGE_LOW_WATER = 0.25;   // share of a page below which a lazy delete still merges
+static constexpr int INDEX_PINNED_LEVELS = 2;           // top B+ tree levels kept pinned in the buffer pool
+static constexpr int INDEX_BLOOM_BITS_PER_KEY = 10;     // bloom filter bits per B+ tree index entry
+static constexpr uint32_t EXECUTOR_BATCH_SIZE = 1024;   // rows per batch passed between executors
+static constexpr uint32_t SCAN_MORSEL_PAGES = 16;       // table pages a parallel scan worker takes at a time
+static constexpr uint32_t SCAN_MAX_WORKERS = 16;        // threads of a parallel scan, at most one per core
+static constexpr size_t EXECUTOR_MEMORY_BUDGET = 32 << 20;  // bytes of rows an executor holds before spilling
+static constexpr uint32_t SPILL_PARTITIONS = 16;        // partitions an executor over its budget spills into
+static constexpr uint32_t SORT_MERGE_WAYS = 16;         // sorted runs an external sort merges at a time
+static constexpr size_t INDEX_BUILD_MEMORY_BUDGET = 32 << 20;  // bytes of keys an index build sorts before spilling
+static constexpr uint32_t STATISTICS_SAMPLE_ROWS = 30000;     // rows ANALYZE samples for the column statistics
+static constexpr uint32_t STATISTICS_HISTOGRAM_BUCKETS = 32;  // buckets of the histogram of a column
+static constexpr uint32_t STATISTICS_COMMON_VALUES = 8;       // most common values ANALYZE keeps per column
+static constexpr double COST_RANDOM_PAGE = 4.0;  // cost of a page read out of order, a sequential page read costs 1
+static constexpr double COST_ROW = 0.01;         // cost of producing or checking a row
+static constexpr uint32_t PLANNER_DEFAULT_PAGES = 100;    // pages of a table neither analyzed nor measured
+static constexpr uint32_t PLANNER_DEFAULT_ROWS = 10000;   // rows of a table neither analyzed nor measured
+static constexpr uint32_t RESULT_SAMPLE_ROWS = 1000;    // rows a table result is sized on before it starts printing
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
@@ -8,8 +8,17 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "record/field.h"
+
+/** How the rows of a select are written out */
+enum class OutputFormat {
+  Table,  // a table boxed with dividers, the columns sized on the first rows
+  Csv,    // comma separated values, fields quoted as RFC 4180 asks
+  Tsv     // tab separated values, tabs, newlines and backslashes escaped with backslashes
+};
+
 class ResultWriter {
  public:
   explicit ResultWriter(std::ostream &stream, bool disable_header = false, const char *separator = "|")
@@ -22,7 +31,7 @@ class ResultWriter {
       stream_ << " " << std::setfill(' ') << std::setw(width) << std::left << cell << " " << separator_;
     }
   }
-  void Divider(vector<int> &data_width) {
+  void Divider(std::vector<int> &data_width) {
     stream_ << "+";
     for (auto width : data_width) {
       stream_ << std::setfill('-') << std::setw(width + 3) << std::right << "+";
@@ -30,7 +39,26 @@ class ResultWriter {
     stream_ << "\n";
   }
   void BeginRow() { stream_ << "|"; }
-  void EndRow() { stream_ << std::endl; }
+  void EndRow() { stream_ << "\n"; }
+  /**
+   * Write one row of a Csv or Tsv result, the header row being the column names.
+   * @param nulls Which of cells are null, null values are written as empty fields, \N in Tsv
+   */
+  void WriteDelimitedRow(OutputFormat format, const std::vector<std::string> &cells, const std::vector<bool> &nulls) {
+    for (size_t i = 0; i < cells.size(); i++) {
+      if (i > 0) {
+        stream_ << (format == OutputFormat::Csv ? ',' : '\t');
+      }
+      if (nulls[i]) {
+        stream_ << (format == OutputFormat::Csv ? "" : "\\N");
+      } else if (format == OutputFormat::Csv) {
+        WriteCsvField(cells[i]);
+      } else {
+        WriteTsvField(cells[i]);
+      }
+    }
+    stream_ << "\n";
+  }
   void EndInformation(size_t result_size, double time, bool is_scan) {
     if (is_scan) {
       if (!result_size)
@@ -40,11 +68,48 @@ class ResultWriter {
     } else {
       stream_ << "Query OK, " << result_size << " row affected";
     }
-    stream_ << "(" << fixed << setprecision(4) << time / 1000 << " sec)." << std::endl;
+    stream_ << "(" << std::fixed << std::setprecision(4) << time / 1000 << " sec)." << std::endl;
   }
   bool disable_header_;
   std::ostream &stream_;
   std::string separator_;
+
+ private:
+  void WriteCsvField(const std::string &cell) {
+    // an empty string is quoted to tell it from a null
+    if (!cell.empty() && cell.find_first_of(",\"\r\n") == std::string::npos) {
+      stream_ << cell;
+      return;
+    }
+    stream_ << '"';
+    for (char c : cell) {
+      if (c == '"') {
+        stream_ << '"';
+      }
+      stream_ << c;
+    }
+    stream_ << '"';
+  }
+  void WriteTsvField(const std::string &cell) {
+    for (char c : cell) {
+      switch (c) {
+        case '\t':
+          stream_ << "\\t";
+          break;
+        case '\n':
+          stream_ << "\\n";
+          break;
+        case '\r':
+          stream_ << "\\r";
+          break;
+        case '\\':
+          stream_ << "\\\\";
+          break;
+        default:
+          stream_ << c;
+      }
+    }
+  }
 };
 
 #endif  // MINISQL_RESULTWRITER_H
@@ -0,0 +1,101 @@
+#ifndef MINISQL_COMPILED_PREDICATE_H
+#define MINISQL_COMPILED_PREDICATE_H
+
+#include <string>
+#include <vector>
+
+#include "executor/filter_kernels.h"
+#include "executor/row_batch.h"
+#include "planner/expressions/abstract_expression.h"
+
+enum class PredicateOpcode : uint8_t {
+  kConstant,       // result = int_value != 0
+  kIntCompare,     // result = column op int_value
+  kFloatCompare,   // result = column op float_value
+  kCharCompare,    // result = column op the chars at char_offset
+  kColumnCompare,  // result = column op right_column, both of type type
+  kIsNull,         // result = column is null
+  kIsNotNull,      // result = column is not null
+  kJumpIfFalse,    // skip to target if result is false, the left side of an and
+  kJumpIfTrue      // skip to target if result is true, the left side of an or
+};
+
+/** One step of a compiled predicate, every operand is resolved when the predicate is compiled. */
+struct PredicateInstruction {
+  PredicateOpcode opcode;
+  CompareOp op{CompareOp::kEqual};
+  TypeId type{TypeId::kTypeInvalid};
+  uint32_t column{0};
+  uint32_t right_column{0};
+  uint32_t target{0};
+  int32_t int_value{0};
+  float float_value{0};
+  uint32_t char_offset{0};
+  uint32_t char_length{0};
+};
+
+/**
+ * A predicate compiled from an expression tree into a flat program, run over a row or over the columns
+ * of a RowBatch.
+ *
+ * Each comparison of a column with a constant becomes a single typed instruction, and `and` / `or`
+ * become conditional jumps, so evaluating a row does not build any Field. The result matches
+ * Evaluate() on the tree being kTrue: a comparison involving null is false.
+ *
+ * A program that is a conjunction of int / float comparisons with constants and null tests is
+ * vectorized: Filter() runs each comparison over the whole column with FilterKernels and combines
+ * the resulting bitmaps instead of running the program row by row.
+ *
+ * Trees that do not fit the program, e.g. comparisons between different types, are evaluated with
+ * AbstractExpression::Evaluate() on the materialized row instead.
+ */
+class CompiledPredicate {
+ public:
+  /** Compile predicate over rows with every column of the table, a null predicate accepts every row. */
+  explicit CompiledPredicate(const AbstractExpressionRef &predicate = nullptr);
+
+  /** @return false if the predicate could not be compiled and falls back to the expression tree */
+  inline bool IsCompiled() const { return fallback_ == nullptr; }
+
+  /** @return true if every row is accepted */
+  inline bool AcceptsAll() const { return fallback_ == nullptr && program_.empty(); }
+
+  /** @return true if Filter() runs the predicate column by column with the filter kernels */
+  inline bool IsVectorized() const { return vectorized_; }
+
+  /** @return the columns the program reads in ascending order, empty if it is not compiled */
+  inline const std::vector<uint32_t> &GetColumns() const { return columns_; }
+
+  /** @return true if the predicate accepts row, which has every column of the table */
+  bool Evaluate(const Row &row) const;
+
+  /**
+   * @return true if the predicate accepts the serialized row, located up to the last of GetColumns().
+   * The predicate must be compiled.
+   */
+  bool Evaluate(const TupleView &tuple) const;
+
+  /** Remove the rows the predicate does not accept from the selection of batch. */
+  void Filter(RowBatch *batch) const;
+
+ private:
+  bool Compile(const AbstractExpressionRef &expr);
+
+  bool CompileComparison(const AbstractExpressionRef &expr);
+
+  /** Run the program on the column values given by source, see the sources in the .cpp */
+  template <typename Source>
+  bool Run(const Source &source) const;
+
+  void FilterVectorized(RowBatch *batch) const;
+
+  std::vector<PredicateInstruction> program_;
+  /** The char constants of the program */
+  std::string chars_;
+  std::vector<uint32_t> columns_;
+  /** The tree to evaluate if it could not be compiled */
+  AbstractExpressionRef fallback_;
+  bool vectorized_{false};
+};
+
+#endif  // MINISQL_COMPILED_PREDICATE_H
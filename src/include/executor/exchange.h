@@ -0,0 +1,66 @@
+#ifndef MINISQL_EXCHANGE_H
+#define MINISQL_EXCHANGE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "executor/row_batch.h"
+
+/**
+ * Passes the batches of the workers of a parallel scan to the consumer.
+ *
+ * The input is cut into morsels numbered in scan order. Workers take the next morsel, push the
+ * batches they produce for it and finish it, while the consumer pops batches morsel by morsel, so
+ * it sees the rows in the order of a serial scan. A worker does not start a morsel more than
+ * window morsels ahead of the consumer, which bounds the batches waiting in the exchange.
+ */
+class Exchange {
+ public:
+  Exchange(size_t morsel_count, size_t window);
+
+  /**
+   * Worker side: claim the next morsel, waiting while it is too far ahead of the consumer.
+   * @return false when every morsel is taken or the exchange is closed
+   */
+  bool TakeMorsel(size_t *morsel);
+
+  /**
+   * Worker side: hand over a batch of morsel.
+   * @return false if the exchange is closed, the worker should stop
+   */
+  bool Push(size_t morsel, RowBatch &&batch);
+
+  /** Worker side: morsel produces no more batches. */
+  void Finish(size_t morsel);
+
+  /**
+   * Consumer side: wait for the next batch in morsel order.
+   * @return false once every morsel is finished and drained
+   */
+  bool Pop(RowBatch *batch);
+
+  /** Stop handing out morsels and drop whatever is still pushed, for a consumer that stops early. */
+  void Close();
+
+ private:
+  struct Slot {
+    std::deque<RowBatch> batches;
+    bool finished{false};
+  };
+
+  std::mutex latch_;
+  /** Signals a batch pushed or a morsel finished */
+  std::condition_variable produced_;
+  /** Signals the consumer moving to the next morsel */
+  std::condition_variable consumed_;
+  std::vector<Slot> slots_;
+  size_t window_;
+  size_t next_morsel_{0};
+  /** The morsel the consumer pops from */
+  size_t current_{0};
+  bool closed_{false};
+};
+
+#endif  // MINISQL_EXCHANGE_H
@@ -1,12 +1,14 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "common/result_writer.h"
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/abstract_plan.h"
@@ -38,11 +40,28 @@ class ExecuteEngine {
   dberr_t ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<Row> *result_set, Transaction *txn,
                       ExecuteContext *exec_ctx);
 
+  /**
+   * Execute a plan, handing every batch to consume as soon as the executor produces it,
+   * so that the rows need not be held until the plan is done.
+   */
+  dberr_t ExecutePlan(const AbstractPlanNodeRef &plan, const std::function<void(const RowBatch &)> &consume,
+                      Transaction *txn, ExecuteContext *exec_ctx);
+
+  /** Set how the rows of a select are printed, a boxed table by default */
+  void SetOutputFormat(OutputFormat format) { output_format_ = format; }
+
   void ExecuteInformation(dberr_t result);
 
  private:
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
 
+  /**
+   * Execute a select plan, printing its rows while they are produced.
+   * A table is sized on its first RESULT_SAMPLE_ROWS rows, the longer values of later rows widen their cell only.
+   * @param[out] row_count The rows printed
+   */
+  dberr_t ExecuteSelect(const AbstractPlanNodeRef &plan, ExecuteContext *context, size_t *row_count);
+
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context);
@@ -63,6 +82,11 @@ class ExecuteEngine {
 
   dberr_t ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteVacuumIndex(pSyntaxNode ast, ExecuteContext *context);
+
+  /** Collect the statistics of the table named by ast, of every table of the database without a name */
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context);
@@ -76,6 +100,7 @@ class ExecuteEngine {
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
+  OutputFormat output_format_{OutputFormat::Table};        /** how the rows of a select are printed */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
@@ -2,8 +2,10 @@
 #define MINISQL_ABSTRACT_EXECUTOR_H
 
 #include "executor/execute_context.h"
+#include "executor/row_batch.h"
 /**
- * The AbstractExecutor implements the Volcano row-at-a-time iterator model.
+ * The AbstractExecutor implements the Volcano row-at-a-time iterator model,
+ * and next to it a batch-at-a-time model through NextBatch().
  * This is the base class from which all executors in the execution engine
  * inherit, and defines the minimal interface that all executors support.
  */
@@ -32,6 +34,39 @@ class AbstractExecutor {
    */
   virtual bool Next(Row *row, RowId *rid) = 0;
 
+  /**
+   * Yield the next batch of rows from this executor. The default fills the batch
+   * through Next(); executors working on whole batches override it and implement
+   * Next() with NextFromBatch().
+   * @param[out] batch Emptied, then filled with up to EXECUTOR_BATCH_SIZE rows
+   * @return `true` if a batch with at least one selected row was produced,
+   * `false` if there are no more rows
+   */
+  virtual bool NextBatch(RowBatch *batch) {
+    batch->Reset(nullptr);
+    Row row{};
+    RowId rid{};
+    while (!batch->IsFull() && Next(&row, &rid)) {
+      row.SetRowId(rid);
+      batch->Append(row);
+    }
+    return batch->Size() > 0;
+  }
+
+  /**
+   * Ask for every column of the table in the batches of this executor, for a parent that reads
+   * them with RowBatch::GetFullRow(). Called before Init(), scans otherwise decode only the
+   * columns of their output schema and predicate.
+   */
+  virtual void RequireFullRows() {}
+
+  /**
+   * Release what the executor holds, pinned pages, worker threads and spilled rows, when its parent
+   * needs no more of its rows, e.g. once a limit is reached. Neither Next() nor NextBatch() is called
+   * after it until the next Init().
+   */
+  virtual void Close() {}
+
   /** @return The schema of the rows that this executor produces */
   virtual const Schema *GetOutputSchema() const = 0;
 
@@ -39,8 +74,33 @@ class AbstractExecutor {
   ExecuteContext *GetExecutorContext() { return exec_ctx_; }
 
  protected:
+  /**
+   * Next() on top of NextBatch(): hands out the selected rows of one batch at a time.
+   * Executors using it call ResetBatchAdapter() from Init().
+   */
+  bool NextFromBatch(Row *row, RowId *rid) {
+    while (adapter_cursor_ >= adapter_batch_.SelectedCount()) {
+      if (!NextBatch(&adapter_batch_)) {
+        return false;
+      }
+      adapter_cursor_ = 0;
+    }
+    adapter_batch_.GetRow(adapter_cursor_++, row);
+    *rid = row->GetRowId();
+    return true;
+  }
+
+  void ResetBatchAdapter() {
+    adapter_batch_.Clear();
+    adapter_cursor_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecuteContext *exec_ctx_;
+
+ private:
+  RowBatch adapter_batch_;
+  size_t adapter_cursor_{0};
 };
 
 #endif  // MINISQL_ABSTRACT_EXECUTOR_H
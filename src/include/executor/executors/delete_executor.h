@@ -52,6 +52,7 @@ class DeleteExecutor : public AbstractExecutor {
   TableHeap *table_heap= nullptr;
   int flag=0;
   string table_name;
+  std::vector<IndexInfo *> indexes;
 };
 
 #endif  // MINISQL_DELETE_EXECUTOR_H
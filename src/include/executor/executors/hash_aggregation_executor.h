@@ -0,0 +1,171 @@
+#ifndef MINISQL_HASH_AGGREGATION_EXECUTOR_H
+#define MINISQL_HASH_AGGREGATION_EXECUTOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/aggregation_plan.h"
+#include "executor/spill_file.h"
+
+/**
+ * The HashAggregationExecutor groups the rows of its child on the group by columns and computes the
+ * aggregates of every group.
+ *
+ * The groups live in an open-addressing hash table keyed by their group by values encoded into bytes,
+ * next to the running state of each aggregate, which the rows update column by column as they come
+ * in batches. Without group by columns there is one group and count(*) only counts the rows of a batch,
+ * so a count over a table holds nothing but the count.
+ *
+ * A parallel scan child runs the aggregation on its workers: each worker aggregates into a table of
+ * its own, and the tables are merged once the scan is over.
+ *
+ * A table growing past its share of the memory budget keeps aggregating the rows of the groups it
+ * already has, and writes the rows of any other group to SpillFiles partitioned by the hash of the
+ * group key. The groups in memory are then split up the same way, and each partition is finished on
+ * its own, by aggregating its spilled rows into its groups, before its groups are output.
+ */
+class HashAggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new HashAggregationExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The aggregation plan to be executed
+   * @param child The executor producing the rows to aggregate
+   * @param memory_budget Bytes of groups held in memory before spilling
+   */
+  HashAggregationExecutor(ExecuteContext *exec_ctx, const AggregationPlanNode *plan,
+                          std::unique_ptr<AbstractExecutor> child, size_t memory_budget = EXECUTOR_MEMORY_BUDGET);
+
+  /** Aggregate the whole input of the child */
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch of groups.
+   * @param[out] batch Filled with one output row per group
+   * @return `true` if a batch was produced, `false` if there are no more groups
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /** Close the child and drop the groups, in memory and spilled */
+  void Close() override;
+
+  /** @return The output schema of the aggregation */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** The running state of one aggregate of one group */
+  struct Accumulator {
+    /** The rows aggregated, for every aggregate but count(*) only those with a non-null value */
+    int64_t count{0};
+    /** The sum, minimum or maximum of an int column */
+    int64_t int_value{0};
+    /** The sum, minimum or maximum of a float column */
+    double float_value{0};
+    /** The minimum or maximum of a char column */
+    std::string chars;
+  };
+
+  /** Groups and their accumulators, found by the bytes of their key */
+  class GroupTable {
+   public:
+    static constexpr size_t kNoGroup = static_cast<size_t>(-1);
+
+    explicit GroupTable(size_t aggregate_count) : aggregate_count_(aggregate_count) {}
+
+    /**
+     * Find the group of a key, adding it if it is new and insert is set.
+     * @return The index of the group, kNoGroup for a new key without insert
+     */
+    size_t Find(const char *key, size_t size, uint64_t hash, bool insert);
+
+    size_t GetGroupCount() const { return hashes_.size(); }
+
+    /** @return The accumulators of group, one per aggregate */
+    Accumulator *GetAccumulators(size_t group) { return &accumulators_[group * aggregate_count_]; }
+
+    const char *GetKey(size_t group) const { return key_bytes_.data() + key_offsets_[group]; }
+
+    size_t GetKeySize(size_t group) const { return key_offsets_[group + 1] - key_offsets_[group]; }
+
+    uint64_t GetHash(size_t group) const { return hashes_[group]; }
+
+    /** @return The bytes the groups take, roughly */
+    size_t GetMemoryUsage() const { return memory_; }
+
+   private:
+    /** Double the slots and put every group in its new slot */
+    void Grow();
+
+    size_t aggregate_count_;
+    /** The group in each slot, kNoGroup if the slot is free, at most half of the slots are used */
+    std::vector<size_t> slots_;
+    std::vector<uint64_t> hashes_;
+    /** The key of group i is the bytes from key_offsets_[i] to key_offsets_[i + 1] */
+    std::vector<char> key_bytes_;
+    std::vector<size_t> key_offsets_{0};
+    std::vector<Accumulator> accumulators_;
+    size_t memory_{0};
+  };
+
+  /** What one worker aggregated: its groups, and the rows of the groups that did not fit */
+  struct Partial {
+    explicit Partial(size_t aggregate_count) : table(aggregate_count) {}
+
+    GroupTable table;
+    /** Empty until the table outgrows its budget */
+    std::vector<std::unique_ptr<SpillFile>> spills;
+    /** Scratch space of Aggregate(), so workers do not share any */
+    std::string key;
+    std::vector<size_t> groups;
+    Row row;
+  };
+
+  /**
+   * Aggregate the selected rows of batch, laid out as the child output, into partial.
+   * @param budget The bytes the table of partial may take before rows of new groups are spilled
+   */
+  void Aggregate(Partial *partial, RowBatch *batch, size_t budget);
+
+  /** Fold the value at position of column into an accumulator of aggregate a */
+  void Update(Accumulator *accumulator, size_t a, const ColumnVector &column, uint32_t position) const;
+
+  /** Fold the accumulators of group of from into the same group of into, adding it if it is new */
+  void Merge(GroupTable *into, GroupTable *from, size_t group) const;
+
+  /** @return The value of aggregate a from its accumulator */
+  Field Result(const Accumulator &accumulator, size_t a) const;
+
+  /** @return The output row of group of table */
+  Row MakeOutputRow(GroupTable *table, size_t group) const;
+
+  /**
+   * Finish the next partition of a spilled aggregation, aggregating its rows into its groups.
+   * @return false once every partition was output
+   */
+  bool NextPartition();
+
+  const AggregationPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  size_t memory_budget_;
+  /** The group by columns and the columns aggregated, as positions in the child output, unused for count(*) */
+  std::vector<uint32_t> key_columns_;
+  std::vector<uint32_t> aggregate_columns_;
+  std::vector<AggregationType> aggregate_types_;
+  /** The types of the key columns and of the columns aggregated */
+  std::vector<TypeId> key_types_;
+  std::vector<TypeId> aggregate_arg_types_;
+  /** One per worker of the child, a single one unless it is a parallel scan */
+  std::vector<Partial> partials_;
+  /** The groups of a spilled aggregation split up by partition */
+  std::vector<Partial> partitions_;
+  size_t next_partition_{0};
+  /** The table being output, and its next group */
+  GroupTable *output_table_{nullptr};
+  size_t output_group_{0};
+};
+
+#endif  // MINISQL_HASH_AGGREGATION_EXECUTOR_H
@@ -0,0 +1,126 @@
+#ifndef MINISQL_HASH_JOIN_EXECUTOR_H
+#define MINISQL_HASH_JOIN_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/hash_join_plan.h"
+#include "executor/spill_file.h"
+
+/**
+ * The HashJoinExecutor joins its two children on equal keys.
+ *
+ * Init() pulls batches from both children in turn until one of them is exhausted: that side, the
+ * smaller one, is built into a hash table and the other side probes it, first with the rows already
+ * pulled, then with the rest of its rows as they come. Rows with a null key never match.
+ *
+ * When both sides grow past the memory budget first, every row of both sides is partitioned by the
+ * hash of its key into SpillFiles, and the partitions are joined one pair at a time, each time
+ * building on the smaller one.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new HashJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The hash join plan to be executed
+   * @param left The executor of the left side
+   * @param right The executor of the right side
+   * @param memory_budget Bytes of rows held in memory before spilling
+   */
+  HashJoinExecutor(ExecuteContext *exec_ctx, const HashJoinPlanNode *plan, std::unique_ptr<AbstractExecutor> left,
+                   std::unique_ptr<AbstractExecutor> right, size_t memory_budget = EXECUTOR_MEMORY_BUDGET);
+
+  /** Build the hash table of the smaller side, or partition both sides if they do not fit */
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch of joined rows.
+   * @param[out] batch Filled with the output rows
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /** Close both children and drop the rows held, in memory and spilled */
+  void Close() override;
+
+  /** @return The output schema of the join */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** The rows pulled from one child */
+  struct Side {
+    explicit Side(AbstractExecutor *child) : child(child) {}
+
+    AbstractExecutor *child;
+    std::vector<Row> rows;
+    size_t bytes{0};
+  };
+
+  /** Pull one batch of side into its rows, @return false if the child is exhausted */
+  bool Pull(Side *side);
+
+  /**
+   * Evaluate the keys of row.
+   * @return the hash of the keys, with has_null set if one of them is null
+   */
+  uint64_t HashKeys(const Row &row, const std::vector<AbstractExpressionRef> &keys, std::vector<Field> *values,
+                    bool *has_null);
+
+  /** Make rows the build side, probed by rows of the other side */
+  void Build(std::vector<Row> &&rows, bool build_left);
+
+  /** Join the probe row with its matching build rows into batch, stops when batch is full */
+  void Probe(RowBatch *batch);
+
+  /** Move the rows of both sides and the rest of both children into partitions */
+  void Spill(Side *left, Side *right);
+
+  /** Load the next pair of partitions and build on its smaller side, @return false if none is left */
+  bool NextPartition();
+
+  /** Next row to probe with, from the buffered rows, the probe child, or the loaded partition */
+  bool NextProbeRow();
+
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  size_t memory_budget_;
+
+  /** Whether the build rows come from the left child */
+  bool build_left_{false};
+  std::vector<Row> build_rows_;
+  std::vector<uint64_t> build_hashes_;
+  /** First build row of each bucket, then the next row of the same bucket, -1 ends a chain */
+  std::vector<size_t> heads_;
+  std::vector<size_t> chain_;
+  uint64_t bucket_mask_{0};
+
+  /** The probe rows buffered while reading both sides, and the next one */
+  std::vector<Row> probe_rows_;
+  size_t probe_cursor_{0};
+  /** Streams the rest of the probe side when set */
+  AbstractExecutor *probe_child_{nullptr};
+  RowBatch probe_batch_;
+  size_t probe_batch_cursor_{0};
+
+  /** The probe row being joined and the next build row of its chain to check */
+  Row probe_row_;
+  bool has_probe_row_{false};
+  uint64_t probe_hash_{0};
+  std::vector<Field> probe_keys_;
+  size_t match_{0};
+  /** Scratch for the keys of a build row */
+  std::vector<Field> build_keys_;
+
+  /** Spilled partitions of the left and right side, joined from next_partition_ on */
+  std::vector<std::unique_ptr<SpillFile>> left_partitions_;
+  std::vector<std::unique_ptr<SpillFile>> right_partitions_;
+  size_t next_partition_{0};
+  SpillFile *probe_file_{nullptr};
+};
+
+#endif  // MINISQL_HASH_JOIN_EXECUTOR_H
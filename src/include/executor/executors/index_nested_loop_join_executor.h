@@ -0,0 +1,69 @@
+#ifndef MINISQL_INDEX_NESTED_LOOP_JOIN_EXECUTOR_H
+#define MINISQL_INDEX_NESTED_LOOP_JOIN_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "executor/compiled_predicate.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/index_nested_loop_join_plan.h"
+
+/**
+ * The IndexNestedLoopJoinExecutor looks up the rows of the inner table matching each outer row in an
+ * index of the inner table, and fetches them from the table heap.
+ *
+ * The outer rows are taken a batch at a time and their keys sorted before probing, so the lookups walk
+ * the index in key order, touching each leaf once per batch, and an outer key repeated in a batch is
+ * looked up once. The joined rows of a batch therefore come out in key order.
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new IndexNestedLoopJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The index nested loop join plan to be executed
+   * @param outer The executor of the outer side
+   */
+  IndexNestedLoopJoinExecutor(ExecuteContext *exec_ctx, const IndexNestedLoopJoinPlanNode *plan,
+                              std::unique_ptr<AbstractExecutor> outer);
+
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch of joined rows.
+   * @param[out] batch Filled with the output rows
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /** Close the outer side and drop the joined rows not output yet */
+  void Close() override;
+
+  /** @return The output schema of the join */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /**
+   * Join the next batch of outer rows into joined_.
+   * @return false if the outer side is exhausted
+   */
+  bool JoinOuterBatch();
+
+  /** Fetch the inner rows matching keys that pass the inner predicate into inner_rows_ */
+  void Lookup(const std::vector<Field> &keys);
+
+  const IndexNestedLoopJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> outer_;
+  TableInfo *table_info_{nullptr};
+  CompiledPredicate inner_predicate_;
+  RowBatch outer_batch_;
+  std::vector<Row> inner_rows_;
+  std::vector<RowId> rids_;
+  /** The joined rows of the last outer batch, and the next one to output */
+  std::vector<Row> joined_;
+  size_t joined_cursor_{0};
+};
+
+#endif  // MINISQL_INDEX_NESTED_LOOP_JOIN_EXECUTOR_H
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <vector>
-#include <stack>
+#include "executor/compiled_predicate.h"
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/index_scan_plan.h"
+#include "executor/rowid_bitmap.h"
 #include "planner/expressions/column_value_expression.h"
 #include "planner/expressions/comparison_expression.h"
 
@@ -31,16 +32,36 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the index scan.
+   * @param[out] batch Filled with whole table rows, projected to the output schema
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /** Drop the row ids not fetched yet, the table heap is not read any further */
+  void Close() override {
+    result.clear();
+    key_rows.clear();
+    result_i = 0;
+  }
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
-  void FindPredicates(AbstractExpressionRef predicate);
 
  private:
+  /** Collect the row ids matching the key predicates of one index */
+  void ScanIndex(IndexInfo *index, const vector<AbstractExpressionRef> &predicates, vector<RowId> &rids);
 
   /** The sequential scan plan node to be executed */
   const IndexScanPlanNode *plan_;
-  stack<AbstractExpressionRef> expressions;
   vector<RowId> result;
-  int result_i;
+  /** Keys of the result entries, only filled for an index-only scan */
+  vector<Row> key_rows;
+  size_t result_i;
   TableInfo *info;
+  /** Table columns of the output columns */
+  vector<uint32_t> schema_index;
+  /** The part of the predicate the index does not cover */
+  CompiledPredicate compiled_predicate;
 };
\ No newline at end of file
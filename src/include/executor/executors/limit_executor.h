@@ -0,0 +1,52 @@
+#ifndef MINISQL_LIMIT_EXECUTOR_H
+#define MINISQL_LIMIT_EXECUTOR_H
+
+#include <memory>
+
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/limit_plan.h"
+
+/**
+ * The LimitExecutor passes on the batches of its child, cutting the rows before the offset and after
+ * the limit out of their selection.
+ *
+ * The child is asked for no more rows than are still needed, through the capacity of the batch, so a
+ * scan reads no further than the last row passed on. Once the limit is reached the child is closed,
+ * releasing its pages before the query is over.
+ */
+class LimitExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new LimitExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The limit plan to be executed
+   * @param child The executor producing the rows
+   */
+  LimitExecutor(ExecuteContext *exec_ctx, const LimitPlanNode *plan, std::unique_ptr<AbstractExecutor> child);
+
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch of rows within the offset and the limit.
+   * @param[out] batch Filled by the child, with the rows outside them unselected
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  void Close() override { child_->Close(); }
+
+  /** @return The output schema of the limit */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  const LimitPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The rows pulled from the child so far, skipped or passed on */
+  size_t pulled_{0};
+  /** The rows to pull in all, the offset and the limit */
+  size_t wanted_{0};
+};
+
+#endif  // MINISQL_LIMIT_EXECUTOR_H
@@ -0,0 +1,90 @@
+#ifndef MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
+#define MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "executor/exchange.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/plans/seq_scan_plan.h"
+
+/**
+ * The ParallelSeqScanExecutor runs a sequential scan on a pool of worker threads.
+ *
+ * The pages of the table are listed once in Init() and cut into morsels of SCAN_MORSEL_PAGES pages.
+ * Each worker owns a SeqScanExecutor, so the projection and the predicate are pushed down exactly as
+ * in a serial scan, and moves it from morsel to morsel. The batches meet in an Exchange, which
+ * delivers them in page order: the rows come out as from a SeqScanExecutor. A parent that does not
+ * need that order, such as an aggregation, can instead consume the batches on the workers with ScanInto().
+ */
+class ParallelSeqScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ParallelSeqScanExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param worker_count Threads to scan with, one per core up to SCAN_MAX_WORKERS if 0
+   */
+  ParallelSeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan, size_t worker_count = 0);
+
+  /** Stops the workers, the rows not pulled yet are dropped */
+  ~ParallelSeqScanExecutor() override;
+
+  /** List the pages of the table, the workers start with the first NextBatch() */
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch produced by the workers, in page order.
+   * @param[out] batch Filled as by SeqScanExecutor::NextBatch()
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /**
+   * Scan the whole table on the workers, each passing its batches to consume on its own thread, in no
+   * particular order. Called after Init() in place of NextBatch(), returns once every page is scanned.
+   * @param consume Called with the index of the worker, below GetWorkerCount(), and a batch it produced
+   */
+  void ScanInto(const std::function<void(size_t worker, RowBatch *batch)> &consume);
+
+  /** @return The number of workers the table is scanned with, known after Init() */
+  size_t GetWorkerCount() const { return scans_.size(); }
+
+  void RequireFullRows() override { full_rows_ = true; }
+
+  /** Stop the workers and unpin their pages, the rows not pulled yet are dropped */
+  void Close() override;
+
+  /** @return The output schema for the sequential scan */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** Start the workers, or scan on the calling thread if there is only one */
+  void Start();
+
+  /** Scan morsels until the exchange has none left */
+  void Work(SeqScanExecutor *scan);
+
+  /** Restrict scan to the pages of morsel */
+  void ScanMorsel(SeqScanExecutor *scan, size_t morsel);
+
+  void Stop();
+
+  const SeqScanPlanNode *plan_;
+  size_t max_workers_;
+  bool full_rows_{false};
+  /** The pages of the table in chain order */
+  std::vector<page_id_t> pages_;
+  size_t morsel_count_{0};
+  bool started_{false};
+  std::vector<std::unique_ptr<SeqScanExecutor>> scans_;
+  std::vector<std::thread> workers_;
+  std::unique_ptr<Exchange> exchange_;
+};
+
+#endif  // MINISQL_PARALLEL_SEQ_SCAN_EXECUTOR_H
@@ -5,11 +5,14 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <memory>
 #include <vector>
 
+#include "executor/compiled_predicate.h"
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "storage/table_scanner.h"
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
@@ -34,6 +37,24 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows passing the predicate.
+   * @param[out] batch Filled with the columns of the output schema, every column if full rows were required
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  void RequireFullRows() override { full_rows = true; }
+
+  /** Unpin the page the scan stopped on */
+  void Close() override { scanner.reset(); }
+
+  /**
+   * Restrict the scan to the pages of the chain from first_page_id up to end_page_id, see TableScanner.
+   * Called after Init(), a parallel scan moves each of its workers from one morsel to the next with it.
+   */
+  void ScanPages(page_id_t first_page_id, page_id_t end_page_id);
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
@@ -43,10 +64,14 @@ class SeqScanExecutor : public AbstractExecutor {
   string table_name;
   const Schema *out_schema;
   TableInfo *table_info=nullptr;
-  TableIterator ite;
-  TableIterator end;
-  vector<Field> values;
-  vector<int> schema_index;
+  std::unique_ptr<TableScanner> scanner;
+  std::unique_ptr<TupleView> tuple;
+  vector<uint32_t> schema_index;
+  /** Columns decoded into the batch, and how many leading fields of a tuple must be located for them */
+  vector<uint32_t> decode_columns;
+  uint32_t locate_limit = 0;
+  bool full_rows = false;
+  CompiledPredicate compiled_predicate;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
\ No newline at end of file
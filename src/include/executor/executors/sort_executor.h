@@ -0,0 +1,100 @@
+#ifndef MINISQL_SORT_EXECUTOR_H
+#define MINISQL_SORT_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/sort_plan.h"
+#include "executor/spill_file.h"
+
+/**
+ * The SortExecutor orders the rows of its child.
+ *
+ * The rows are sorted in memory while they fit the memory budget. Past it, every budget's worth of rows
+ * is sorted and written out as a run to a SpillFile, and the runs are merged SORT_MERGE_WAYS at a time
+ * until few enough are left to be merged while the rows are output.
+ *
+ * With a limit, only the first rows are kept, in a heap whose top is the last of them, so a row sorting
+ * after it is dropped right away. A heap growing past the budget falls back to the external sort, whose
+ * runs then hold the first rows only.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SortExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sort plan to be executed
+   * @param child The executor producing the rows to sort
+   * @param memory_budget Bytes of rows held in memory before spilling
+   */
+  SortExecutor(ExecuteContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> child,
+               size_t memory_budget = EXECUTOR_MEMORY_BUDGET);
+
+  /** Sort the whole input of the child, leaving at most SORT_MERGE_WAYS runs to merge */
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /**
+   * Yield the next batch of sorted rows.
+   * @param[out] batch Filled with the output rows
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
+  /** Close the child and drop the sorted rows, in memory and in runs */
+  void Close() override;
+
+  /** @return The output schema of the sort */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return Whether row a sorts before row b */
+  bool Less(const Row &a, const Row &b) const;
+
+  /** Put the rows in memory in order into order_ */
+  void SortRows();
+
+  /** Sort the rows in memory and write them out as a run */
+  void SpillRun();
+
+  /** Merge the runs SORT_MERGE_WAYS at a time into fewer runs */
+  void MergePass();
+
+  /** Start merging the runs from first to last */
+  void StartMerge(size_t first, size_t last);
+
+  /** @return Whether the head of run a comes after the head of run b */
+  bool HeadAfter(size_t a, size_t b) const;
+
+  /**
+   * Take the next row of the runs being merged.
+   * @return false when every run was read
+   */
+  bool NextMerged(Row *row);
+
+  /** Append the output columns of row to batch */
+  void Output(const Row &row, RowBatch *batch) const;
+
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  size_t memory_budget_;
+  /** The key columns, as positions in the child output, and whether each of them is descending */
+  std::vector<uint32_t> key_columns_;
+  std::vector<bool> descending_;
+  /** The rows in memory, and their positions in order, or in a heap while keeping the first rows */
+  std::vector<Row> rows_;
+  std::vector<size_t> order_;
+  size_t bytes_{0};
+  bool top_n_{false};
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+  /** The next row of each run being merged, and the runs with one in a heap whose top comes first */
+  std::vector<Row> heads_;
+  std::vector<size_t> merge_heap_;
+  /** The next row in memory to output, and the rows output so far */
+  size_t cursor_{0};
+  size_t emitted_{0};
+};
+
+#endif  // MINISQL_SORT_EXECUTOR_H
@@ -8,6 +8,7 @@
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/update_plan.h"
+#include "executor/rowid_bitmap.h"
 
 /**
  * UpdateExecutor executes an update on a table.
@@ -53,10 +54,12 @@ class UpdateExecutor : public AbstractExecutor {
 
   /** The update plan node to be executed */
   const UpdatePlanNode *plan_;
-  /** Metadata identifying the table that should be updated */
+  /** The indexes of the table, fetched once and kept up to date with every updated row */
   std::vector<IndexInfo *> index_info_;
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The new row ids of rows moved to another page because they outgrew their own, skipped if scanned again */
+  RowIdBitmap moved_;
   TableInfo *table_info;
   int flag;
 };
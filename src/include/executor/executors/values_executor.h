@@ -32,6 +32,13 @@ class ValuesExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the values.
+   * @param[out] batch Filled with the evaluated rows
+   * @return `true` if a batch was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the values */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
@@ -0,0 +1,31 @@
+#ifndef MINISQL_FILTER_KERNELS_H
+#define MINISQL_FILTER_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/** Comparison operators of a compiled predicate */
+enum class CompareOp : uint8_t { kEqual, kNotEqual, kLessThan, kLessThanEquals, kGreaterThan, kGreaterThanEquals };
+
+/**
+ * Kernels comparing a whole column against a constant. They write a selection bitmap, where bit i % 64 of
+ * word i / 64 tells whether values[i] op constant holds, and clear the unused bits of the last word.
+ *
+ * Every build carries the scalar kernels. On x86 the AVX2 kernels are compiled as well, without raising
+ * the target of the rest of the program, and Best() picks them at runtime if the cpu supports them.
+ */
+struct FilterKernels {
+  const char *name;
+  void (*compare_ints)(const int32_t *values, size_t count, CompareOp op, int32_t constant, uint64_t *bitmap);
+  void (*compare_floats)(const float *values, size_t count, CompareOp op, float constant, uint64_t *bitmap);
+
+  static const FilterKernels &Scalar();
+
+  /** @return the AVX2 kernels, nullptr if this build or this cpu has none */
+  static const FilterKernels *Avx2();
+
+  /** @return the fastest kernels this cpu supports, chosen once */
+  static const FilterKernels &Best();
+};
+
+#endif  // MINISQL_FILTER_KERNELS_H
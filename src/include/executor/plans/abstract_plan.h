@@ -20,9 +20,12 @@ enum class PlanType {
   Delete,
   Values,
   Aggregation,
+  Sort,
   Limit,
   Distinct,
   NestedLoopJoin,
+  HashJoin,
+  IndexNestedLoopJoin,
 };
 
 class AbstractPlanNode;
@@ -0,0 +1,55 @@
+#ifndef MINISQL_AGGREGATION_PLAN_H
+#define MINISQL_AGGREGATION_PLAN_H
+
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "planner/expressions/aggregate_expression.h"
+
+/**
+ * The AggregationPlanNode groups the rows of its child on the group by columns and computes aggregates
+ * over each group. Without group by columns the whole input is one group, which yields a row even when
+ * the input is empty.
+ */
+class AggregationPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new AggregationPlanNode instance.
+   * @param output The output schema of the aggregation
+   * @param child The plan producing the rows to aggregate
+   * @param group_bys The columns of the child output to group on
+   * @param aggregates The AggregateExpressions computed per group, their arguments columns of the child output
+   * @param output_exprs The expressions of the output columns, evaluated on a row holding the values of
+   * group_bys followed by those of aggregates
+   */
+  AggregationPlanNode(const Schema *output, AbstractPlanNodeRef child, std::vector<AbstractExpressionRef> group_bys,
+                      std::vector<AbstractExpressionRef> aggregates, std::vector<AbstractExpressionRef> output_exprs)
+      : AbstractPlanNode(output, {std::move(child)}),
+        group_bys_(std::move(group_bys)),
+        aggregates_(std::move(aggregates)),
+        output_exprs_(std::move(output_exprs)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Aggregation; }
+
+  /** @return The plan producing the rows to aggregate */
+  AbstractPlanNodeRef GetChildPlan() const { return GetChildAt(0); }
+
+  const std::vector<AbstractExpressionRef> &GetGroupBys() const { return group_bys_; }
+
+  const std::vector<AbstractExpressionRef> &GetAggregates() const { return aggregates_; }
+
+  const std::vector<AbstractExpressionRef> &GetOutputExprs() const { return output_exprs_; }
+
+  /** The group by columns */
+  std::vector<AbstractExpressionRef> group_bys_;
+
+  /** The aggregates */
+  std::vector<AbstractExpressionRef> aggregates_;
+
+  /** The output columns */
+  std::vector<AbstractExpressionRef> output_exprs_;
+};
+
+#endif  // MINISQL_AGGREGATION_PLAN_H
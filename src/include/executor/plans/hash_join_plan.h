@@ -0,0 +1,63 @@
+#ifndef MINISQL_HASH_JOIN_PLAN_H
+#define MINISQL_HASH_JOIN_PLAN_H
+
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * The HashJoinPlanNode joins the rows of its left and right child on equal keys.
+ * A join without keys pairs every row of one side with every row of the other.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new HashJoinPlanNode instance.
+   * @param output The output schema of the join
+   * @param left The plan producing the left rows
+   * @param right The plan producing the right rows
+   * @param left_keys The keys of a left row, evaluated on the row
+   * @param right_keys The keys of a right row, compared for equality with left_keys in order
+   * @param predicate The condition left to check on each pair of matching rows, may be nullptr
+   * @param output_exprs The expressions of the output columns, evaluated on the left and right row
+   */
+  HashJoinPlanNode(const Schema *output, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
+                   std::vector<AbstractExpressionRef> left_keys, std::vector<AbstractExpressionRef> right_keys,
+                   AbstractExpressionRef predicate, std::vector<AbstractExpressionRef> output_exprs)
+      : AbstractPlanNode(output, {std::move(left), std::move(right)}),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        predicate_(std::move(predicate)),
+        output_exprs_(std::move(output_exprs)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return The plan of the left side */
+  AbstractPlanNodeRef GetLeftPlan() const { return GetChildAt(0); }
+
+  /** @return The plan of the right side */
+  AbstractPlanNodeRef GetRightPlan() const { return GetChildAt(1); }
+
+  const std::vector<AbstractExpressionRef> &GetLeftKeys() const { return left_keys_; }
+
+  const std::vector<AbstractExpressionRef> &GetRightKeys() const { return right_keys_; }
+
+  AbstractExpressionRef GetPredicate() const { return predicate_; }
+
+  const std::vector<AbstractExpressionRef> &GetOutputExprs() const { return output_exprs_; }
+
+  /** The join keys of each side */
+  std::vector<AbstractExpressionRef> left_keys_;
+  std::vector<AbstractExpressionRef> right_keys_;
+
+  /** The residual join condition */
+  AbstractExpressionRef predicate_;
+
+  /** The output columns */
+  std::vector<AbstractExpressionRef> output_exprs_;
+};
+
+#endif  // MINISQL_HASH_JOIN_PLAN_H
@@ -0,0 +1,76 @@
+#ifndef MINISQL_INDEX_NESTED_LOOP_JOIN_PLAN_H
+#define MINISQL_INDEX_NESTED_LOOP_JOIN_PLAN_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "catalog/catalog.h"
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * The IndexNestedLoopJoinPlanNode joins the rows of its child, the outer side, with the rows of a
+ * table found through an index of that table: each outer row looks up its keys in the index.
+ */
+class IndexNestedLoopJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new IndexNestedLoopJoinPlanNode instance.
+   * @param output The output schema of the join
+   * @param outer The plan producing the outer rows
+   * @param inner_table_name The table joined through the index
+   * @param index The index of the inner table
+   * @param outer_keys The values looked up, evaluated on an outer row, one per key column of the index
+   * from the first; a B+ tree may be given fewer than its key columns
+   * @param inner_predicate The condition on the inner table alone, evaluated on a full inner row, may be nullptr
+   * @param predicate The condition left to check on the outer row and the full inner row, may be nullptr
+   * @param output_exprs The expressions of the output columns, evaluated on the outer and the full inner row
+   */
+  IndexNestedLoopJoinPlanNode(const Schema *output, AbstractPlanNodeRef outer, std::string inner_table_name,
+                              IndexInfo *index, std::vector<AbstractExpressionRef> outer_keys,
+                              AbstractExpressionRef inner_predicate, AbstractExpressionRef predicate,
+                              std::vector<AbstractExpressionRef> output_exprs)
+      : AbstractPlanNode(output, {std::move(outer)}),
+        inner_table_name_(std::move(inner_table_name)),
+        index_(index),
+        outer_keys_(std::move(outer_keys)),
+        inner_predicate_(std::move(inner_predicate)),
+        predicate_(std::move(predicate)),
+        output_exprs_(std::move(output_exprs)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::IndexNestedLoopJoin; }
+
+  /** @return The plan of the outer side */
+  AbstractPlanNodeRef GetOuterPlan() const { return GetChildAt(0); }
+
+  std::string GetInnerTableName() const { return inner_table_name_; }
+
+  IndexInfo *GetIndex() const { return index_; }
+
+  const std::vector<AbstractExpressionRef> &GetOuterKeys() const { return outer_keys_; }
+
+  AbstractExpressionRef GetInnerPredicate() const { return inner_predicate_; }
+
+  AbstractExpressionRef GetPredicate() const { return predicate_; }
+
+  const std::vector<AbstractExpressionRef> &GetOutputExprs() const { return output_exprs_; }
+
+  std::string inner_table_name_;
+
+  IndexInfo *index_;
+
+  std::vector<AbstractExpressionRef> outer_keys_;
+
+  /** The predicate pushed down to the inner table */
+  AbstractExpressionRef inner_predicate_;
+
+  /** The residual join condition */
+  AbstractExpressionRef predicate_;
+
+  /** The output columns */
+  std::vector<AbstractExpressionRef> output_exprs_;
+};
+
+#endif  // MINISQL_INDEX_NESTED_LOOP_JOIN_PLAN_H
@@ -16,14 +16,24 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_name The identifier of table to be scanned
+   * @param key_predicates For each index, the comparisons it answers in key column order
+   * @param index_only Whether the single index covers every column the query reads
+   * @param probe_groups For each index, the group its row ids are united in, empty when every index is a group
+   * of its own
    */
   IndexScanPlanNode(const Schema *output, std::string table_name, std::vector<IndexInfo *> indexes, bool need_filter,
-                    AbstractExpressionRef filter_predicate = nullptr)
+                    AbstractExpressionRef filter_predicate = nullptr,
+                    std::vector<std::vector<AbstractExpressionRef>> key_predicates = {}, bool index_only = false,
+                    std::vector<uint32_t> probe_groups = {}, bool key_order = false)
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
         indexes_(std::move(indexes)),
         need_filter_(need_filter),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        key_predicates_(std::move(key_predicates)),
+        index_only_(index_only),
+        probe_groups_(std::move(probe_groups)),
+        key_order_(key_order) {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::IndexScan; }
@@ -44,4 +54,19 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   /** The predicate to filter in IndexScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** Equality on a key prefix plus an optional range on the next key column, one list per index*/
+  std::vector<std::vector<AbstractExpressionRef>> key_predicates_;
+
+  /** Rows are built from the index keys alone, the table heap is never read*/
+  bool index_only_ = false;
+
+  /**
+   * The row ids found by the indexes of one group are united, those of the groups intersected, answering an
+   * AND of ORs. The rows are fetched in page order.
+   */
+  std::vector<uint32_t> probe_groups_;
+
+  /** The rows must come out in the order of the key of the single index, not in page order*/
+  bool key_order_ = false;
 };
\ No newline at end of file
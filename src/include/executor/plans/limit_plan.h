@@ -0,0 +1,44 @@
+#ifndef MINISQL_LIMIT_PLAN_H
+#define MINISQL_LIMIT_PLAN_H
+
+#include <limits>
+#include <utility>
+
+#include "abstract_plan.h"
+
+/**
+ * The LimitPlanNode skips the first rows of its child, then passes on at most a number of rows and
+ * stops reading the child.
+ */
+class LimitPlanNode : public AbstractPlanNode {
+ public:
+  static constexpr size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+  /**
+   * Construct a new LimitPlanNode instance.
+   * @param output The output schema of the limit, that of the child
+   * @param child The plan producing the rows
+   * @param offset The number of rows skipped
+   * @param limit The number of rows passed on after them, kNoLimit for all of them
+   */
+  LimitPlanNode(const Schema *output, AbstractPlanNodeRef child, size_t offset, size_t limit)
+      : AbstractPlanNode(output, {std::move(child)}), offset_(offset), limit_(limit) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Limit; }
+
+  /** @return The plan producing the rows */
+  AbstractPlanNodeRef GetChildPlan() const { return GetChildAt(0); }
+
+  size_t GetOffset() const { return offset_; }
+
+  size_t GetLimit() const { return limit_; }
+
+  /** The rows skipped */
+  size_t offset_;
+
+  /** The rows passed on */
+  size_t limit_;
+};
+
+#endif  // MINISQL_LIMIT_PLAN_H
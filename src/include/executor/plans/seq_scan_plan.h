@@ -15,11 +15,14 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * Construct a new SeqScanPlanNode instance.
    * @param output The output schema of this sequential scan plan node
    * @param table_name The identifier of table to be scanned
+   * @param parallel Whether the scan runs on a pool of workers
    */
-  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr)
+  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr,
+                  bool parallel = false)
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        parallel_(parallel) {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::SeqScan; }
@@ -34,6 +37,9 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   /** The predicate to filter in SeqScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** Scan with a ParallelSeqScanExecutor, only for reads, a DML scan stays serial */
+  bool parallel_ = false;
 };
 
 #endif  // MINISQL_SEQ_SCAN_PLAN_H
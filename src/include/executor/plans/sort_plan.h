@@ -0,0 +1,53 @@
+#ifndef MINISQL_SORT_PLAN_H
+#define MINISQL_SORT_PLAN_H
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "planner/expressions/abstract_expression.h"
+
+/** The direction of one key of an order by clause, a null sorts before any value */
+enum class OrderByType { Asc, Desc };
+
+using OrderBy = std::pair<OrderByType, AbstractExpressionRef>;
+
+/**
+ * The SortPlanNode orders the rows of its child on its order by keys, optionally keeping only the
+ * first rows. Its output is the leading columns of the child rows, the columns after them being read
+ * by the keys only.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  static constexpr size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+  /**
+   * Construct a new SortPlanNode instance.
+   * @param output The output schema of the sort, the first columns of the child output
+   * @param child The plan producing the rows to sort
+   * @param order_bys The keys, columns of the child output, compared in order
+   * @param limit The number of rows kept, kNoLimit for all of them
+   */
+  SortPlanNode(const Schema *output, AbstractPlanNodeRef child, std::vector<OrderBy> order_bys,
+               size_t limit = kNoLimit)
+      : AbstractPlanNode(output, {std::move(child)}), order_bys_(std::move(order_bys)), limit_(limit) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return The plan producing the rows to sort */
+  AbstractPlanNodeRef GetChildPlan() const { return GetChildAt(0); }
+
+  const std::vector<OrderBy> &GetOrderBys() const { return order_bys_; }
+
+  size_t GetLimit() const { return limit_; }
+
+  /** The order by keys */
+  std::vector<OrderBy> order_bys_;
+
+  /** The rows kept */
+  size_t limit_;
+};
+
+#endif  // MINISQL_SORT_PLAN_H
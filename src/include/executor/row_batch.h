@@ -0,0 +1,179 @@
+#ifndef MINISQL_ROW_BATCH_H
+#define MINISQL_ROW_BATCH_H
+
+#include <algorithm>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * The values of one column for every row of a batch. Ints and floats are kept in plain arrays so a
+ * filter can run over them directly, chars are packed into one buffer. Nulls are tracked in a bitmap.
+ */
+class ColumnVector {
+ public:
+  explicit ColumnVector(TypeId type) : type_(type) {}
+
+  inline TypeId GetType() const { return type_; }
+
+  inline size_t Size() const { return size_; }
+
+  /** Drop every value, the memory is kept for the next batch. */
+  void Clear();
+
+  /** Append field as the value of the next row, field must have the type of the column. */
+  void Append(const Field &field);
+
+  /** Append a null as the value of the next row. */
+  inline void AppendNull() {
+    NextNullWord();
+    nulls_.back() |= 1ULL << (size_ & 63);
+    switch (type_) {
+      case TypeId::kTypeInt:
+        ints_.push_back(0);
+        break;
+      case TypeId::kTypeFloat:
+        floats_.push_back(0);
+        break;
+      default:
+        offsets_.push_back(chars_.size());
+    }
+    size_++;
+  }
+
+  inline void AppendInt(int32_t value) {
+    NextNullWord();
+    ints_.push_back(value);
+    size_++;
+  }
+
+  inline void AppendFloat(float value) {
+    NextNullWord();
+    floats_.push_back(value);
+    size_++;
+  }
+
+  inline void AppendChars(const char *data, uint32_t length) {
+    NextNullWord();
+    chars_.insert(chars_.end(), data, data + length);
+    offsets_.push_back(chars_.size());
+    size_++;
+  }
+
+  inline bool IsNull(size_t i) const { return (nulls_[i >> 6] >> (i & 63)) & 1; }
+
+  /** Null bitmap, bit i % 64 of word i / 64 is set if row i is null */
+  inline const uint64_t *GetNulls() const { return nulls_.data(); }
+
+  /** Values of an int column, nulls hold 0 */
+  inline const int32_t *GetInts() const { return ints_.data(); }
+
+  /** Values of a float column, nulls hold 0 */
+  inline const float *GetFloats() const { return floats_.data(); }
+
+  inline const char *GetChars(size_t i) const { return chars_.data() + offsets_[i]; }
+
+  inline uint32_t GetCharLength(size_t i) const { return offsets_[i + 1] - offsets_[i]; }
+
+  /** @return a new field holding a copy of the value of row i, the caller owns it */
+  Field *NewField(size_t i) const;
+
+ private:
+  /** Start a new word of the null bitmap when the next row is the first of it */
+  inline void NextNullWord() {
+    if ((size_ & 63) == 0) {
+      nulls_.push_back(0);
+    }
+  }
+
+  TypeId type_;
+  size_t size_{0};
+  std::vector<int32_t> ints_;
+  std::vector<float> floats_;
+  std::vector<char> chars_;
+  /** offsets_[i] to offsets_[i + 1] is the char value of row i */
+  std::vector<uint32_t> offsets_{0};
+  std::vector<uint64_t> nulls_;
+};
+
+/**
+ * Up to EXECUTOR_BATCH_SIZE rows passed between executors by NextBatch(), stored column by column,
+ * or fewer when the parent lowers the capacity of the batch because it needs no more rows.
+ *
+ * A batch holds every column of the rows it was filled with, a scan fills it with table rows, decoding
+ * only the columns its parent and its predicate read.
+ * The projection lists the columns the executor outputs, and the selection vector lists the rows
+ * still alive after filtering. GetRow() materializes a selected row in the output layout,
+ * GetFullRow() with every column, which is what the DML executors need from their child.
+ */
+class RowBatch {
+ public:
+  RowBatch() = default;
+
+  /**
+   * Empty the batch and type its columns after schema, without a schema the first row appended sets them.
+   * @param projection columns of schema in output order, every column if empty
+   */
+  void Reset(const Schema *schema, const std::vector<uint32_t> &projection = {});
+
+  /** Empty the batch, keeping the layout. A batch that was never reset takes the layout of its first row. */
+  void Clear();
+
+  /** Append row with all of its columns, the row is selected. */
+  void Append(const Row &row);
+
+  /**
+   * Append a serialized table row, decoding only the given columns, the row is selected.
+   * The other columns get no value, so only a batch whose projection and filters stay within
+   * columns can be read back, GetFullRow() needs every column.
+   * @param tuple located up to the last of columns
+   */
+  void AppendTuple(const TupleView &tuple, RowId rid, const std::vector<uint32_t> &columns);
+
+  /** Number of rows appended, selected or not */
+  inline size_t Size() const { return row_ids_.size(); }
+
+  inline bool IsFull() const { return Size() >= capacity_; }
+
+  /** Set the rows after which the batch is full, kept by Reset() and Clear() */
+  inline void SetCapacity(size_t capacity) { capacity_ = std::min<size_t>(capacity, EXECUTOR_BATCH_SIZE); }
+
+  inline size_t GetCapacity() const { return capacity_; }
+
+  inline size_t GetColumnCount() const { return columns_.size(); }
+
+  inline const ColumnVector &GetColumn(uint32_t i) const { return columns_[i]; }
+
+  /** @return the column GetRow() puts at position i of a row */
+  inline const ColumnVector &GetOutputColumn(uint32_t i) const { return columns_[projection_[i]]; }
+
+  /** Positions of the selected rows in ascending order, filters shrink it in place */
+  inline std::vector<uint32_t> &GetSelection() { return selection_; }
+
+  inline size_t SelectedCount() const { return selection_.size(); }
+
+  inline RowId GetRowId(size_t i) const { return row_ids_[selection_[i]]; }
+
+  /** Write the projected columns of the i-th selected row to row. */
+  void GetRow(size_t i, Row *row) const;
+
+  /** Write every column of the i-th selected row to row. */
+  void GetFullRow(size_t i, Row *row) const;
+
+ private:
+  void Materialize(uint32_t position, const std::vector<uint32_t> &columns, Row *row) const;
+
+  std::vector<ColumnVector> columns_;
+  std::vector<uint32_t> projection_;
+  std::vector<uint32_t> all_columns_;
+  std::vector<RowId> row_ids_;
+  std::vector<uint32_t> selection_;
+  bool typed_{false};
+  size_t capacity_{EXECUTOR_BATCH_SIZE};
+};
+
+#endif  // MINISQL_ROW_BATCH_H
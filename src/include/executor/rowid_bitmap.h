@@ -0,0 +1,66 @@
+#ifndef MINISQL_ROWID_BITMAP_H
+#define MINISQL_ROWID_BITMAP_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "common/rowid.h"
+
+/**
+ * A compressed set of row ids, for combining the rows several index scans found.
+ *
+ * Row ids are grouped by page. The slots of a page are kept as a sorted array while there are few of
+ * them, and as a bitmap once the array would take more room, so that a set is small whether its rows
+ * are spread over the table or packed in a few pages. Intersection and union go page by page and,
+ * within a page, merge arrays or combine bitmaps a word at a time.
+ *
+ * The row ids are visited in page order, so fetching them reads each heap page once.
+ */
+class RowIdBitmap {
+ public:
+  void Add(const RowId &rid);
+
+  bool Contains(const RowId &rid) const;
+
+  /** Keep only the row ids also in other */
+  void IntersectWith(const RowIdBitmap &other);
+
+  /** Add the row ids of other */
+  void UnionWith(const RowIdBitmap &other);
+
+  /** @return The number of row ids in the set */
+  size_t Size() const { return size_; }
+
+  bool Empty() const { return size_ == 0; }
+
+  /** Append the row ids to rids ordered by page, then by slot */
+  void AppendTo(std::vector<RowId> *rids) const;
+
+ private:
+  /** The slots of one page */
+  struct Container {
+    /** Sorted slots, used while the container is sparse */
+    std::vector<uint16_t> slots;
+    /** One bit per slot, used once the container is dense */
+    std::vector<uint64_t> words;
+    size_t count{0};
+    bool dense{false};
+
+    bool Contains(uint32_t slot) const;
+    void Add(uint32_t slot);
+    /** Switch to the representation taking less room */
+    void Normalize();
+    void ToDense();
+    void Intersect(const Container &other);
+    void Union(const Container &other);
+  };
+
+  /** A sparse container holding more slots than this takes more room than the bitmap of a page */
+  static constexpr size_t kSparseLimit = 32;
+
+  std::map<page_id_t, Container> pages_;
+  size_t size_{0};
+};
+
+#endif  // MINISQL_ROWID_BITMAP_H
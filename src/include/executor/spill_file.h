@@ -0,0 +1,83 @@
+#ifndef MINISQL_SPILL_FILE_H
+#define MINISQL_SPILL_FILE_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * A sequence of rows kept on temporary pages of the buffer pool, for an executor whose input does not
+ * fit in its memory budget.
+ *
+ * Rows are serialized one after the other as a byte stream running over the pages, so a row may be
+ * larger than a page. Only the page being written or read is pinned. The pages are deleted with the file.
+ */
+class SpillFile {
+ public:
+  /**
+   * @param bpm The buffer pool the pages are taken from
+   * @param schema The schema of the rows, used to serialize them, nullptr for a file of records
+   */
+  SpillFile(BufferPoolManager *bpm, const Schema *schema);
+
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  /** Write row after the rows already in the file. Not allowed once reading started. */
+  void Append(const Row &row);
+
+  /** Start reading from the first row, ends the writing. */
+  void Rewind();
+
+  /**
+   * Read the next row.
+   * @return false when every row was read
+   */
+  bool Read(Row *row);
+
+  /**
+   * Write a record of size raw bytes, for a caller encoding its own records instead of rows. A file holds
+   * either rows or records.
+   */
+  void AppendRecord(const char *data, size_t size);
+
+  /**
+   * Read the next record into data, which takes the size it was written with.
+   * @return false when every record was read
+   */
+  bool ReadRecord(char *data, size_t size);
+
+  /** @return The number of rows written */
+  size_t GetRowCount() const { return row_count_; }
+
+  /** @return The bytes of the rows written, as serialized */
+  size_t GetByteSize() const { return byte_size_; }
+
+ private:
+  void Write(const char *data, size_t size);
+
+  void ReadBytes(char *data, size_t size);
+
+  /** Pin page index of the file for reading or writing, unpinning the one pinned before */
+  void Pin(size_t index, bool dirty);
+
+  BufferPoolManager *bpm_;
+  Schema *schema_;
+  std::vector<page_id_t> pages_;
+  /** The pinned page, pages_.size() if none */
+  size_t pinned_{0};
+  char *data_{nullptr};
+  /** Offset of the next byte written or read in the pinned page */
+  size_t offset_{0};
+  bool reading_{false};
+  size_t row_count_{0};
+  size_t byte_size_{0};
+  size_t rows_read_{0};
+  std::vector<char> buffer_;
+};
+
+#endif  // MINISQL_SPILL_FILE_H
@@ -0,0 +1,61 @@
+#ifndef MINISQL_ART_INDEX_H
+#define MINISQL_ART_INDEX_H
+
+#include <functional>
+#include <vector>
+
+#include "index/generic_key.h"
+#include "index/index.h"
+
+struct ArtNode;
+struct ArtLeaf;
+
+/**
+ * Adaptive radix tree over the normalized key bytes, kept entirely in memory. An inner node starts
+ * with room for 4 children and grows to 16, 48 and 256 as it fills, key bytes shared by all keys
+ * below a node are folded into its prefix. A point lookup visits one node per byte at which the
+ * keys branch and never goes through the buffer pool.
+ *
+ * Nothing is written to disk, the catalog rebuilds the tree from the table heap when it loads the
+ * index. Like the B+ tree it keeps its keys in order and answers every comparison of ScanKey.
+ */
+class ArtIndex : public Index {
+ public:
+  /**
+   * @param key_size width of the normalized key, plus the row id appended to every key of a
+   *                 non-unique index
+   */
+  ArtIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, bool unique = true);
+
+  ~ArtIndex() override;
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                  std::string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+ private:
+  // the leaf holding exactly this key, nullptr if there is none
+  const ArtLeaf *Lookup(const char *key) const;
+
+  // the node every key starting with key[0, length) lives under, nullptr if there is no such key
+  const ArtNode *LookupPrefix(const char *key, uint32_t length) const;
+
+  // false if the tree already holds the key of leaf
+  bool Insert(ArtNode *&node, ArtLeaf *leaf, uint32_t depth);
+
+  bool Remove(ArtNode *&node, const char *key, uint32_t depth);
+
+  // visit the leaves below node in key order until visit returns false, false if it did
+  bool ForEach(const ArtNode *node, const std::function<bool(const ArtLeaf *)> &visit) const;
+
+ private:
+  KeyManager processor_;
+  ArtNode *root_{nullptr};
+};
+
+#endif  // MINISQL_ART_INDEX_H
@@ -1,8 +1,10 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <functional>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "index/index_iterator.h"
@@ -16,7 +18,8 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key, a non-unique index makes its keys unique by
+ *     appending the row id (see KeyManager::SetKeyRowId)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -29,15 +32,37 @@ public:
     explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &comparator,
                        int leaf_max_size = 0, int internal_max_size = 0);
 
+    ~BPlusTree();
+
     // Returns true if this B+ tree has no keys and values.
     bool IsEmpty() const;
 
     // Insert a key-value pair into this B+ tree.
     bool Insert(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
+    // Build an empty tree bottom-up from entries sorted by key, filling each page to fill_factor.
+    bool BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries, double fill_factor = INDEX_FILL_FACTOR);
+
+    // The same from count entries next hands out in key order, a key only has to stay valid until the next
+    // call. next returns false to give the build up, the pages written so far are freed and the tree stays empty.
+    bool BulkLoad(size_t count, const std::function<bool(std::pair<GenericKey *, RowId> *)> &next,
+                  double fill_factor = INDEX_FILL_FACTOR);
+
     // Remove a key and its value from this B+ tree.
     void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
+    // Repack a tree thinned out by lazy deletes, filling each page to fill_factor.
+    bool Vacuum(double fill_factor = INDEX_FILL_FACTOR);
+
+    // With lazy deletes pages are only merged below INDEX_MERGE_LOW_WATER instead of half full.
+    void SetLazyDelete(bool lazy_delete) { lazy_delete_ = lazy_delete; }
+
+    // Keep the internal pages of the top levels of the tree pinned, 0 leaves every page to the buffer pool.
+    void SetPinnedLevels(int levels) {
+        ReleaseUpperLevels();
+        pinned_levels_ = levels;
+    }
+
     // return the value associated with a given key
     bool GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction = nullptr);
 
@@ -95,8 +120,14 @@ public:
 
     bool AdjustRoot(BPlusTreePage *node);
 
+    int MergeThreshold(BPlusTreePage *page) const;
+
     void UpdateRootPageId(int insert_record = 0) const;
 
+    void PinUpperLevels();
+
+    void ReleaseUpperLevels();
+
     /* Debug Routines for FREE!! */
     void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -109,6 +140,11 @@ public:
     KeyManager processor_;
     int leaf_max_size_;
     int internal_max_size_;
+    bool lazy_delete_{INDEX_LAZY_DELETE};
+    int pinned_levels_{INDEX_PINNED_LEVELS};
+    // frames of the pinned upper pages by page id, rebuilt on the next lookup after the shape changes
+    std::unordered_map<page_id_t, Page *> pinned_pages_;
+    bool upper_levels_pinned_{false};
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
\ No newline at end of file
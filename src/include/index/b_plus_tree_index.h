@@ -2,21 +2,55 @@
 #define MINISQL_B_PLUS_TREE_INDEX_H
 
 #include "index/b_plus_tree.h"
+#include "index/bloom_filter.h"
 #include "index/generic_key.h"
 #include "index/index.h"
 
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param unique false to allow several entries with the same key, the row id is then appended to
+   *               every key and key_size must leave room for it
+   */
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  /**
+   * Sort the keys and build the whole tree bottom-up, the tree must still be empty.
+   * Fails without touching the tree if two rows share a key.
+   */
+  dberr_t BulkLoad(const std::vector<uint32_t> &key_map, const std::function<const Row *()> &next,
+                   Transaction *txn) override;
+
+  /**
+   * The same, sorting at most memory_budget bytes of keys at a time: beyond that the keys are sorted in runs
+   * spilled to temporary pages, which are merged as the tree is built.
+   */
+  dberr_t BulkLoad(const std::vector<uint32_t> &key_map, const std::function<const Row *()> &next,
+                   Transaction *txn, size_t memory_budget);
+
+  using Index::BulkLoad;
+
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
 
+  /**
+   * Range scan over a leading part of a composite key: collect every entry whose first key_prefix.size()
+   * columns equal key_prefix, optionally bounded on the column that follows the prefix.
+   * If key_rows is given, the key of every entry is decoded into it as well, in the order of result.
+   */
+  dberr_t ScanPrefix(const std::vector<Field> &key_prefix, std::vector<RowId> &result, Transaction *txn,
+                     const Field *lower = nullptr, bool lower_inclusive = true, const Field *upper = nullptr,
+                     bool upper_inclusive = true, std::vector<Row> *key_rows = nullptr);
+
   dberr_t Destroy() override;
 
+  // repack the pages left sparse by lazy deletes, see BPlusTree::Vacuum
+  dberr_t Vacuum(Transaction *txn);
+
   IndexIterator GetBeginIterator();
 
   IndexIterator GetBeginIterator(GenericKey *key);
@@ -24,10 +58,28 @@ class BPlusTreeIndex : public Index {
   IndexIterator GetEndIterator();
 
  protected:
+  using Entry = std::pair<GenericKey *, RowId>;
+
+  // sort entries by key, in several threads when there are many
+  void SortEntries(std::vector<Entry> *entries) const;
+
+  // false if the index surely holds no entry with the key columns of key
+  bool MayContain(const GenericKey *key);
+
+  // size the filter for twice the current entries and add the key of every leaf entry
+  void BuildFilter();
+
+  // pages of the sorted runs of a bulk load that does not fit in memory
+  BufferPoolManager *buffer_pool_manager_;
   // comparator for key
   KeyManager processor_;
   // container
   BPlusTree container_;
+  // equality probes that miss skip the tree descent, built on the first probe after the index is loaded
+  BloomFilter filter_;
+  bool filter_ready_{false};
+  size_t filter_entries_{0};
+  size_t filter_removed_{0};
 };
 
 #endif  // MINISQL_B_PLUS_TREE_INDEX_H
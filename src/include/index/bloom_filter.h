@@ -0,0 +1,43 @@
+#ifndef MINISQL_BLOOM_FILTER_H
+#define MINISQL_BLOOM_FILTER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * Blocked Bloom filter over 64-bit key hashes. The high half of a hash picks one 32-byte block, the
+ * low half sets one bit in each of its eight words, so a probe touches a single cache line.
+ *
+ * Keys can only be added. A filter that has seen many deletes answers "maybe" more often than it
+ * needs to and should be rebuilt.
+ */
+class BloomFilter {
+ public:
+  BloomFilter() = default;
+
+  /**
+   * @param capacity number of keys the filter is sized for, more keys raise the false positive rate
+   */
+  explicit BloomFilter(size_t capacity, uint32_t bits_per_key = INDEX_BLOOM_BITS_PER_KEY);
+
+  void Insert(uint64_t hash);
+
+  // false only if no key with this hash was ever inserted
+  bool MayContain(uint64_t hash) const;
+
+  size_t GetCapacity() const { return capacity_; }
+
+ private:
+  using Block = std::array<uint32_t, 8>;
+
+  // maps the high half of hash onto the blocks without a division
+  size_t BlockIndex(uint64_t hash) const { return ((hash >> 32) * blocks_.size()) >> 32; }
+
+  std::vector<Block> blocks_;
+  size_t capacity_{0};
+};
+
+#endif  // MINISQL_BLOOM_FILTER_H
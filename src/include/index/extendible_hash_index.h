@@ -0,0 +1,67 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_INDEX_H
+#define MINISQL_EXTENDIBLE_HASH_INDEX_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/generic_key.h"
+#include "index/index.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+
+/**
+ * Disk resident extendible hash index. Only answers equality on the whole key,
+ * in return a lookup fetches one directory segment and one bucket page however
+ * many entries the index holds. The directory page itself is read once when the
+ * index is opened and kept in memory, every change is written through.
+ */
+class ExtendibleHashIndex : public Index {
+  using BucketPage = HashTableBucketPage;
+  using DirectoryPage = HashTableDirectoryPage;
+
+ public:
+  /**
+   * @param key_size width of the normalized key columns, no row id is appended to the keys
+   * @param unique false to allow several entries with the same key
+   */
+  ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
+                      BufferPoolManager *buffer_pool_manager, bool unique = true);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  // only "=" is supported, a hash keeps no key order
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+ private:
+  // create the directory, one segment and an empty bucket of depth 0
+  bool StartNewDirectory();
+
+  page_id_t GetBucketPageId(uint32_t hash);
+
+  void SetBucketPageId(uint32_t directory_index, page_id_t bucket_page_id);
+
+  // double the directory, every new entry points where its lower twin points
+  bool GrowDirectory();
+
+  // whether splitting the bucket can separate its keys, and the new key, by one more hash bit
+  bool CanSplit(BucketPage *bucket, uint32_t hash);
+
+  bool SplitBucket(BucketPage *bucket, uint32_t hash);
+
+  void FlushDirectory();
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  KeyManager processor_;
+  bool unique_;
+  page_id_t directory_page_id_{INVALID_PAGE_ID};
+  // in memory copy of the directory page
+  uint32_t global_depth_{0};
+  std::vector<page_id_t> segment_page_ids_;
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_INDEX_H
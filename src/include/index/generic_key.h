@@ -2,7 +2,9 @@
 #define MINISQL_GENERIC_KEY_H
 
 #include <cstring>
+#include <vector>
 
+#include "common/rowid.h"
 #include "record/field.h"
 #include "record/row.h"
 
@@ -11,6 +13,22 @@ class GenericKey {
     char data[0];
 };
 
+/**
+ * KeyManager stores keys in a normalized form: every column is encoded at a fixed width so that
+ * the bytes of two keys compare (memcmp) in the same order as the rows they hold.
+ *   - 1 byte null flag (0 for null, so null sorts before any value)
+ *   - int: 4 bytes big endian with the sign bit flipped
+ *   - float: 4 bytes big endian, bits flipped so negative values order correctly
+ *   - char(n): n bytes zero padded, followed by the 2 byte big endian length
+ * A key slot is exactly as wide as its encoded columns, instead of a full serialized Row
+ * (field count, null bitmap and a 4 byte length per string) rounded up to a power of two.
+ *
+ * This is the whole of the key compression: a char(64) key takes 67 bytes against 128, which
+ * nearly doubles the entries of a page (53 against 28 in a leaf). Keys are not prefix compressed
+ * within a page and separators are not truncated, since B+ tree pages hand out KeyAt pointers
+ * into fixed-size slots and size their splits and merges by entry count; both would need a
+ * variable-length page format.
+ */
 class KeyManager {
 public: /**/
     [[nodiscard]] inline GenericKey *InitKey() const {
@@ -19,56 +37,182 @@ public: /**/
 
     inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
         // initialize to 0
-        [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema);
         ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-        ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
+        ASSERT(GetEncodedSize(schema) <= (uint32_t)GetFieldsSize(), "Index key size exceed max key size.");
         memset(key_buf->data, 0, key_size_);
-        key.SerializeTo(key_buf->data, schema);
+        char *buf = key_buf->data;
+        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+            buf += EncodeField(buf, *key.GetField(i), schema->GetColumn(i));
+        }
+    }
+
+    // encode the key held in the columns key_map of a table row, without building a key row first
+    inline void SerializeFromRow(GenericKey *key_buf, const Row &row, const std::vector<uint32_t> &key_map,
+                                 Schema *schema) const {
+        ASSERT(key_map.size() == schema->GetColumnCount(), "field nums not match.");
+        memset(key_buf->data, 0, key_size_);
+        char *buf = key_buf->data;
+        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+            buf += EncodeField(buf, *row.GetField(key_map[i]), schema->GetColumn(i));
+        }
+    }
+
+    /**
+     * Keys of a non-unique index end with the row id of their entry, which makes every entry distinct.
+     * Searching with INVALID_ROWID positions in front of all entries sharing the key.
+     */
+    inline void SetKeyRowId(GenericKey *key_buf, const RowId &rid) const {
+        if (!unique_) {
+            WriteBigEndian(key_buf->data + GetFieldsSize(), static_cast<uint64_t>(rid.Get()) ^ (1ULL << 63), 8);
+        }
+    }
+
+    inline RowId GetKeyRowId(const GenericKey *key_buf) const {
+        uint64_t value = ReadBigEndian(key_buf->data + GetFieldsSize(), 8) ^ (1ULL << 63);
+        return RowId(static_cast<int64_t>(value));
     }
 
     inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-        [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
-        ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
+        std::vector<Field> fields;
+        const char *buf = key_buf->data;
+        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+            buf += DecodeField(buf, fields, schema->GetColumn(i));
+        }
+        ASSERT(buf - key_buf->data <= key_size_, "Index key size exceed max key size.");
+        RowId rid = key.GetRowId();
+        key = Row(fields);
+        key.SetRowId(rid);
     }
 
     // compare
     [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-        //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-        uint32_t column_count = key_schema_->GetColumnCount();
-        Row lhs_key(INVALID_ROWID);
-        Row rhs_key(INVALID_ROWID);
-        DeserializeToKey(lhs, lhs_key, key_schema_);
-        DeserializeToKey(rhs, rhs_key, key_schema_);
-
-        for (uint32_t i = 0; i < column_count; i++) {
-            Field *lhs_value = lhs_key.GetField(i);
-            Field *rhs_value = rhs_key.GetField(i);
-
-            if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-                return -1;
-            }
+        // the row id of a non-unique key is encoded to keep the byte order as well
+        return memcmp(lhs->data, rhs->data, key_size_);
+    }
 
-            if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-                return 1;
-            }
+    // compare the key columns only, ignoring the row id of a non-unique key
+    [[nodiscard]] inline int CompareKeyFields(const GenericKey *lhs, const GenericKey *rhs) const {
+        return memcmp(lhs->data, rhs->data, GetFieldsSize());
+    }
+
+    // hash of the key columns, equal keys have equal bytes and so hash alike
+    [[nodiscard]] inline uint32_t HashKeyFields(const GenericKey *key) const {
+        return static_cast<uint32_t>(HashKeyFields64(key));
+    }
+
+    [[nodiscard]] inline uint64_t HashKeyFields64(const GenericKey *key) const {
+        // FNV-1a, finished with the murmur3 mix so the low bits a hash directory uses are well spread
+        uint64_t hash = 14695981039346656037ULL;
+        for (int i = 0; i < GetFieldsSize(); i++) {
+            hash ^= static_cast<uint8_t>(key->data[i]);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /** @return bytes taken by the normalized key columns of schema */
+    static inline uint32_t GetEncodedSize(Schema *schema) {
+        uint32_t size = 0;
+        for (auto column : schema->GetColumns()) {
+            size += GetEncodedSize(column);
         }
-        // equals
-        return 0;
+        return size;
     }
 
     inline int GetKeySize() const { return key_size_; }
     inline Schema * GetSchema() const { return key_schema_; }//
+    inline bool IsUnique() const { return unique_; }
     KeyManager(const KeyManager &other) {
         this->key_schema_ = other.key_schema_;
         this->key_size_ = other.key_size_;
+        this->unique_ = other.unique_;
     }
 
     // constructor
-    KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+    KeyManager(Schema *key_schema, size_t key_size, bool unique = true)
+        : key_size_(key_size), key_schema_(key_schema), unique_(unique) {}
+
+    // bytes available to the key columns
+    inline int GetFieldsSize() const { return unique_ ? key_size_ : key_size_ - (int)sizeof(int64_t); }
 
 private:
+    static inline uint32_t GetEncodedSize(const Column *column) {
+        return 1 + (column->GetType() == TypeId::kTypeChar ? column->GetLength() + 2 : 4);
+    }
+
+    static inline void WriteBigEndian(char *buf, uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; i--) {
+            buf[i] = static_cast<char>(value & 0xff);
+            value >>= 8;
+        }
+    }
+
+    static inline uint64_t ReadBigEndian(const char *buf, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value = (value << 8) | static_cast<uint8_t>(buf[i]);
+        }
+        return value;
+    }
+
+    static inline uint32_t EncodeField(char *buf, const Field &field, const Column *column) {
+        uint32_t size = GetEncodedSize(column);
+        if (field.IsNull()) {
+            return size;
+        }
+        buf[0] = 1;
+        if (column->GetType() == TypeId::kTypeChar) {
+            uint32_t len = field.GetLength();
+            ASSERT(len <= column->GetLength(), "Index key size exceed max key size.");
+            memcpy(buf + 1, field.GetData(), len);
+            WriteBigEndian(buf + 1 + column->GetLength(), len, 2);
+            return size;
+        }
+        uint32_t bits;
+        field.SerializeTo(reinterpret_cast<char *>(&bits));
+        if (column->GetType() == TypeId::kTypeInt) {
+            bits ^= 0x80000000u;
+        } else {
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            if (value == 0.0f) {
+                bits = 0;  // -0.0 equals 0.0
+            }
+            bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        }
+        WriteBigEndian(buf + 1, bits, 4);
+        return size;
+    }
+
+    static inline uint32_t DecodeField(const char *buf, std::vector<Field> &fields, const Column *column) {
+        uint32_t size = GetEncodedSize(column);
+        if (buf[0] == 0) {
+            fields.emplace_back(column->GetType());
+            return size;
+        }
+        if (column->GetType() == TypeId::kTypeChar) {
+            uint32_t len = ReadBigEndian(buf + 1 + column->GetLength(), 2);
+            fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(buf + 1), len, true);
+            return size;
+        }
+        uint32_t bits = ReadBigEndian(buf + 1, 4);
+        if (column->GetType() == TypeId::kTypeInt) {
+            fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(bits ^ 0x80000000u));
+        } else {
+            bits = (bits & 0x80000000u) ? (bits & 0x7fffffffu) : ~bits;
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            fields.emplace_back(TypeId::kTypeFloat, value);
+        }
+        return size;
+    }
+
     int key_size_;
     Schema *key_schema_;
+    bool unique_;
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
@@ -1,7 +1,11 @@
 #ifndef MINISQL_INDEX_H
 #define MINISQL_INDEX_H
 
+#include <functional>
 #include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include "common/dberr.h"
 #include "record/row.h"
@@ -15,10 +19,34 @@ class Index {
 
   virtual dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
+  // add the entries of a whole table at once: next hands out the rows, each carrying its row id, and nullptr
+  // after the last one, column key_map[i] of a row is column i of its key
+  virtual dberr_t BulkLoad(const std::vector<uint32_t> &key_map, const std::function<const Row *()> &next,
+                           Transaction *txn) {
+    for (auto row = next(); row != nullptr; row = next()) {
+      std::vector<Field> fields;
+      for (auto col : key_map) {
+        fields.emplace_back(*row->GetField(col));
+      }
+      if (InsertEntry(Row(fields), row->GetRowId(), txn) != DB_SUCCESS) {
+        return DB_FAILED;
+      }
+    }
+    return DB_SUCCESS;
+  }
+
+  // add the entries of key rows, every key row carries the row id of its entry
+  dberr_t BulkLoad(const std::vector<Row> &key_rows, Transaction *txn) {
+    std::vector<uint32_t> key_map(key_schema_->GetColumnCount());
+    std::iota(key_map.begin(), key_map.end(), 0);
+    size_t i = 0;
+    return BulkLoad(key_map, [&key_rows, &i]() { return i < key_rows.size() ? &key_rows[i++] : nullptr; }, txn);
+  }
+
   virtual dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
-                          string compare_operator = "=") = 0;
+                          std::string compare_operator = "=") = 0;
 
   virtual dberr_t Destroy() = 0;
 
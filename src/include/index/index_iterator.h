@@ -12,6 +12,10 @@ class IndexIterator {
 
   explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0);
 
+  IndexIterator(const IndexIterator &) = delete;
+
+  IndexIterator &operator=(const IndexIterator &) = delete;
+
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
@@ -27,6 +31,8 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  void SkipExhaustedPages();
+
   page_id_t current_page_id{INVALID_PAGE_ID};
   LeafPage *page{nullptr};
   int item_index{0};
@@ -0,0 +1,68 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "index/generic_key.h"
+
+#define HASH_BUCKET_PAGE_HEADER_SIZE 16
+
+/**
+ * hash_table_bucket_page.h
+ *
+ * One bucket of an extendible hash index. Entries are kept unordered, a removed
+ * entry is replaced by the last one. A bucket whose keys can not be told apart by
+ * the directory any more links overflow buckets through NextPageId.
+ *
+ * Bucket page format:
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 16 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | KeySize (4) | LocalDepth (4) | CurrentSize (4) | NextPageId (4) |
+ *  ---------------------------------------------------------------------
+ */
+class HashTableBucketPage {
+ public:
+  // must call initialize method after "create" a new bucket
+  void Init(int key_size, uint32_t local_depth);
+
+  uint32_t GetLocalDepth() const { return local_depth_; }
+
+  void SetLocalDepth(uint32_t local_depth) { local_depth_ = local_depth; }
+
+  int GetSize() const { return size_; }
+
+  int GetMaxSize() const { return (PAGE_SIZE - HASH_BUCKET_PAGE_HEADER_SIZE) / (key_size_ + sizeof(RowId)); }
+
+  bool IsFull() const { return size_ >= GetMaxSize(); }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  GenericKey *KeyAt(int index);
+
+  RowId ValueAt(int index) const;
+
+  // append an entry, false if the bucket is full
+  bool Insert(const GenericKey *key, const RowId &value);
+
+  // drop the entry at index, the last entry takes its place
+  void RemoveAt(int index);
+
+ private:
+  char *PairPtrAt(int index) { return data_ + index * (key_size_ + sizeof(RowId)); }
+
+  const char *PairPtrAt(int index) const { return data_ + index * (key_size_ + sizeof(RowId)); }
+
+  int key_size_;
+  uint32_t local_depth_;
+  int size_;
+  page_id_t next_page_id_;
+  char data_[PAGE_SIZE - HASH_BUCKET_PAGE_HEADER_SIZE];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
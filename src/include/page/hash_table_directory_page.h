@@ -0,0 +1,48 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+#include "common/config.h"
+
+/**
+ * hash_table_directory_page.h
+ *
+ * Root page of an extendible hash index, its page id is kept in the index roots
+ * page. The directory maps the low GlobalDepth bits of a key hash to a bucket
+ * page. Its 2^GlobalDepth entries are spread over segment pages, each of them a
+ * plain array of DIRECTORY_SEGMENT_SIZE bucket page ids; entry i lives in
+ * segment i / DIRECTORY_SEGMENT_SIZE.
+ *
+ * Directory page format (size in byte):
+ *  ------------------------------------------------------------------------------
+ * | GlobalDepth (4) | SegmentCount (4) | Segment_1 page_id (4) | ... |
+ *  ------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  static constexpr uint32_t DIRECTORY_SEGMENT_SIZE = PAGE_SIZE / sizeof(page_id_t);
+  static constexpr uint32_t MAX_SEGMENT_COUNT = 512;
+  // 2^MAX_GLOBAL_DEPTH == DIRECTORY_SEGMENT_SIZE * MAX_SEGMENT_COUNT
+  static constexpr uint32_t MAX_GLOBAL_DEPTH = 19;
+
+  void Init() {
+    global_depth_ = 0;
+    segment_count_ = 0;
+  }
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  void SetGlobalDepth(uint32_t global_depth) { global_depth_ = global_depth; }
+
+  uint32_t GetSegmentCount() const { return segment_count_; }
+
+  page_id_t GetSegmentPageId(uint32_t index) const { return segment_page_ids_[index]; }
+
+  void AddSegment(page_id_t page_id) { segment_page_ids_[segment_count_++] = page_id; }
+
+ private:
+  uint32_t global_depth_;
+  uint32_t segment_count_;
+  page_id_t segment_page_ids_[MAX_SEGMENT_COUNT];
+};
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
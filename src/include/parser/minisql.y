@@ -7,6 +7,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -17,14 +19,17 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> VACUUM GROUP BY ORDER ASC DESC LIMIT OFFSET ANALYZE
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
 %type <syntax_node> sql_show_tables sql_create_table sql_drop_table
 %type <syntax_node> column_definition_list column_definition column_type column_list
-%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
+%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes sql_vacuum_index sql_analyze
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
-%type <syntax_node> sql_select select_columns column_values column_value operator
+%type <syntax_node> sql_select select_columns select_list select_item table_list column_ref column_ref_list
+%type <syntax_node> column_values column_value operator where_clause group_by_clause
+%type <syntax_node> order_by_clause order_list order_item limit_clause
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
 %type <syntax_node> sql_quit sql_exec_file
@@ -49,6 +54,8 @@ sql:
   | sql_create_index { $$ = $1; }
   | sql_drop_index { $$ = $1; }
   | sql_show_indexes { $$ = $1; }
+  | sql_vacuum_index { $$ = $1; }
+  | sql_analyze { $$ = $1; }
   | sql_select { $$ = $1; }
   | sql_insert { $$ = $1; }
   | sql_delete { $$ = $1; }
@@ -195,19 +202,120 @@ sql_show_indexes:
   }
   ;
 
+sql_vacuum_index:
+  VACUUM INDEX IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeVacuumIndex, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+sql_analyze:
+  ANALYZE {
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+  }
+  | ANALYZE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
 sql_select:
-  SELECT select_columns FROM IDENTIFIER {
+  SELECT select_columns FROM table_list where_clause group_by_clause order_by_clause limit_clause {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
+    if ($5 != NULL) {
+      SyntaxNodeAddChildren($$, $5);
+    }
+    if ($6 != NULL) {
+      SyntaxNodeAddChildren($$, $6);
+    }
+    if ($7 != NULL) {
+      SyntaxNodeAddChildren($$, $7);
+    }
+    if ($8 != NULL) {
+      SyntaxNodeAddChildren($$, $8);
+    }
   }
-  | SELECT select_columns FROM IDENTIFIER WHERE where_conditions {
-    $$ = CreateSyntaxNode(kNodeSelect, NULL);
+  ;
+
+where_clause:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | WHERE where_conditions {
+    $$ = CreateSyntaxNode(kNodeConditions, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+group_by_clause:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | GROUP BY column_ref_list {
+    $$ = CreateSyntaxNode(kNodeGroupBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+order_by_clause:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | ORDER BY order_list {
+    $$ = CreateSyntaxNode(kNodeOrderBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+order_list:
+  order_item ',' order_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | order_item {
+    $$ = $1;
+  }
+  ;
+
+order_item:
+  select_item {
+    $$ = CreateSyntaxNode(kNodeOrderItem, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_item ASC {
+    $$ = CreateSyntaxNode(kNodeOrderItem, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_item DESC {
+    $$ = CreateSyntaxNode(kNodeOrderItem, "desc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  ;
+
+limit_clause:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | LIMIT NUMBER {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | LIMIT NUMBER OFFSET NUMBER {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
     SyntaxNodeAddChildren($$, $2);
     SyntaxNodeAddChildren($$, $4);
-    pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
-    SyntaxNodeAddChildren(condition_node, $6);
-    SyntaxNodeAddChildren($$, condition_node);
+  }
+  ;
+
+table_list:
+  IDENTIFIER ',' table_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | IDENTIFIER {
+    $$ = $1;
   }
   ;
 
@@ -215,12 +323,58 @@ select_columns:
   '*' {
     $$ = CreateSyntaxNode(kNodeAllColumns, NULL);
   }
-  | column_list {
+  | select_list {
     $$ = CreateSyntaxNode(kNodeColumnList, "select columns");
     SyntaxNodeAddChildren($$, $1);
   }
   ;
 
+select_list:
+  select_item ',' select_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | select_item {
+    $$ = $1;
+  }
+  ;
+
+select_item:
+  column_ref {
+    $$ = $1;
+  }
+  | IDENTIFIER '(' '*' ')' {
+    /* count(*), the function is named by an identifier and checked by the planner */
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+  }
+  | IDENTIFIER '(' column_ref ')' {
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+column_ref_list:
+  column_ref ',' column_ref_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | column_ref {
+    $$ = $1;
+  }
+  ;
+
+column_ref:
+  IDENTIFIER {
+    $$ = $1;
+  }
+  | IDENTIFIER '.' IDENTIFIER {
+    /* kept as the single identifier "table.column", the planner resolves it */
+    char name[256];
+    snprintf(name, sizeof(name), "%s.%s", $1->val_, $3->val_);
+    $$ = CreateSyntaxNode(kNodeIdentifier, name);
+  }
+  ;
+
 where_conditions:
   where_conditions connector where_condition  {
     $$ = $2;
@@ -242,7 +396,12 @@ connector:
   ;
 
 where_condition:
-  IDENTIFIER operator column_value {
+  column_ref operator column_value {
+    $$ = $2;
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | column_ref operator column_ref {
     $$ = $2;
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
@@ -41,9 +41,16 @@ typedef enum {
   kNodeCreateIndex,          /** create index command */
   kNodeDropIndex,            /** drop index command */
   kNodeIndexType,            /** type of index */
+  kNodeVacuumIndex,          /** vacuum index command */
   kNodeTrxBegin,             /** begin transaction command */
   kNodeTrxCommit,            /** commit transaction command */
-  kNodeTrxRollback           /** rollback transaction command */
+  kNodeTrxRollback,          /** rollback transaction command */
+  kNodeAggregate,            /** aggregate function in select, named by its value, the column as child unless '*' */
+  kNodeGroupBy,              /** group by clause, contains the grouping columns */
+  kNodeOrderBy,              /** order by clause, contains the order items */
+  kNodeOrderItem,            /** one key of an order by clause, 'asc' or 'desc' as value, the column as child */
+  kNodeLimit,                /** limit clause, the row count as child, followed by the offset if given */
+  kNodeAnalyze               /** analyze command, the table as child, every table without one */
 } SyntaxNodeType;
 
 /**
@@ -14,7 +14,13 @@
 class AbstractExpression;
 using AbstractExpressionRef = std::shared_ptr<AbstractExpression>;
 
-enum class ExpressionType { LogicExpression = 0, ComparisonExpression, ColumnExpression, ConstantExpression };
+enum class ExpressionType {
+  LogicExpression = 0,
+  ComparisonExpression,
+  ColumnExpression,
+  ConstantExpression,
+  AggregateExpression
+};
 
 /**
  * AbstractExpression is the base class of all the expressions in the system.
@@ -0,0 +1,55 @@
+#ifndef MINISQL_AGGREGATE_EXPRESSION_H
+#define MINISQL_AGGREGATE_EXPRESSION_H
+
+#include <stdexcept>
+#include <utility>
+
+#include "abstract_expression.h"
+
+/** The aggregate functions of the SELECT list. */
+enum class AggregationType { CountStar, Count, Sum, Min, Max, Avg };
+
+/**
+ * AggregateExpression represents an aggregate function over the rows of a group, e.g. sum(column).
+ * It has no value on a single row: the aggregation executor computes it.
+ */
+class AggregateExpression : public AbstractExpression {
+ public:
+  /**
+   * @param agg_type The aggregate function
+   * @param arg The expression aggregated, nullptr for count(*)
+   */
+  AggregateExpression(AggregationType agg_type, AbstractExpressionRef arg)
+      : AbstractExpression(arg == nullptr ? std::vector<AbstractExpressionRef>{}
+                                          : std::vector<AbstractExpressionRef>{arg},
+                           ResultType(agg_type, arg), ExpressionType::AggregateExpression),
+        agg_type_(agg_type) {}
+
+  Field Evaluate(const Row *) const override {
+    throw std::logic_error("an aggregate has no value on a single row");
+  }
+
+  Field EvaluateJoin(const Row *, const Row *) const override {
+    throw std::logic_error("an aggregate has no value on a single row");
+  }
+
+  AggregationType GetAggregationType() const { return agg_type_; }
+
+ private:
+  /** Counts are ints, an average is a float, the other aggregates keep the type of their argument */
+  static TypeId ResultType(AggregationType agg_type, const AbstractExpressionRef &arg) {
+    switch (agg_type) {
+      case AggregationType::CountStar:
+      case AggregationType::Count:
+        return TypeId::kTypeInt;
+      case AggregationType::Avg:
+        return TypeId::kTypeFloat;
+      default:
+        return arg->GetReturnType();
+    }
+  }
+
+  AggregationType agg_type_;
+};
+
+#endif  // MINISQL_AGGREGATE_EXPRESSION_H
@@ -5,12 +5,19 @@
 #ifndef MINISQL_PLANNER_H
 #define MINISQL_PLANNER_H
 
+#include <functional>
+
 #include "common/instance.h"
 #include "executor/plans/abstract_plan.h"
+#include "executor/plans/aggregation_plan.h"
 #include "executor/plans/delete_plan.h"
+#include "executor/plans/hash_join_plan.h"
+#include "executor/plans/index_nested_loop_join_plan.h"
 #include "executor/plans/index_scan_plan.h"
 #include "executor/plans/insert_plan.h"
+#include "executor/plans/limit_plan.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "executor/plans/sort_plan.h"
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
 #include "planner/statement/abstract_statement.h"
@@ -34,12 +41,135 @@ class Planner {
 
   AbstractPlanNodeRef PlanSelect(std::shared_ptr<SelectStatement> statement);
 
+  /**
+   * Plan a select with aggregates or a group by clause: an aggregation over the select of the columns
+   * the group by clause and the aggregates read, planned as any other select.
+   */
+  AbstractPlanNodeRef PlanAggregation(std::shared_ptr<SelectStatement> statement);
+
+  /**
+   * Plan a select with a limit or an offset: a limit over the rest of the select. Under it a sort keeps
+   * only the rows up to the end of the limit, and a table is scanned serially, stopping at the last row
+   * the limit passes on rather than reading ahead on parallel workers.
+   */
+  AbstractPlanNodeRef PlanLimit(std::shared_ptr<SelectStatement> statement);
+
+  /**
+   * Plan a select with an order by clause: a sort over the select of the columns of the select list and
+   * of the order by clause. The sort is left out when the select is a B+ tree index scan already
+   * producing its rows in the order asked for.
+   * @param limit The rows the sort keeps, SortPlanNode::kNoLimit for all of them
+   */
+  AbstractPlanNodeRef PlanSort(std::shared_ptr<SelectStatement> statement, size_t limit);
+
+  /**
+   * @return whether plan is a scan of a single B+ tree index whose key, past the columns its
+   * equalities fix, starts with the ascending keys of order_by, columns of the select list of statement
+   */
+  bool IsIndexOrdered(const AbstractPlanNodeRef &plan, const std::shared_ptr<SelectStatement> &statement);
+
+  /**
+   * Plan a select over several tables as a left deep tree of joins, in the order of the FROM clause.
+   * The where clause is split at its ANDs, each part filtering the scan of its table or checked by the
+   * first join that has all of its tables, as a join key when it equals columns of both sides.
+   * A table is joined through an index on its join keys when probing it once per row expected from the
+   * left side costs less than reading the table, otherwise by a hash join.
+   */
+  AbstractPlanNodeRef PlanJoin(std::shared_ptr<SelectStatement> statement);
+
+  /**
+   * Plan the access path of one table, the cheapest of a sequential scan, a scan of one index matching
+   * the predicate or of one index per part of an OR in it, and the intersection of the row ids of several.
+   * @param output_columns The columns of the table in out_schema, with those of the predicate they
+   * tell whether an index covers the query
+   * @param read_only False for the rows of a delete or an update, a sequential scan of them is not split
+   * over threads while the table changes
+   */
+  AbstractPlanNodeRef PlanScan(const std::string &table_name, const Schema *out_schema,
+                               const AbstractExpressionRef &predicate, const std::vector<uint32_t> &output_columns,
+                               bool read_only = true);
+
+  /** Plan the scan finding the whole rows of a table a delete or an update changes */
+  AbstractPlanNodeRef PlanModifiedRows(const std::string &table_name, const AbstractExpressionRef &predicate);
+
   AbstractPlanNodeRef PlanInsert(std::shared_ptr<InsertStatement> statement);
 
   AbstractPlanNodeRef PlanDelete(std::shared_ptr<DeleteStatement> statement);
 
   AbstractPlanNodeRef PlanUpdate(std::shared_ptr<UpdateStatement> statement);
 
+  /**
+   * Flatten the comparisons joined by AND at the top of a predicate.
+   * @return false if some part of the predicate (e.g. an OR) could not be flattened
+   */
+  bool CollectConjuncts(const AbstractExpressionRef &predicate, std::vector<AbstractExpressionRef> &conjuncts);
+
+  /**
+   * Find the index of a table best suited to look up the rows matching the keys of a join.
+   * @param inner_keys The columns of the table equal to columns of the other side
+   * @param[out] matched The positions in inner_keys of the key columns of the index, in key order,
+   * covering the whole key or, for a B+ tree, a prefix of it
+   * @return nullptr if no index can be looked up
+   */
+  IndexInfo *MatchJoinIndex(const std::string &table_name, const std::vector<AbstractExpressionRef> &inner_keys,
+                            std::vector<size_t> *matched);
+
+  /**
+   * @return the share of the rows of a table expected to pass conjuncts, read from the statistics of the
+   * table for a comparison of a column with a constant, the usual defaults otherwise
+   */
+  double EstimateSelectivity(const std::string &table_name, const std::vector<AbstractExpressionRef> &conjuncts);
+
+  /** @return the share of the rows of a table holding any one value of column col_idx */
+  double EstimateEqualSelectivity(const std::string &table_name, uint32_t col_idx);
+
+  /** @return the distinct values of column col_idx of a table, 0 if the table was never analyzed */
+  double GetDistinctValues(const std::string &table_name, uint32_t col_idx);
+
+  /**
+   * Get the size of a table from its statistics, or if it was never analyzed from the counts its heap keeps,
+   * or fixed defaults when the heap was opened from disk and has not been measured.
+   * @param[out] pages At least one
+   */
+  void GetTableSize(const std::string &table_name, double *pages, double *rows);
+
+  /**
+   * @return the cost of finding entries entries in index, over a table of table_rows rows: the pages of
+   * the B+ tree levels that are not kept pinned, the leaves holding the entries, or a hash bucket
+   */
+  double IndexProbeCost(IndexInfo *index, double entries, double table_rows);
+
+  /**
+   * @return the cost of fetching rows rows from a heap of pages pages in row id order: the pages they
+   * fall on, each costing less the more of the heap is read
+   */
+  double HeapFetchCost(double pages, double rows);
+
+  /** Split a predicate at the ANDs at its top, unlike CollectConjuncts() keeping every part. */
+  void SplitConjunction(const AbstractExpressionRef &predicate, std::vector<AbstractExpressionRef> &parts);
+
+  /** Split a predicate at the ORs at its top. */
+  void SplitDisjunction(const AbstractExpressionRef &predicate, std::vector<AbstractExpressionRef> &parts);
+
+  /** @return the AND of parts, nullptr if there are none */
+  AbstractExpressionRef MakeConjunction(const std::vector<AbstractExpressionRef> &parts);
+
+  /** Collect the columns expr reads, columns[row_idx] gets the column indexes of each row index. */
+  void CollectColumns(const AbstractExpressionRef &expr, std::vector<std::vector<uint32_t>> &columns);
+
+  using ColumnBinder = std::function<AbstractExpressionRef(const std::shared_ptr<ColumnValueExpression> &)>;
+
+  /** @return a copy of expr with each column replaced by bind(column) */
+  AbstractExpressionRef RebindColumns(const AbstractExpressionRef &expr, const ColumnBinder &bind);
+
+  /**
+   * Match the key of an index against the conjuncts: equality on a leading run of key columns,
+   * then optionally a lower and an upper bound on the next key column.
+   * @return the matched comparisons in key column order, empty if the index is of no use
+   */
+  std::vector<AbstractExpressionRef> MatchIndexPrefix(IndexInfo *index,
+                                                      const std::vector<AbstractExpressionRef> &conjuncts);
+
   /** the root plan node of the plan tree */
   AbstractPlanNodeRef plan_;
 
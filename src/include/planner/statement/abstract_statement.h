@@ -41,15 +41,47 @@ class AbstractStatement {
    * @return A owning pointer to the ColumnValueExpression
    */
   AbstractExpressionRef MakeColumnValueExpression(const std::string &table_name, pSyntaxNode col) {
-    TableInfo *info = nullptr;
-    context_->GetCatalog()->GetTable(table_name, info);
-    auto schema = info->GetSchema();
-    uint32_t index;
-    if (schema->GetColumnIndex(col->val_, index) != DB_SUCCESS) {
+    return MakeColumnValueExpression(std::vector<std::string>{table_name}, col);
+  }
+
+  /**
+   * Make a column value expression for a column of one of the tables in the FROM clause.
+   * @param tables The tables of the FROM clause
+   * @param col The ptr to the SyntaxNode of the column, named either "column" or "table.column"
+   * @return A owning pointer to the ColumnValueExpression, whose row index is the position of the table in tables
+   */
+  AbstractExpressionRef MakeColumnValueExpression(const std::vector<std::string> &tables, pSyntaxNode col) {
+    std::string name = col->val_;
+    std::string qualifier;
+    auto dot = name.find('.');
+    if (dot != std::string::npos) {
+      qualifier = name.substr(0, dot);
+      name = name.substr(dot + 1);
+    }
+    AbstractExpressionRef expr = nullptr;
+    for (uint32_t i = 0; i < tables.size(); i++) {
+      if (!qualifier.empty() && qualifier != tables[i]) {
+        continue;
+      }
+      TableInfo *info = nullptr;
+      context_->GetCatalog()->GetTable(tables[i], info);
+      auto schema = info->GetSchema();
+      uint32_t index;
+      if (schema->GetColumnIndex(name, index) != DB_SUCCESS) {
+        continue;
+      }
+      if (expr != nullptr) {
+        throw std::logic_error("the column " + name + " is ambiguous");
+      }
+      expr = std::make_shared<ColumnValueExpression>(i, index, schema->GetColumn(index)->GetType());
+    }
+    if (expr == nullptr) {
+      if (!qualifier.empty() && std::find(tables.begin(), tables.end(), qualifier) == tables.end()) {
+        throw std::logic_error("the table " + qualifier + " is not in the from clause");
+      }
       throw std::logic_error("the column does not exist in table");
     }
-    auto col_type = schema->GetColumn(index)->GetType();
-    return std::make_shared<ColumnValueExpression>(0, index, col_type);
+    return expr;
   }
 
   /**
@@ -99,10 +131,21 @@ class AbstractStatement {
    */
   AbstractExpressionRef MakePredicate(pSyntaxNode ast, std::string table_name,
                                       vector<uint32_t> *column_in_condition = nullptr, bool *has_or = nullptr) {
+    return MakePredicate(ast, std::vector<std::string>{table_name}, column_in_condition, has_or);
+  }
+
+  /**
+   * Allocate the predicate over the tables of the FROM clause, a comparison may set a column against
+   * a constant or against another column.
+   * @param tables The tables of the FROM clause, the columns are bound as in MakeColumnValueExpression()
+   * @param column_in_condition Collects the indexes of the columns compared, for a single table
+   */
+  AbstractExpressionRef MakePredicate(pSyntaxNode ast, const std::vector<std::string> &tables,
+                                      vector<uint32_t> *column_in_condition, bool *has_or) {
     switch (ast->type_) {
       case kNodeConnector: {
-          auto left = MakePredicate(ast->child_, table_name, column_in_condition);
-          auto right = MakePredicate(ast->child_->next_, table_name, column_in_condition);
+          auto left = MakePredicate(ast->child_, tables, column_in_condition, nullptr);
+          auto right = MakePredicate(ast->child_->next_, tables, column_in_condition, nullptr);
           if (has_or && !strcmp(ast->val_, "or")) {
           *has_or = true;
         }
@@ -111,15 +154,28 @@ class AbstractStatement {
       case kNodeCompareOperator: {
         pSyntaxNode col = ast->child_;
         pSyntaxNode value = ast->child_->next_;
-        auto col_expr = MakeColumnValueExpression(table_name, col);
-        auto const_expr = MakeConstantValueExpression(col_expr->GetReturnType(), value);
+        auto col_expr = MakeColumnValueExpression(tables, col);
+        AbstractExpressionRef value_expr = nullptr;
+        if (value->type_ == kNodeIdentifier) {
+          if (!strcmp(ast->val_, "is") || !strcmp(ast->val_, "not")) {
+            throw std::logic_error("is and not only test a column against null");
+          }
+          value_expr = MakeColumnValueExpression(tables, value);
+          if (value_expr->GetReturnType() != col_expr->GetReturnType()) {
+            throw std::logic_error("the columns compared are of different types");
+          }
+        } else {
+          value_expr = MakeConstantValueExpression(col_expr->GetReturnType(), value);
+        }
         if (column_in_condition) {
-          uint32_t index = dynamic_pointer_cast<ColumnValueExpression>(col_expr)->GetColIdx();
-            //if(std::find(column_in_condition->begin(), column_in_condition->end(), index) ==column_in_condition->end()){
-                column_in_condition->emplace_back(index);
-            //}
+          for (const auto &expr : {col_expr, value_expr}) {
+            auto column = dynamic_pointer_cast<ColumnValueExpression>(expr);
+            if (column != nullptr) {
+              column_in_condition->emplace_back(column->GetColIdx());
+            }
+          }
         }
-        return MakeComparisonExpression(col_expr, const_expr, ast->val_);
+        return MakeComparisonExpression(col_expr, value_expr, ast->val_);
       }
       default:
         throw std::logic_error("The node kNodeConditions has a child node of the wrong type");
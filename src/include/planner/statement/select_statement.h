@@ -5,7 +5,12 @@
 #ifndef MINISQL_SELECT_STATEMENT_H
 #define MINISQL_SELECT_STATEMENT_H
 
+#include <unordered_map>
+
 #include "abstract_statement.h"
+#include "executor/plans/limit_plan.h"
+#include "executor/plans/sort_plan.h"
+#include "planner/expressions/aggregate_expression.h"
 
 class SelectStatement : public AbstractStatement {
  public:
@@ -23,17 +28,43 @@ class SelectStatement : public AbstractStatement {
           error_info << "the table " << ast->val_ << " is not exist.";
           throw std::logic_error(error_info.str());
         }
-        table_name_ = ast->val_;
+        if (std::find(table_names_.begin(), table_names_.end(), ast->val_) != table_names_.end()) {
+          throw std::logic_error("the table " + std::string(ast->val_) + " appears twice in the from clause");
+        }
+        if (table_names_.empty()) {
+          table_name_ = ast->val_;
+        }
+        table_names_.emplace_back(ast->val_);
         break;
       }
       case kNodeAllColumns:
       case kNodeColumnList: {
         SyntaxTree2Statement(ast->next_);
         MakeColumnList(ast->child_);
+        MakeOrderBy();
+        CheckGrouping();
         return;
       }
       case kNodeConditions: {
-        where_ = MakePredicate(ast->child_, table_name_, &column_in_condition_, &has_or);
+        where_ = MakePredicate(ast->child_, table_names_, &column_in_condition_, &has_or);
+        break;
+      }
+      case kNodeGroupBy: {
+        for (auto column = ast->child_; column != nullptr; column = column->next_) {
+          group_by_.push_back(MakeColumnValueExpression(table_names_, column));
+        }
+        break;
+      }
+      case kNodeOrderBy: {
+        // bound once the select list is, as it may name the columns of the list
+        order_by_ast_ = ast->child_;
+        break;
+      }
+      case kNodeLimit: {
+        limit_ = MakeRowCount(ast->child_, "limit");
+        if (ast->child_->next_ != nullptr) {
+          offset_ = MakeRowCount(ast->child_->next_, "offset");
+        }
         break;
       }
       default:
@@ -43,35 +74,151 @@ class SelectStatement : public AbstractStatement {
   };
 
   void MakeColumnList(pSyntaxNode ast) {
-    TableInfo *info = nullptr;
-    context_->GetCatalog()->GetTable(table_name_, info);
-    auto schema = info->GetSchema();
     if (!ast) {
-      auto columns = schema->GetColumns();
-      for (auto column : columns) {
-        auto expr = std::make_shared<ColumnValueExpression>(0, column->GetTableInd(), column->GetType());
-        column_list_.emplace_back(make_pair(column->GetName(), expr));
+      for (uint32_t i = 0; i < table_names_.size(); i++) {
+        TableInfo *info = nullptr;
+        context_->GetCatalog()->GetTable(table_names_[i], info);
+        for (auto column : info->GetSchema()->GetColumns()) {
+          auto expr = std::make_shared<ColumnValueExpression>(i, column->GetTableInd(), column->GetType());
+          column_list_.emplace_back(make_pair(column->GetName(), expr));
+        }
+      }
+      // a name shared by several tables is qualified with the table it comes from
+      if (table_names_.size() > 1) {
+        std::unordered_map<std::string, uint32_t> name_count;
+        for (const auto &column : column_list_) {
+          name_count[column.first]++;
+        }
+        for (auto &column : column_list_) {
+          if (name_count[column.first] > 1) {
+            auto row_idx = dynamic_pointer_cast<ColumnValueExpression>(column.second)->GetRowIdx();
+            column.first = table_names_[row_idx] + "." + column.first;
+          }
+        }
       }
     } else {
       while (ast) {
-        uint32_t index;
-        if (schema->GetColumnIndex(ast->val_, index) != DB_SUCCESS) {
-          throw std::logic_error("the column does not exist in table");
+        if (ast->type_ == kNodeAggregate) {
+          column_list_.emplace_back(make_pair(AggregateName(ast), MakeAggregateExpression(ast)));
+        } else {
+          column_list_.emplace_back(make_pair(ast->val_, MakeColumnValueExpression(table_names_, ast)));
         }
-        auto expr = std::make_shared<ColumnValueExpression>(0, index, schema->GetColumn(index)->GetType());
-        column_list_.emplace_back(make_pair(ast->val_, expr));
         ast = ast->next_;
       }
     }
   }
 
-  /** Bound FROM clause. */
+  /**
+   * Bind the ORDER BY clause to columns of the select list, appending the keys missing from it to the
+   * list as columns read by the sort only.
+   */
+  void MakeOrderBy() {
+    for (auto item = order_by_ast_; item != nullptr; item = item->next_) {
+      auto key = item->child_;
+      bool aggregate = key->type_ == kNodeAggregate;
+      auto expr = aggregate ? MakeAggregateExpression(key) : MakeColumnValueExpression(table_names_, key);
+      auto found = std::find_if(column_list_.begin(), column_list_.end(),
+                                [&expr](const auto &column) { return SameColumn(column.second, expr); });
+      if (found == column_list_.end()) {
+        column_list_.emplace_back(aggregate ? AggregateName(key) : key->val_, expr);
+        order_by_columns_++;
+        found = column_list_.end() - 1;
+      }
+      auto type = strcmp(item->val_, "desc") == 0 ? OrderByType::Desc : OrderByType::Asc;
+      order_by_.emplace_back(type, std::make_shared<ColumnValueExpression>(0, found - column_list_.begin(),
+                                                                          expr->GetReturnType()));
+    }
+  }
+
+  /** Check that every column of the select list is grouped on or aggregated when rows are grouped. */
+  void CheckGrouping() const {
+    // once rows are grouped, a column outside the aggregates only has a value if it is grouped on
+    if (!IsAggregation()) {
+      return;
+    }
+    for (const auto &column : column_list_) {
+      auto column_value = dynamic_pointer_cast<ColumnValueExpression>(column.second);
+      if (column_value != nullptr && std::none_of(group_by_.begin(), group_by_.end(), [&column_value](auto &group_by) {
+            auto grouped = dynamic_pointer_cast<ColumnValueExpression>(group_by);
+            return grouped->GetRowIdx() == column_value->GetRowIdx() &&
+                   grouped->GetColIdx() == column_value->GetColIdx();
+          })) {
+        throw std::logic_error("the column " + column.first + " must appear in the group by clause or an aggregate");
+      }
+    }
+  }
+
+  /** @return The row count of a LIMIT or OFFSET number. */
+  static size_t MakeRowCount(pSyntaxNode ast, const std::string &clause) {
+    std::string count = ast->val_;
+    if (count.empty() || !std::all_of(count.begin(), count.end(), ::isdigit) || count.size() > 18) {
+      throw std::logic_error("the " + clause + " " + count + " is not a row count");
+    }
+    return std::stoull(count);
+  }
+
+  /** @return The name of the column of an aggregate function, as written. */
+  static std::string AggregateName(pSyntaxNode ast) {
+    return std::string(ast->val_) + "(" + (ast->child_ == nullptr ? "*" : ast->child_->val_) + ")";
+  }
+
+  /** @return Whether two bound columns, or aggregates of columns, compute the same value. */
+  static bool SameColumn(const AbstractExpressionRef &a, const AbstractExpressionRef &b) {
+    auto aggregate_a = dynamic_pointer_cast<AggregateExpression>(a);
+    auto aggregate_b = dynamic_pointer_cast<AggregateExpression>(b);
+    if (aggregate_a != nullptr || aggregate_b != nullptr) {
+      return aggregate_a != nullptr && aggregate_b != nullptr &&
+             aggregate_a->GetAggregationType() == aggregate_b->GetAggregationType() &&
+             (a->GetChildren().empty() || SameColumn(a->GetChildAt(0), b->GetChildAt(0)));
+    }
+    auto column_a = dynamic_pointer_cast<ColumnValueExpression>(a);
+    auto column_b = dynamic_pointer_cast<ColumnValueExpression>(b);
+    return column_a->GetRowIdx() == column_b->GetRowIdx() && column_a->GetColIdx() == column_b->GetColIdx();
+  }
+
+  /** Bind an aggregate function of the SELECT list. */
+  AbstractExpressionRef MakeAggregateExpression(pSyntaxNode ast) {
+    std::string function = ast->val_;
+    std::transform(function.begin(), function.end(), function.begin(), ::tolower);
+    if (ast->child_ == nullptr) {
+      if (function != "count") {
+        throw std::logic_error("the function " + function + " does not take *");
+      }
+      return std::make_shared<AggregateExpression>(AggregationType::CountStar, nullptr);
+    }
+    static const std::unordered_map<std::string, AggregationType> functions = {
+        {"count", AggregationType::Count}, {"sum", AggregationType::Sum}, {"min", AggregationType::Min},
+        {"max", AggregationType::Max},     {"avg", AggregationType::Avg}};
+    auto agg_type = functions.find(function);
+    if (agg_type == functions.end()) {
+      throw std::logic_error("the function " + function + " is not supported");
+    }
+    auto arg = MakeColumnValueExpression(table_names_, ast->child_);
+    if ((agg_type->second == AggregationType::Sum || agg_type->second == AggregationType::Avg) &&
+        arg->GetReturnType() == TypeId::kTypeChar) {
+      throw std::logic_error("the function " + function + " does not take the char column " + ast->child_->val_);
+    }
+    return std::make_shared<AggregateExpression>(agg_type->second, arg);
+  }
+
+  /** @return whether the rows are grouped, by a group by clause or by aggregates in the SELECT list */
+  bool IsAggregation() const {
+    return !group_by_.empty() ||
+           std::any_of(column_list_.begin(), column_list_.end(), [](const auto &column) {
+             return column.second->GetType() == ExpressionType::AggregateExpression;
+           });
+  }
+
+  /** Bound FROM clause, the first table. */
   std::string table_name_;
 
+  /** Every table of the FROM clause, a column bound with row index i belongs to table_names_[i]. */
+  std::vector<std::string> table_names_;
+
   /** Bound SELECT list. */
   std::vector<std::pair<std::string, AbstractExpressionRef>> column_list_;
 
-  /** Index of columns in condition. */
+  /** Index of columns in condition, meaningful for a single table. */
   std::vector<uint32_t> column_in_condition_;
 
   /** Has or in where clause */
@@ -80,6 +227,22 @@ class SelectStatement : public AbstractStatement {
   /** Bound WHERE clause. */
   AbstractExpressionRef where_ = nullptr;
 
+  /** Bound GROUP BY clause, ColumnValueExpressions like those of the SELECT list. */
+  std::vector<AbstractExpressionRef> group_by_;
+
+  /** Bound ORDER BY clause, each key a ColumnValueExpression of a column of the select list. */
+  std::vector<OrderBy> order_by_;
+
+  /** Columns at the end of the select list only read by the ORDER BY clause, not output. */
+  size_t order_by_columns_ = 0;
+
+  /** Bound LIMIT clause, LimitPlanNode::kNoLimit without one, and its offset. */
+  size_t limit_ = LimitPlanNode::kNoLimit;
+  size_t offset_ = 0;
+
+  /** The items of the ORDER BY clause, bound after the select list. */
+  pSyntaxNode order_by_ast_ = nullptr;
+
   std::string ToString() const override {
     std::stringstream sstream;
     sstream << "Select {{\\n  table={" << table_name_ << "},\\n  columns={";
@@ -78,6 +78,21 @@ class Row {
     return *this;
   }
 
+  /**
+   * Row move function, takes over the fields of other
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)) { other.fields_.clear(); }
+
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      destroy();
+      rid_ = other.rid_;
+      fields_ = std::move(other.fields_);
+      other.fields_.clear();
+    }
+    return *this;
+  }
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
@@ -112,4 +127,37 @@ class Row {
   std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
 };
 
+/**
+ * Read-only view of a serialized row in place, as written by Row::SerializeTo(). Reset() locates the
+ * fields of the leading columns a reader needs, the accessors then read single values without building
+ * any Field, so a scan only pays for the columns it uses.
+ */
+class TupleView {
+ public:
+  explicit TupleView(const Schema *schema);
+
+  /**
+   * Point the view at a serialized row and locate its first limit fields.
+   * @param data valid while the view is used
+   */
+  void Reset(const char *data, uint32_t limit);
+
+  inline bool IsNull(uint32_t column) const { return (null_bitmap_[column / 8] & (1 << (7 - column % 8))) == 0; }
+
+  inline int32_t GetInt(uint32_t column) const { return MACH_READ_INT32(data_ + offsets_[column]); }
+
+  inline float GetFloat(uint32_t column) const { return MACH_READ_FROM(float, data_ + offsets_[column]); }
+
+  inline const char *GetChars(uint32_t column) const { return data_ + offsets_[column] + sizeof(uint32_t); }
+
+  inline uint32_t GetCharLength(uint32_t column) const { return MACH_READ_UINT32(data_ + offsets_[column]); }
+
+ private:
+  std::vector<TypeId> types_;
+  const char *data_{nullptr};
+  const char *null_bitmap_{nullptr};
+  /** Offset in data_ of each located field, a null field takes no bytes */
+  std::vector<uint32_t> offsets_;
+};
+
 #endif  // MINISQL_ROW_H
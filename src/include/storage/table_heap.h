@@ -10,6 +10,7 @@
 
 class TableHeap {
   friend class TableIterator;
+  friend class TableScanner;
 
  public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
@@ -71,17 +72,7 @@ class TableHeap {
    */
   bool GetTuple(Row *row, Transaction *txn);
 
-  void FreeTableHeap() {
-    auto next_page_id = first_page_id_;
-    while (next_page_id != INVALID_PAGE_ID) {
-      auto old_page_id = next_page_id;
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
-      assert(page != nullptr);
-      next_page_id = page->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(old_page_id, false);
-      buffer_pool_manager_->DeletePage(old_page_id);
-    }
-  }
+  void FreeTableHeap() { DeleteTable(); }
 
   /**
    * Free table heap and release storage in disk file
@@ -103,6 +94,24 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * Collect the pages of the chain starting at page_id, the whole table by default.
+   */
+  void GetPageIds(std::vector<page_id_t> *page_ids, page_id_t page_id = INVALID_PAGE_ID);
+
+  /**
+   * Count the pages of the table and the tuple slots on them, which bound its rows from above as
+   * slots of deleted tuples may not be reused yet. Reads the header of every page.
+   */
+  void GetSize(size_t *page_count, size_t *slot_count);
+
+  /**
+   * Get the counts GetSize would return without reading any page, kept up to date by the inserts since the
+   * table was created or last measured by GetSize.
+   * @return false if the table was opened from disk and has not been measured since
+   */
+  bool GetKnownSize(size_t *page_count, size_t *slot_count) const;
+
 private:
   /**
    * create table heap and initialize first page
@@ -116,6 +125,8 @@ private:
       auto * page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
       page->Init(first_page_id_, INVALID_PAGE_ID, log_manager, txn);
       buffer_pool_manager_->UnpinPage(first_page_id_,true);
+      page_count_ = 1;
+      size_known_ = true;
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
@@ -132,6 +143,10 @@ private:
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  /** The pages of the table and the tuple slots on them, valid while size_known_ */
+  size_t page_count_{0};
+  size_t slot_count_{0};
+  bool size_known_{false};
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
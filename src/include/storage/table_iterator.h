@@ -12,6 +12,9 @@ public:
   // you may define your own constructor based on your member variables
   explicit TableIterator(RowId rowId,TableHeap *tableheap);
 
+  // takes over a row already read from the heap
+  explicit TableIterator(Row *row,TableHeap *tableheap);
+
   explicit TableIterator(const TableIterator &other);
 
   virtual ~TableIterator();
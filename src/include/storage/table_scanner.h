@@ -0,0 +1,51 @@
+#ifndef MINISQL_TABLE_SCANNER_H
+#define MINISQL_TABLE_SCANNER_H
+
+#include "common/rowid.h"
+#include "page/table_page.h"
+
+class TableHeap;
+class BufferPoolManager;
+
+/**
+ * Walks the live tuples of a table heap in storage order without deserializing them, for scans that
+ * decode only the columns they need. The page of the current tuple stays pinned until the scanner
+ * moves past it or is destroyed, so GetTupleData() can be read in place.
+ */
+class TableScanner {
+public:
+  // positioned before the first tuple of the heap
+  explicit TableScanner(TableHeap *table_heap);
+
+  /**
+   * Scan only the pages of the chain from first_page_id up to, not including, end_page_id,
+   * e.g. one morsel of a parallel scan. INVALID_PAGE_ID as end_page_id scans to the end of the heap.
+   */
+  TableScanner(TableHeap *table_heap, page_id_t first_page_id, page_id_t end_page_id);
+
+  ~TableScanner();
+
+  TableScanner(const TableScanner &) = delete;
+
+  TableScanner &operator=(const TableScanner &) = delete;
+
+  /**
+   * Move to the next live tuple.
+   * @return false at the end of the heap
+   */
+  bool Next();
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline const char *GetTupleData() const { return tuple_data_; }
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  TablePage *page_{nullptr};
+  page_id_t next_page_id_;
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  RowId rid_{INVALID_PAGE_ID, 0};
+  const char *tuple_data_{nullptr};
+};
+
+#endif  // MINISQL_TABLE_SCANNER_H
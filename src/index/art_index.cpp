@@ -0,0 +1,524 @@
+#include "index/art_index.h"
+
+#include <algorithm>
+#include <string>
+
+enum class ArtNodeType : uint8_t { kLeaf, kNode4, kNode16, kNode48, kNode256 };
+
+struct ArtNode {
+  explicit ArtNode(ArtNodeType type) : type_(type) {}
+  virtual ~ArtNode() = default;
+  bool IsLeaf() const { return type_ == ArtNodeType::kLeaf; }
+
+  ArtNodeType type_;
+};
+
+struct ArtLeaf : ArtNode {
+  ArtLeaf(size_t key_size, RowId value) : ArtNode(ArtNodeType::kLeaf), key_(key_size, '\0'), value_(value) {}
+
+  std::string key_;  // the whole normalized key
+  RowId value_;
+};
+
+struct ArtInner : ArtNode {
+  using ArtNode::ArtNode;
+
+  uint16_t count_{0};
+  std::string prefix_;  // bytes every key below shares, after the byte that leads to this node
+};
+
+// Node4 and Node16 keep their key bytes sorted
+struct ArtNode4 : ArtInner {
+  static constexpr int CAPACITY = 4;
+  ArtNode4() : ArtInner(ArtNodeType::kNode4) {}
+
+  uint8_t keys_[CAPACITY]{};
+  ArtNode *children_[CAPACITY]{};
+};
+
+struct ArtNode16 : ArtInner {
+  static constexpr int CAPACITY = 16;
+  ArtNode16() : ArtInner(ArtNodeType::kNode16) {}
+
+  uint8_t keys_[CAPACITY]{};
+  ArtNode *children_[CAPACITY]{};
+};
+
+struct ArtNode48 : ArtInner {
+  static constexpr int CAPACITY = 48;
+  ArtNode48() : ArtInner(ArtNodeType::kNode48) {}
+
+  uint8_t child_index_[256]{};  // slot + 1 of the child for each key byte, 0 if there is none
+  ArtNode *children_[CAPACITY]{};
+};
+
+struct ArtNode256 : ArtInner {
+  ArtNode256() : ArtInner(ArtNodeType::kNode256) {}
+
+  ArtNode *children_[256]{};
+};
+
+namespace {
+
+// a node shrinks to the smaller type once it is down to this many children
+constexpr int NODE16_SHRINK = 3;
+constexpr int NODE48_SHRINK = 12;
+constexpr int NODE256_SHRINK = 37;
+
+inline uint8_t KeyByte(const char *key, uint32_t depth) { return static_cast<uint8_t>(key[depth]); }
+
+ArtNode **FindChild(ArtNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case ArtNodeType::kNode4: {
+      auto n = static_cast<ArtNode4 *>(node);
+      for (int i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == byte) return &n->children_[i];
+      }
+      return nullptr;
+    }
+    case ArtNodeType::kNode16: {
+      auto n = static_cast<ArtNode16 *>(node);
+      auto pos = std::lower_bound(n->keys_, n->keys_ + n->count_, byte);
+      if (pos != n->keys_ + n->count_ && *pos == byte) return &n->children_[pos - n->keys_];
+      return nullptr;
+    }
+    case ArtNodeType::kNode48: {
+      auto n = static_cast<ArtNode48 *>(node);
+      return n->child_index_[byte] == 0 ? nullptr : &n->children_[n->child_index_[byte] - 1];
+    }
+    case ArtNodeType::kNode256: {
+      auto n = static_cast<ArtNode256 *>(node);
+      return n->children_[byte] == nullptr ? nullptr : &n->children_[byte];
+    }
+    default:
+      return nullptr;
+  }
+}
+
+// insert into the sorted keys of a Node4 or Node16 that has room
+template <typename SortedNode>
+void InsertSorted(SortedNode *node, uint8_t byte, ArtNode *child) {
+  int pos = std::lower_bound(node->keys_, node->keys_ + node->count_, byte) - node->keys_;
+  std::copy_backward(node->keys_ + pos, node->keys_ + node->count_, node->keys_ + node->count_ + 1);
+  std::copy_backward(node->children_ + pos, node->children_ + node->count_, node->children_ + node->count_ + 1);
+  node->keys_[pos] = byte;
+  node->children_[pos] = child;
+  node->count_++;
+}
+
+template <typename SortedNode>
+void RemoveSorted(SortedNode *node, uint8_t byte) {
+  int pos = std::lower_bound(node->keys_, node->keys_ + node->count_, byte) - node->keys_;
+  std::copy(node->keys_ + pos + 1, node->keys_ + node->count_, node->keys_ + pos);
+  std::copy(node->children_ + pos + 1, node->children_ + node->count_, node->children_ + pos);
+  node->count_--;
+  node->children_[node->count_] = nullptr;
+}
+
+// copy the children of a sorted node into a sorted node of another size
+template <typename From, typename To>
+To *CopySorted(From *from) {
+  auto to = new To();
+  to->prefix_ = std::move(from->prefix_);
+  to->count_ = from->count_;
+  std::copy(from->keys_, from->keys_ + from->count_, to->keys_);
+  std::copy(from->children_, from->children_ + from->count_, to->children_);
+  return to;
+}
+
+// add a child under a byte the node has no child for yet, the node is replaced by a larger one when full
+void AddChild(ArtNode *&node, uint8_t byte, ArtNode *child) {
+  switch (node->type_) {
+    case ArtNodeType::kNode4: {
+      auto n = static_cast<ArtNode4 *>(node);
+      if (n->count_ < ArtNode4::CAPACITY) {
+        InsertSorted(n, byte, child);
+        return;
+      }
+      auto grown = CopySorted<ArtNode4, ArtNode16>(n);
+      InsertSorted(grown, byte, child);
+      node = grown;
+      delete n;
+      return;
+    }
+    case ArtNodeType::kNode16: {
+      auto n = static_cast<ArtNode16 *>(node);
+      if (n->count_ < ArtNode16::CAPACITY) {
+        InsertSorted(n, byte, child);
+        return;
+      }
+      auto grown = new ArtNode48();
+      grown->prefix_ = std::move(n->prefix_);
+      for (int i = 0; i < n->count_; i++) {
+        grown->children_[i] = n->children_[i];
+        grown->child_index_[n->keys_[i]] = i + 1;
+      }
+      grown->count_ = n->count_;
+      node = grown;
+      delete n;
+      AddChild(node, byte, child);
+      return;
+    }
+    case ArtNodeType::kNode48: {
+      auto n = static_cast<ArtNode48 *>(node);
+      if (n->count_ < ArtNode48::CAPACITY) {
+        // slots are kept packed, the first free one is at count_
+        n->children_[n->count_] = child;
+        n->child_index_[byte] = ++n->count_;
+        return;
+      }
+      auto grown = new ArtNode256();
+      grown->prefix_ = std::move(n->prefix_);
+      for (int b = 0; b < 256; b++) {
+        if (n->child_index_[b] != 0) {
+          grown->children_[b] = n->children_[n->child_index_[b] - 1];
+        }
+      }
+      grown->count_ = n->count_;
+      node = grown;
+      delete n;
+      AddChild(node, byte, child);
+      return;
+    }
+    case ArtNodeType::kNode256: {
+      auto n = static_cast<ArtNode256 *>(node);
+      n->children_[byte] = child;
+      n->count_++;
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+// drop the child under byte, the node is replaced by a smaller one, or by its only child, when it runs low
+void RemoveChild(ArtNode *&node, uint8_t byte) {
+  switch (node->type_) {
+    case ArtNodeType::kNode4: {
+      auto n = static_cast<ArtNode4 *>(node);
+      RemoveSorted(n, byte);
+      if (n->count_ > 1) {
+        return;
+      }
+      // a node with one child only adds a step, merge its prefix and key byte into the child
+      ArtNode *child = n->children_[0];
+      if (!child->IsLeaf()) {
+        auto inner = static_cast<ArtInner *>(child);
+        inner->prefix_ = n->prefix_ + static_cast<char>(n->keys_[0]) + inner->prefix_;
+      }
+      node = child;
+      delete n;
+      return;
+    }
+    case ArtNodeType::kNode16: {
+      auto n = static_cast<ArtNode16 *>(node);
+      RemoveSorted(n, byte);
+      if (n->count_ <= NODE16_SHRINK) {
+        node = CopySorted<ArtNode16, ArtNode4>(n);
+        delete n;
+      }
+      return;
+    }
+    case ArtNodeType::kNode48: {
+      auto n = static_cast<ArtNode48 *>(node);
+      int slot = n->child_index_[byte] - 1;
+      n->child_index_[byte] = 0;
+      n->count_--;
+      // move the last slot into the hole to keep the slots packed
+      if (slot != n->count_) {
+        n->children_[slot] = n->children_[n->count_];
+        for (int b = 0; b < 256; b++) {
+          if (n->child_index_[b] == n->count_ + 1) {
+            n->child_index_[b] = slot + 1;
+            break;
+          }
+        }
+      }
+      n->children_[n->count_] = nullptr;
+      if (n->count_ <= NODE48_SHRINK) {
+        auto shrunk = new ArtNode16();
+        shrunk->prefix_ = std::move(n->prefix_);
+        for (int b = 0; b < 256; b++) {
+          if (n->child_index_[b] != 0) {
+            shrunk->keys_[shrunk->count_] = b;
+            shrunk->children_[shrunk->count_++] = n->children_[n->child_index_[b] - 1];
+          }
+        }
+        node = shrunk;
+        delete n;
+      }
+      return;
+    }
+    case ArtNodeType::kNode256: {
+      auto n = static_cast<ArtNode256 *>(node);
+      n->children_[byte] = nullptr;
+      n->count_--;
+      if (n->count_ <= NODE256_SHRINK) {
+        auto shrunk = new ArtNode48();
+        shrunk->prefix_ = std::move(n->prefix_);
+        for (int b = 0; b < 256; b++) {
+          if (n->children_[b] != nullptr) {
+            shrunk->children_[shrunk->count_] = n->children_[b];
+            shrunk->child_index_[b] = ++shrunk->count_;
+          }
+        }
+        node = shrunk;
+        delete n;
+      }
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+void FreeTree(ArtNode *node) {
+  if (node == nullptr) {
+    return;
+  }
+  if (!node->IsLeaf()) {
+    for (int b = 0; b < 256; b++) {
+      ArtNode **child = FindChild(node, b);
+      if (child != nullptr) {
+        FreeTree(*child);
+      }
+    }
+  }
+  delete node;
+}
+
+}  // namespace
+
+ArtIndex::ArtIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, bool unique)
+    : Index(index_id, key_schema), processor_(key_schema_, key_size, unique) {}
+
+ArtIndex::~ArtIndex() { FreeTree(root_); }
+
+dberr_t ArtIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  auto leaf = new ArtLeaf(processor_.GetKeySize(), row_id);
+  auto index_key = reinterpret_cast<GenericKey *>(&leaf->key_[0]);
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
+  if (!Insert(root_, leaf, 0)) {
+    delete leaf;
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ArtIndex::RemoveEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
+  bool removed = Remove(root_, reinterpret_cast<const char *>(index_key), 0);
+  free(index_key);
+  return removed ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+dberr_t ArtIndex::ScanKey(const Row &key, std::vector<RowId> &result, [[maybe_unused]] Transaction *txn,
+                          std::string compare_operator) {
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  auto probe = reinterpret_cast<const char *>(index_key);
+  uint32_t fields_size = processor_.GetFieldsSize();
+  size_t found = result.size();
+  auto collect = [&result](const ArtLeaf *leaf) {
+    result.push_back(leaf->value_);
+    return true;
+  };
+  if (compare_operator == "=") {
+    if (processor_.IsUnique()) {
+      auto leaf = Lookup(probe);
+      if (leaf != nullptr) {
+        result.push_back(leaf->value_);
+      }
+    } else {
+      // the entries of a non-unique key differ in their row id only and hang below one node
+      ForEach(LookupPrefix(probe, fields_size), collect);
+    }
+  } else {
+    // the leaves come in key order, a scan for smaller keys stops at the first larger one
+    ForEach(root_, [&](const ArtLeaf *leaf) {
+      int cmp = memcmp(leaf->key_.data(), probe, fields_size);
+      if ((compare_operator == "<" && cmp >= 0) || (compare_operator == "<=" && cmp > 0)) {
+        return false;
+      }
+      if ((compare_operator == ">" && cmp > 0) || (compare_operator == ">=" && cmp >= 0) ||
+          (compare_operator == "<>" && cmp != 0) || compare_operator == "<" || compare_operator == "<=") {
+        result.push_back(leaf->value_);
+      }
+      return true;
+    });
+  }
+  free(index_key);
+  if (result.size() > found)
+    return DB_SUCCESS;
+  else
+    return DB_KEY_NOT_FOUND;
+}
+
+dberr_t ArtIndex::Destroy() {
+  FreeTree(root_);
+  root_ = nullptr;
+  return DB_SUCCESS;
+}
+
+const ArtLeaf *ArtIndex::Lookup(const char *key) const {
+  ArtNode *node = root_;
+  uint32_t depth = 0;
+  while (node != nullptr && !node->IsLeaf()) {
+    auto inner = static_cast<ArtInner *>(node);
+    if (memcmp(inner->prefix_.data(), key + depth, inner->prefix_.size()) != 0) {
+      return nullptr;
+    }
+    depth += inner->prefix_.size();
+    ArtNode **child = FindChild(node, KeyByte(key, depth));
+    node = child == nullptr ? nullptr : *child;
+    depth++;
+  }
+  if (node == nullptr) {
+    return nullptr;
+  }
+  auto leaf = static_cast<const ArtLeaf *>(node);
+  return memcmp(leaf->key_.data(), key, leaf->key_.size()) == 0 ? leaf : nullptr;
+}
+
+const ArtNode *ArtIndex::LookupPrefix(const char *key, uint32_t length) const {
+  ArtNode *node = root_;
+  uint32_t depth = 0;
+  while (node != nullptr && depth < length) {
+    if (node->IsLeaf()) {
+      return memcmp(static_cast<ArtLeaf *>(node)->key_.data(), key, length) == 0 ? node : nullptr;
+    }
+    auto inner = static_cast<ArtInner *>(node);
+    // only the part of the prefix inside key[0, length) has to match
+    uint32_t compared = std::min<uint32_t>(inner->prefix_.size(), length - depth);
+    if (memcmp(inner->prefix_.data(), key + depth, compared) != 0) {
+      return nullptr;
+    }
+    depth += inner->prefix_.size();
+    if (depth >= length) {
+      return node;
+    }
+    ArtNode **child = FindChild(node, KeyByte(key, depth));
+    node = child == nullptr ? nullptr : *child;
+    depth++;
+  }
+  return node;
+}
+
+bool ArtIndex::Insert(ArtNode *&node, ArtLeaf *leaf, uint32_t depth) {
+  const char *key = leaf->key_.data();
+  if (node == nullptr) {
+    node = leaf;
+    return true;
+  }
+  if (node->IsLeaf()) {
+    // all keys are equally long, two different keys always branch before their end
+    auto existing = static_cast<ArtLeaf *>(node);
+    uint32_t branch = depth;
+    while (branch < leaf->key_.size() && existing->key_[branch] == key[branch]) {
+      branch++;
+    }
+    if (branch == leaf->key_.size()) {
+      return false;
+    }
+    auto split = new ArtNode4();
+    split->prefix_.assign(key + depth, branch - depth);
+    InsertSorted(split, KeyByte(existing->key_.data(), branch), existing);
+    InsertSorted(split, KeyByte(key, branch), leaf);
+    node = split;
+    return true;
+  }
+  auto inner = static_cast<ArtInner *>(node);
+  uint32_t matched = 0;
+  while (matched < inner->prefix_.size() && inner->prefix_[matched] == key[depth + matched]) {
+    matched++;
+  }
+  if (matched < inner->prefix_.size()) {
+    // the key leaves the prefix early, a new node takes the common part and the old one keeps the rest
+    auto split = new ArtNode4();
+    split->prefix_ = inner->prefix_.substr(0, matched);
+    uint8_t byte = static_cast<uint8_t>(inner->prefix_[matched]);
+    inner->prefix_.erase(0, matched + 1);
+    InsertSorted(split, byte, inner);
+    InsertSorted(split, KeyByte(key, depth + matched), leaf);
+    node = split;
+    return true;
+  }
+  depth += inner->prefix_.size();
+  ArtNode **child = FindChild(node, KeyByte(key, depth));
+  if (child != nullptr) {
+    return Insert(*child, leaf, depth + 1);
+  }
+  AddChild(node, KeyByte(key, depth), leaf);
+  return true;
+}
+
+bool ArtIndex::Remove(ArtNode *&node, const char *key, uint32_t depth) {
+  if (node == nullptr) {
+    return false;
+  }
+  if (node->IsLeaf()) {
+    auto leaf = static_cast<ArtLeaf *>(node);
+    if (memcmp(leaf->key_.data(), key, leaf->key_.size()) != 0) {
+      return false;
+    }
+    delete leaf;
+    node = nullptr;
+    return true;
+  }
+  auto inner = static_cast<ArtInner *>(node);
+  if (memcmp(inner->prefix_.data(), key + depth, inner->prefix_.size()) != 0) {
+    return false;
+  }
+  depth += inner->prefix_.size();
+  uint8_t byte = KeyByte(key, depth);
+  ArtNode **child = FindChild(node, byte);
+  if (child == nullptr || !Remove(*child, key, depth + 1)) {
+    return false;
+  }
+  if (*child == nullptr) {
+    RemoveChild(node, byte);
+  }
+  return true;
+}
+
+bool ArtIndex::ForEach(const ArtNode *node, const std::function<bool(const ArtLeaf *)> &visit) const {
+  if (node == nullptr) {
+    return true;
+  }
+  if (node->IsLeaf()) {
+    return visit(static_cast<const ArtLeaf *>(node));
+  }
+  switch (node->type_) {
+    case ArtNodeType::kNode4: {
+      auto n = static_cast<const ArtNode4 *>(node);
+      for (int i = 0; i < n->count_; i++) {
+        if (!ForEach(n->children_[i], visit)) return false;
+      }
+      return true;
+    }
+    case ArtNodeType::kNode16: {
+      auto n = static_cast<const ArtNode16 *>(node);
+      for (int i = 0; i < n->count_; i++) {
+        if (!ForEach(n->children_[i], visit)) return false;
+      }
+      return true;
+    }
+    case ArtNodeType::kNode48: {
+      auto n = static_cast<const ArtNode48 *>(node);
+      for (int b = 0; b < 256; b++) {
+        if (n->child_index_[b] != 0 && !ForEach(n->children_[n->child_index_[b] - 1], visit)) return false;
+      }
+      return true;
+    }
+    default: {
+      auto n = static_cast<const ArtNode256 *>(node);
+      for (int b = 0; b < 256; b++) {
+        if (n->children_[b] != nullptr && !ForEach(n->children_[b], visit)) return false;
+      }
+      return true;
+    }
+  }
+}
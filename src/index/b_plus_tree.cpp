@@ -1,5 +1,6 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
 
 #include "glog/logging.h"
@@ -29,12 +30,53 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
   }
   buffer_pool_manager->UnpinPage(INDEX_ROOTS_PAGE_ID,false);
 }
-/**
- * TODO: Student Implement
+BPlusTree::~BPlusTree() {
+  ReleaseUpperLevels();
+}
+
+/*
+ * Free every page of the subtree under current_page_id, the whole tree by
+ * default. Page ids are gathered one level at a time from the internal pages,
+ * leaves are never read: all leaves are on the same level, so one child per
+ * level tells whether the next level holds them. The pages are then released
+ * in a single batch.
  */
 void BPlusTree::Destroy(page_id_t current_page_id) {
-  if(root_page_id_ != INVALID_PAGE_ID){
-
+  ReleaseUpperLevels();
+  bool whole_tree = (current_page_id == INVALID_PAGE_ID || current_page_id == root_page_id_);
+  if(current_page_id == INVALID_PAGE_ID){
+    current_page_id = root_page_id_;
+  }
+  if(current_page_id == INVALID_PAGE_ID){
+    return;
+  }
+  std::vector<page_id_t> pages;
+  std::vector<page_id_t> level{current_page_id};
+  auto page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(current_page_id));
+  bool leaf_level = page->IsLeafPage();
+  buffer_pool_manager_->UnpinPage(current_page_id,false);
+  while(!leaf_level){
+    std::vector<page_id_t> children;
+    for(auto page_id : level){
+      auto node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(page_id));
+      for(int i = 0; i < node->GetSize(); i++){
+        children.push_back(node->ValueAt(i));
+      }
+      buffer_pool_manager_->UnpinPage(page_id,false);
+    }
+    pages.insert(pages.end(),level.begin(),level.end());
+    auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(children[0]));
+    leaf_level = child->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(children[0],false);
+    level.swap(children);
+  }
+  pages.insert(pages.end(),level.begin(),level.end());
+  buffer_pool_manager_->DeletePages(pages);
+  if(whole_tree){
+    root_page_id_ = INVALID_PAGE_ID;
+    auto roots = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
+    roots->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID,true);
   }
 }
 
@@ -90,8 +132,9 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Tran
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: keys are unique in the tree (a non-unique index appends the row id
+ * to its keys), if user try to insert duplicate keys return false, otherwise
+ * return true.
  */
 bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transaction) {
   if(root_page_id_ == INVALID_PAGE_ID){
@@ -128,8 +171,9 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immediately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: keys are unique in the tree (a non-unique index appends the row id
+ * to its keys), if user try to insert duplicate keys return false, otherwise
+ * return true.
  */
 bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction *transaction) {
   BPlusTreeLeafPage * page = reinterpret_cast<BPlusTreeLeafPage *>(FindLeafPage(key,false));
@@ -158,6 +202,8 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction
  */
 //split后new_page的key[0]还有值，可以往上传
 BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transaction) {
+  //新的内部页可能落在常驻层，下次查找时重新固定
+  ReleaseUpperLevels();
   page_id_t page_id;
   BPlusTreeInternalPage * new_page = reinterpret_cast<BPlusTreeInternalPage *>(buffer_pool_manager_->NewPage(page_id));
   if(new_page == nullptr){
@@ -195,6 +241,7 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
 void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                                  Transaction *transaction) {
   if(old_node->IsRootPage()){
+    ReleaseUpperLevels();
     page_id_t page_id;
     auto new_page = reinterpret_cast<BPlusTreeInternalPage *>(buffer_pool_manager_->NewPage(page_id));
     new_page->Init(page_id,INVALID_PAGE_ID,processor_.GetKeySize(),leaf_max_size_);
@@ -224,6 +271,159 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
   }
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Number of pages one level needs to hold count entries when each page is
+ * filled to per_page, never leaving a page with fewer than min_per_page.
+ */
+static size_t LevelPageCount(size_t count, size_t per_page, size_t min_per_page) {
+  size_t pages = (count + per_page - 1) / per_page;
+  return std::max<size_t>(1, std::min(pages, count / min_per_page));
+}
+
+/*
+ * Build the tree bottom-up from entries already sorted by key.
+ * Leaves are packed left to right to fill_factor of leaf_max_size_ and linked
+ * as they go, then every internal level is built over the level below it
+ * until a single root remains. Each page is written exactly once, so the cost
+ * is one pass over the sorted entries instead of one descent per entry.
+ * @return: false if the tree is not empty, a page can not be allocated or
+ * next gives the build up
+ */
+bool BPlusTree::BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries, double fill_factor) {
+  size_t i = 0;
+  return BulkLoad(entries.size(), [&entries, &i](std::pair<GenericKey *, RowId> *entry) {
+    *entry = entries[i++];
+    return true;
+  }, fill_factor);
+}
+
+bool BPlusTree::BulkLoad(size_t count, const std::function<bool(std::pair<GenericKey *, RowId> *)> &next,
+                         double fill_factor) {
+  if(!IsEmpty()){
+    LOG(WARNING)<<"bulk load needs an empty tree"<<std::endl;
+    return false;
+  }
+  if(count == 0){
+    return true;
+  }
+  fill_factor = std::min(1.0, std::max(0.5, fill_factor));
+  //每层记录各页的页号和该页子树中最小的键，供上一层作为分隔键
+  //叶子的最小键要拷下来，next 给出的键只在下次调用前有效
+  int key_size = processor_.GetKeySize();
+  std::vector<page_id_t> level;
+  std::vector<char> leaf_low_keys;
+  size_t per_page = std::max<size_t>(1, leaf_max_size_ * fill_factor);
+  size_t page_count = LevelPageCount(count, per_page, 1);
+  LeafPage *prev_leaf = nullptr;
+  for(size_t i = 0; i < page_count; i++){
+    size_t size = count / page_count + (i < count % page_count ? 1 : 0);
+    page_id_t page_id;
+    auto leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(page_id));
+    if(leaf == nullptr){
+      LOG(ERROR)<<"get page failed"<<std::endl;
+      if(prev_leaf != nullptr)
+        buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(),true);
+      return false;
+    }
+    leaf->Init(page_id,INVALID_PAGE_ID,processor_.GetKeySize(),leaf_max_size_);
+    leaf->SetNextPageId(INVALID_PAGE_ID);
+    level.push_back(page_id);
+    for(size_t j = 0; j < size; j++){
+      std::pair<GenericKey *, RowId> entry;
+      if(!next(&entry)){
+        //放弃构建，已写出的叶子全部释放
+        buffer_pool_manager_->UnpinPage(page_id,false);
+        if(prev_leaf != nullptr)
+          buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(),false);
+        buffer_pool_manager_->DeletePages(level);
+        return false;
+      }
+      leaf->SetKeyAt(j,entry.first);
+      leaf->SetValueAt(j,entry.second);
+      if(j == 0){
+        auto key = reinterpret_cast<const char *>(entry.first);
+        leaf_low_keys.insert(leaf_low_keys.end(), key, key + key_size);
+      }
+    }
+    leaf->SetSize(size);
+    if(prev_leaf != nullptr){
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(),true);
+    }
+    prev_leaf = leaf;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(),true);
+  std::vector<GenericKey *> low_keys;
+  for(size_t i = 0; i < level.size(); i++){
+    low_keys.push_back(reinterpret_cast<GenericKey *>(leaf_low_keys.data() + i * key_size));
+  }
+  //逐层向上建内部节点，直到只剩一个根
+  per_page = std::max<size_t>(2, internal_max_size_ * fill_factor);
+  while(level.size() > 1){
+    std::vector<page_id_t> parents;
+    std::vector<GenericKey *> parent_low_keys;
+    page_count = LevelPageCount(level.size(), per_page, 2);
+    size_t begin = 0;
+    for(size_t i = 0; i < page_count; i++){
+      size_t size = level.size() / page_count + (i < level.size() % page_count ? 1 : 0);
+      page_id_t page_id;
+      auto node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(page_id));
+      if(node == nullptr){
+        LOG(ERROR)<<"get page failed"<<std::endl;
+        return false;
+      }
+      node->Init(page_id,INVALID_PAGE_ID,processor_.GetKeySize(),internal_max_size_);
+      for(size_t j = 0; j < size; j++){
+        node->SetKeyAt(j,low_keys[begin + j]);
+        node->SetValueAt(j,level[begin + j]);
+        auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(level[begin + j]));
+        child->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(level[begin + j],true);
+      }
+      node->SetSize(size);
+      buffer_pool_manager_->UnpinPage(page_id,true);
+      parents.push_back(page_id);
+      parent_low_keys.push_back(low_keys[begin]);
+      begin += size;
+    }
+    level.swap(parents);
+    low_keys.swap(parent_low_keys);
+  }
+  root_page_id_ = level[0];
+  UpdateRootPageId(1);
+  return true;
+}
+
+/*
+ * Rebuild the tree packed to fill_factor. Lazy deletes leave sparse leaves
+ * behind; the entries are copied out in key order, the old tree is destroyed
+ * and the tree is bulk loaded again under the same index id.
+ * @return: false if a page can not be allocated
+ */
+bool BPlusTree::Vacuum(double fill_factor) {
+  if(IsEmpty()){
+    return true;
+  }
+  int key_size = processor_.GetKeySize();
+  std::vector<char> keys;
+  std::vector<RowId> values;
+  for(auto iter = Begin(); iter != End(); ++iter){
+    auto key = reinterpret_cast<const char *>((*iter).first);
+    keys.insert(keys.end(), key, key + key_size);
+    values.push_back((*iter).second);
+  }
+  std::vector<std::pair<GenericKey *, RowId>> entries;
+  entries.reserve(values.size());
+  for(size_t i = 0; i < values.size(); i++){
+    entries.emplace_back(reinterpret_cast<GenericKey *>(keys.data() + i * key_size), values[i]);
+  }
+  Destroy();
+  return BulkLoad(entries, fill_factor);
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -268,12 +468,17 @@ void BPlusTree::Remove(const GenericKey *key, Transaction *transaction) {
     buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
     return;
   }
-  if(size2 < page->GetMinSize()){
+  if(size2 < MergeThreshold(page)){
     if(!CoalesceOrRedistribute(page,transaction)){
       LOG(WARNING)<<"big mistake"<<std::endl;
     }
     return;
   }
+  //延迟删除不改写父节点：旧的分隔键仍是这个叶子中所有键的下界，查找结果不变
+  if(lazy_delete_){
+    buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
+    return;
+  }
   InternalPage *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(page->GetParentPageId()));
   int index = parent->ValueIndex(page->GetPageId());
   parent->SetKeyAt(index,page->KeyAt(0));
@@ -281,6 +486,19 @@ void BPlusTree::Remove(const GenericKey *key, Transaction *transaction) {
   buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
 }
 
+/*
+ * Size below which a page is merged with or refilled from a sibling. Eager
+ * deletes keep every page at least half full. Lazy deletes only step in once a
+ * page is nearly empty, so a run of deletes followed by inserts of nearby keys
+ * does not merge pages just to split them again; Vacuum repacks the rest.
+ */
+int BPlusTree::MergeThreshold(BPlusTreePage *page) const {
+  if(!lazy_delete_ || page->IsRootPage()){
+    return page->GetMinSize();
+  }
+  return std::max(page->IsLeafPage() ? 1 : 2, static_cast<int>(page->GetMaxSize() * INDEX_MERGE_LOW_WATER));
+}
+
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
@@ -430,6 +648,8 @@ bool BPlusTree::CoalesceOrRedistribute(InternalPage *&node, Transaction *transac
 
 bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
                          Transaction *transaction){
+  //被合并掉的页可能仍被常驻，先全部放开才能删除
+  ReleaseUpperLevels();
   GenericKey *middle_key = parent->KeyAt(index+1);
   neighbor_node->MoveAllTo(node,middle_key,buffer_pool_manager_);
   parent->Remove(index+1);
@@ -438,7 +658,7 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
     //LOG(WARNING)<<"it is you"<<std::endl;
   }
   buffer_pool_manager_->UnpinPage(node->GetPageId(),true);
-  if(parent->GetSize() < parent->GetMinSize()){
+  if(parent->GetSize() < MergeThreshold(parent)){
     CoalesceOrRedistribute(parent,transaction);
   }
   else{
@@ -456,7 +676,7 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
     LOG(WARNING)<<"it is you"<<std::endl;
   }
   buffer_pool_manager_->UnpinPage(node->GetPageId(),true);
-  if(parent->GetSize() < parent->GetMinSize()){
+  if(parent->GetSize() < MergeThreshold(parent)){
     CoalesceOrRedistribute(parent,transaction);
   }
   else{
@@ -552,12 +772,14 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
  * happened
  */
 bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
+  ReleaseUpperLevels();
   if(old_root_node->GetSize() == 0){
     root_page_id_ = INVALID_PAGE_ID;
     UpdateRootPageId(0);
     return true;
   }
-  if(old_root_node->GetSize() == 1){
+  //a leaf root holding a single key is still a valid tree
+  if(old_root_node->GetSize() == 1 && !old_root_node->IsLeafPage()){
     BPlusTreeInternalPage *temp = reinterpret_cast<BPlusTreeInternalPage *>(old_root_node);
     root_page_id_ = temp->ValueAt(0);
     UpdateRootPageId(0);
@@ -578,6 +800,9 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin() {
+  if (IsEmpty()) {
+    return IndexIterator();
+  }
   BPlusTreeLeafPage *temp = reinterpret_cast<BPlusTreeLeafPage *>(FindLeafPage(nullptr,true));
   page_id_t pageId = temp->GetPageId();
   buffer_pool_manager_->UnpinPage(temp->GetPageId(),false);
@@ -590,6 +815,9 @@ IndexIterator BPlusTree::Begin() {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin(const GenericKey *key) {
+  if (IsEmpty()) {
+    return IndexIterator();
+  }
   BPlusTreeLeafPage *temp = reinterpret_cast<BPlusTreeLeafPage *>(FindLeafPage(key,false));
   page_id_t pageId = temp->GetPageId();
   int index = temp->KeyIndex(key,processor_);
@@ -599,21 +827,11 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
 
 /*
  * Input parameter is void, construct an index iterator representing the end
- * of the key/value pair in the leaf node
+ * of the key/value pair in the leaf node, i.e. one past the last pair
  * @return : index iterator
  */
 IndexIterator BPlusTree::End() {
-  BPlusTreeLeafPage *temp = reinterpret_cast<BPlusTreeLeafPage *>(FindLeafPage(nullptr,true));
-  BPlusTreeLeafPage *next;
-  while(temp->GetNextPageId() != INVALID_PAGE_ID){
-    next=reinterpret_cast<BPlusTreeLeafPage *>(buffer_pool_manager_->FetchPage(temp->GetNextPageId()));
-    buffer_pool_manager_->UnpinPage(temp->GetPageId(),false);
-    temp=next;
-  }
-  page_id_t pageId = temp->GetPageId();
-  int index=temp->GetSize();
-  buffer_pool_manager_->UnpinPage(temp->GetPageId(),false);
-  return IndexIterator(pageId,buffer_pool_manager_,index-1);
+  return IndexIterator();
 }
 
 /*****************************************************************************
@@ -628,28 +846,76 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, bool leftMost) {
   if(root_page_id_ == INVALID_PAGE_ID){
     return nullptr;
   }
-  BPlusTreePage * page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_));
+  if(!upper_levels_pinned_){
+    PinUpperLevels();
+  }
+  //常驻的上层页直接取帧，不经过缓冲池的查找和 pin/unpin
+  auto iter = pinned_pages_.find(root_page_id_);
+  bool pinned = (iter != pinned_pages_.end());
+  Page *frame = pinned ? iter->second : buffer_pool_manager_->FetchPage(root_page_id_);
+  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(frame);
   BPlusTreeInternalPage *temp;
-  Page *result;
   page_id_t temp_page;
-  if(leftMost){
-    while(!page->IsLeafPage()){
-      temp = reinterpret_cast<BPlusTreeInternalPage *>(page);
-      temp_page = temp->ValueAt(0);
-      page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(temp_page));
+  while(!page->IsLeafPage()){
+    temp = reinterpret_cast<BPlusTreeInternalPage *>(page);
+    temp_page = leftMost ? temp->ValueAt(0) : temp->Lookup(key,processor_);
+    iter = pinned_pages_.find(temp_page);
+    bool child_pinned = (iter != pinned_pages_.end());
+    frame = child_pinned ? iter->second : buffer_pool_manager_->FetchPage(temp_page);
+    page = reinterpret_cast<BPlusTreePage *>(frame);
+    if(!pinned){
       buffer_pool_manager_->UnpinPage(temp->GetPageId(),false);
     }
-    result = reinterpret_cast<Page *>(page);
-    return result;
+    pinned = child_pinned;
   }
-  while(!page->IsLeafPage()){
-    temp = reinterpret_cast<BPlusTreeInternalPage *>(page);
-    temp_page = temp->Lookup(key,processor_);
-    page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(temp_page));
-    buffer_pool_manager_->UnpinPage(temp->GetPageId(),false);
+  //叶子从不常驻，返回的叶子总是带着一次 pin
+  return frame;
+}
+
+/*
+ * Pin the internal pages of the top pinned_levels_ levels for good, so a
+ * lookup only goes through the buffer pool for the levels below them. Leaves
+ * are never pinned, and the pinned pages are capped at a sixteenth of the pool
+ * so a wide tree can not crowd out everything else.
+ */
+void BPlusTree::PinUpperLevels() {
+  upper_levels_pinned_ = true;
+  size_t budget = buffer_pool_manager_->GetPoolSize() / 16;
+  std::vector<page_id_t> level{root_page_id_};
+  for(int depth = 0; depth < pinned_levels_ && pinned_pages_.size() + level.size() <= budget; depth++){
+    std::vector<page_id_t> children;
+    for(auto page_id : level){
+      Page *frame = buffer_pool_manager_->FetchPage(page_id);
+      if(frame == nullptr){
+        return;
+      }
+      auto page = reinterpret_cast<BPlusTreePage *>(frame);
+      //所有叶子在同一层，遇到叶子说明已经到底
+      if(page->IsLeafPage()){
+        buffer_pool_manager_->UnpinPage(page_id,false);
+        return;
+      }
+      pinned_pages_.emplace(page_id,frame);
+      auto node = reinterpret_cast<InternalPage *>(page);
+      for(int i = 0; i < node->GetSize(); i++){
+        children.push_back(node->ValueAt(i));
+      }
+    }
+    level.swap(children);
+  }
+}
+
+/*
+ * Give the pinned upper pages back to the buffer pool. Called whenever the
+ * set of pages on the top levels may change: a new root, an internal split or
+ * merge, or the tree being destroyed.
+ */
+void BPlusTree::ReleaseUpperLevels() {
+  for(auto &entry : pinned_pages_){
+    buffer_pool_manager_->UnpinPage(entry.first,false);
   }
-  result = reinterpret_cast<Page *>(page);
-  return result;
+  pinned_pages_.clear();
+  upper_levels_pinned_ = false;
 }
 
 /*
@@ -662,10 +928,8 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, bool leftMost) {
  */
 void BPlusTree::UpdateRootPageId(int insert_record) const {
   auto page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
-  if(insert_record){
-    page->Insert(index_id_,root_page_id_);
-  }
-  else{
+  //a tree emptied by deletes keeps its record, so an insert may find it there already
+  if(!insert_record || !page->Insert(index_id_,root_page_id_)){
     page->Update(index_id_,root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID,true);
@@ -791,6 +1055,8 @@ void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
 }
 
 bool BPlusTree::Check() {
+  //常驻的上层页是有意固定的，检查前先放开
+  ReleaseUpperLevels();
   bool all_unpinned = buffer_pool_manager_->CheckAllUnpinned();
   if (!all_unpinned) {
     LOG(ERROR) << "problem in page unpin" << endl;
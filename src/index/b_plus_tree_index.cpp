@@ -1,21 +1,32 @@
 #include <algorithm>
+#include <thread>
 #include "index/b_plus_tree_index.h"
 
+#include "executor/spill_file.h"
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
+                               BufferPoolManager *buffer_pool_manager, bool unique)
     : Index(index_id, key_schema),
-      processor_(key_schema_, key_size),
+      buffer_pool_manager_(buffer_pool_manager),
+      processor_(key_schema_, key_size, unique),
       container_(index_id, buffer_pool_manager, processor_) {}
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
 
   bool status = container_.Insert(index_key, row_id, txn);
-  delete index_key;
+  if (status && filter_ready_) {
+    filter_.Insert(processor_.HashKeyFields64(index_key));
+    // past its capacity the filter loses precision, resize it on the next probe
+    if (++filter_entries_ > filter_.GetCapacity()) {
+      filter_ready_ = false;
+    }
+  }
+  free(index_key);
   //  TreeFileManagers mgr("tree_");
   //  static int i = 0;
   //  if (i % 10 == 0) container_.PrintTree(mgr[i]);
@@ -27,50 +38,331 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
   return DB_SUCCESS;
 }
 
+// below this many entries a single thread sorts faster than splitting the work
+static constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+namespace {
+
+/**
+ * Merges runs of records sorted by key, a record being an encoded key followed by the row id of its entry.
+ * Each run keeps its head record in memory and one page pinned.
+ */
+class RunMerger {
+ public:
+  RunMerger(const std::vector<std::unique_ptr<SpillFile>> &runs, size_t first, size_t last, size_t record_size,
+            const KeyManager &processor)
+      : runs_(runs), record_size_(record_size), processor_(processor), heads_((last - first) * record_size),
+        out_(record_size), first_(first) {
+    for (size_t i = first; i < last; i++) {
+      runs_[i]->Rewind();
+      if (runs_[i]->ReadRecord(Head(i - first), record_size_)) {
+        heap_.push_back(i - first);
+      }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), After());
+  }
+
+  /** @return The next record in key order, valid until the next call, nullptr after the last one */
+  const char *Next() {
+    if (heap_.empty()) {
+      return nullptr;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), After());
+    size_t run = heap_.back();
+    memcpy(out_.data(), Head(run), record_size_);
+    if (runs_[first_ + run]->ReadRecord(Head(run), record_size_)) {
+      std::push_heap(heap_.begin(), heap_.end(), After());
+    } else {
+      heap_.pop_back();
+    }
+    return out_.data();
+  }
+
+ private:
+  char *Head(size_t run) { return heads_.data() + run * record_size_; }
+
+  // the heap keeps the smallest head on top
+  std::function<bool(size_t, size_t)> After() {
+    return [this](size_t a, size_t b) {
+      auto lhs = reinterpret_cast<GenericKey *>(Head(a));
+      auto rhs = reinterpret_cast<GenericKey *>(Head(b));
+      return processor_.CompareKeys(lhs, rhs) > 0;
+    };
+  }
+
+  const std::vector<std::unique_ptr<SpillFile>> &runs_;
+  size_t record_size_;
+  const KeyManager &processor_;
+  std::vector<char> heads_;
+  std::vector<char> out_;
+  std::vector<size_t> heap_;
+  size_t first_;
+};
+
+}  // namespace
+
+void BPlusTreeIndex::SortEntries(std::vector<Entry> *entries) const {
+  // sort one chunk per thread, then merge the sorted runs pairwise
+  auto less = [this](const Entry &lhs, const Entry &rhs) { return processor_.CompareKeys(lhs.first, rhs.first) < 0; };
+  size_t thread_count = 1;
+  if (entries->size() >= PARALLEL_SORT_THRESHOLD) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  size_t chunk = std::max<size_t>(1, (entries->size() + thread_count - 1) / thread_count);
+  std::vector<std::thread> workers;
+  for (size_t begin = 0; begin < entries->size(); begin += chunk) {
+    size_t end = std::min(entries->size(), begin + chunk);
+    workers.emplace_back([entries, &less, begin, end]() { std::sort(entries->begin() + begin, entries->begin() + end, less); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (size_t width = chunk; width < entries->size(); width *= 2) {
+    for (size_t begin = 0; begin + width < entries->size(); begin += 2 * width) {
+      std::inplace_merge(entries->begin() + begin, entries->begin() + begin + width,
+                         entries->begin() + std::min(entries->size(), begin + 2 * width), less);
+    }
+  }
+}
+
+dberr_t BPlusTreeIndex::BulkLoad(const std::vector<uint32_t> &key_map, const std::function<const Row *()> &next,
+                                 Transaction *txn) {
+  return BulkLoad(key_map, next, txn, INDEX_BUILD_MEMORY_BUDGET);
+}
+
+dberr_t BPlusTreeIndex::BulkLoad(const std::vector<uint32_t> &key_map, const std::function<const Row *()> &next,
+                                 [[maybe_unused]] Transaction *txn, size_t memory_budget) {
+  // a record is an encoded key followed by the row id of its entry, the tree copies the keys into its pages
+  size_t key_size = processor_.GetKeySize();
+  size_t record_size = key_size + sizeof(int64_t);
+  size_t run_capacity = std::max<size_t>(2, memory_budget / record_size);
+  auto duplicate = []() {
+    LOG(WARNING) << "Duplicate key, can not build a unique index." << std::endl;
+    return DB_FAILED;
+  };
+  std::vector<char> buffer;
+  std::vector<Entry> entries;
+  std::vector<std::unique_ptr<SpillFile>> runs;
+  size_t total = 0;
+  for (const Row *row = next(); row != nullptr;) {
+    // encode the keys of the rows into the buffer until the budget is used up, then sort them
+    size_t count = 0;
+    buffer.clear();
+    for (; row != nullptr && count < run_capacity; row = next(), count++) {
+      buffer.resize((count + 1) * record_size);
+      char *record = buffer.data() + count * record_size;
+      auto *key = reinterpret_cast<GenericKey *>(record);
+      processor_.SerializeFromRow(key, *row, key_map, key_schema_);
+      processor_.SetKeyRowId(key, row->GetRowId());
+      int64_t rid = row->GetRowId().Get();
+      memcpy(record + key_size, &rid, sizeof(int64_t));
+    }
+    entries.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      char *record = buffer.data() + i * record_size;
+      int64_t rid;
+      memcpy(&rid, record + key_size, sizeof(int64_t));
+      entries[i] = Entry(reinterpret_cast<GenericKey *>(record), RowId(rid));
+    }
+    SortEntries(&entries);
+    for (size_t i = 1; i < entries.size(); i++) {
+      if (processor_.CompareKeys(entries[i - 1].first, entries[i].first) == 0) {
+        return duplicate();
+      }
+    }
+    total += count;
+    if (row == nullptr && runs.empty()) {
+      // every key fit in the budget
+      if (!container_.BulkLoad(entries)) {
+        return DB_FAILED;
+      }
+      filter_ready_ = false;
+      return DB_SUCCESS;
+    }
+    auto run = std::make_unique<SpillFile>(buffer_pool_manager_, nullptr);
+    for (const auto &entry : entries) {
+      run->AppendRecord(reinterpret_cast<const char *>(entry.first), record_size);
+    }
+    runs.push_back(std::move(run));
+  }
+  if (runs.empty()) {
+    return DB_SUCCESS;
+  }
+  buffer = std::vector<char>();
+  entries = std::vector<Entry>();
+  // merge the runs a few at a time until the last merge can feed the tree
+  while (runs.size() > SORT_MERGE_WAYS) {
+    std::vector<std::unique_ptr<SpillFile>> merged;
+    for (size_t first = 0; first < runs.size(); first += SORT_MERGE_WAYS) {
+      size_t last = std::min<size_t>(first + SORT_MERGE_WAYS, runs.size());
+      auto run = std::make_unique<SpillFile>(buffer_pool_manager_, nullptr);
+      RunMerger merger(runs, first, last, record_size, processor_);
+      for (auto record = merger.Next(); record != nullptr; record = merger.Next()) {
+        run->AppendRecord(record, record_size);
+      }
+      for (size_t i = first; i < last; i++) {
+        runs[i].reset();
+      }
+      merged.push_back(std::move(run));
+    }
+    runs = std::move(merged);
+  }
+  // keys shared across runs meet in the merge, the tree then gives the build up
+  RunMerger merger(runs, 0, runs.size(), record_size, processor_);
+  std::vector<char> previous(key_size);
+  bool has_previous = false, has_duplicate = false;
+  bool built = container_.BulkLoad(total, [&](Entry *entry) {
+    const char *record = merger.Next();
+    ASSERT(record != nullptr, "Sorted runs hold fewer keys than were read.");
+    auto key = reinterpret_cast<const GenericKey *>(record);
+    if (has_previous && processor_.CompareKeys(reinterpret_cast<GenericKey *>(previous.data()), key) == 0) {
+      has_duplicate = true;
+      return false;
+    }
+    memcpy(previous.data(), record, key_size);
+    has_previous = true;
+    int64_t rid;
+    memcpy(&rid, record + key_size, sizeof(int64_t));
+    *entry = Entry(reinterpret_cast<GenericKey *>(const_cast<char *>(record)), RowId(rid));
+    return true;
+  });
+  if (has_duplicate) {
+    return duplicate();
+  }
+  if (!built) {
+    return DB_FAILED;
+  }
+  filter_ready_ = false;
+  return DB_SUCCESS;
+}
+
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
 
   container_.Remove(index_key, txn);
-  delete index_key;
+  free(index_key);
+  // removed keys stay set in the filter, once they are a large share of it rebuild it
+  if (filter_ready_ && ++filter_removed_ > filter_.GetCapacity() / 4) {
+    filter_ready_ = false;
+  }
   return DB_SUCCESS;
 }
 
 dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn, string compare_operator) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
+  // in front of every entry holding this key when duplicates are allowed
+  processor_.SetKeyRowId(index_key, INVALID_ROWID);
+  if (compare_operator == "=" && !MayContain(index_key)) {
+    free(index_key);
+    return DB_KEY_NOT_FOUND;
+  }
   if (compare_operator == "=") {
-    container_.GetValue(index_key, result, txn);
+    if (processor_.IsUnique()) {
+      container_.GetValue(index_key, result, txn);
+    } else {
+      for (auto iter = GetBeginIterator(index_key); iter != GetEndIterator(); ++iter) {
+        if (processor_.CompareKeyFields((*iter).first, index_key) != 0)
+          break;
+        result.emplace_back((*iter).second);
+      }
+    }
   } else if (compare_operator == ">") {
-    auto iter = GetBeginIterator(index_key);
-    if (container_.GetValue(index_key, result, txn))
-      ++iter;
-    result.clear();
-    for (; iter != GetEndIterator(); ++iter) {
-      result.emplace_back((*iter).second);
+    for (auto iter = GetBeginIterator(index_key); iter != GetEndIterator(); ++iter) {
+      if (processor_.CompareKeyFields((*iter).first, index_key) > 0)
+        result.emplace_back((*iter).second);
     }
   } else if (compare_operator == ">=") {
     for (auto iter = GetBeginIterator(index_key); iter != GetEndIterator(); ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<") {
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
+    for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
+      if (processor_.CompareKeyFields((*iter).first, index_key) >= 0)
+        break;
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<=") {
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
+    for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
+      if (processor_.CompareKeyFields((*iter).first, index_key) > 0)
+        break;
       result.emplace_back((*iter).second);
     }
-    container_.GetValue(index_key, result, txn);
   } else if (compare_operator == "<>") {
     for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
-      result.emplace_back((*iter).second);
+      if (processor_.CompareKeyFields((*iter).first, index_key) != 0)
+        result.emplace_back((*iter).second);
+    }
+  }
+  free(index_key);
+  if (!result.empty())
+    return DB_SUCCESS;
+  else
+    return DB_KEY_NOT_FOUND;
+}
+
+dberr_t BPlusTreeIndex::ScanPrefix(const vector<Field> &key_prefix, vector<RowId> &result,
+                                   [[maybe_unused]] Transaction *txn, const Field *lower, bool lower_inclusive,
+                                   const Field *upper, bool upper_inclusive, vector<Row> *key_rows) {
+  uint32_t prefix_len = key_prefix.size();
+  uint32_t column_count = key_schema_->GetColumnCount();
+  bool bounded = (lower != nullptr || upper != nullptr);
+  ASSERT(prefix_len + (bounded ? 1 : 0) <= column_count, "Too many key columns for index scan.");
+  // start from the prefix (and the lower bound) padded with nulls, the smallest key carrying that prefix
+  vector<Field> fields;
+  for (uint32_t i = 0; i < column_count; i++) {
+    if (i < prefix_len) {
+      fields.emplace_back(key_prefix[i]);
+    } else if (i == prefix_len && lower != nullptr) {
+      fields.emplace_back(*lower);
+    } else {
+      fields.emplace_back(key_schema_->GetColumn(i)->GetType());
+    }
+  }
+  Row start_row(fields);
+  GenericKey *start_key = processor_.InitKey();
+  processor_.SerializeFromKey(start_key, start_row, key_schema_);
+  processor_.SetKeyRowId(start_key, INVALID_ROWID);
+  // an equality on every key column is a point probe the filter can rule out
+  if (!bounded && prefix_len == column_count && !MayContain(start_key)) {
+    free(start_key);
+    return DB_KEY_NOT_FOUND;
+  }
+  for (auto iter = container_.Begin(start_key); iter != container_.End(); ++iter) {
+    Row key(INVALID_ROWID);
+    processor_.DeserializeToKey((*iter).first, key, key_schema_);
+    bool prefix_match = true;
+    for (uint32_t i = 0; i < prefix_len && prefix_match; i++) {
+      prefix_match = (key.GetField(i)->CompareEquals(key_prefix[i]) == CmpBool::kTrue);
+    }
+    // keys are ordered, the first one off the prefix ends the range
+    if (!prefix_match) {
+      break;
+    }
+    if (bounded) {
+      Field *value = key.GetField(prefix_len);
+      if (value->IsNull()) {
+        continue;
+      }
+      if (lower != nullptr && !lower_inclusive && value->CompareEquals(*lower) == CmpBool::kTrue) {
+        continue;
+      }
+      if (upper != nullptr) {
+        CmpBool in_range = upper_inclusive ? value->CompareLessThanEquals(*upper) : value->CompareLessThan(*upper);
+        if (in_range != CmpBool::kTrue) {
+          break;
+        }
+      }
+    }
+    result.emplace_back((*iter).second);
+    if (key_rows != nullptr) {
+      key.SetRowId((*iter).second);
+      key_rows->emplace_back(key);
     }
-    vector<RowId> temp;
-    if (container_.GetValue(index_key, temp, txn))
-      result.erase(find(result.begin(), result.end(), temp[0]));
   }
-  delete index_key;
+  free(start_key);
   if (!result.empty())
     return DB_SUCCESS;
   else
@@ -79,9 +371,38 @@ dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transacti
 
 dberr_t BPlusTreeIndex::Destroy() {
   container_.Destroy();
+  filter_ready_ = false;
   return DB_SUCCESS;
 }
 
+bool BPlusTreeIndex::MayContain(const GenericKey *key) {
+  if (!filter_ready_) {
+    BuildFilter();
+  }
+  return filter_.MayContain(processor_.HashKeyFields64(key));
+}
+
+// a filter never sized below this many keys, so a small index does not rebuild it on every few inserts
+static constexpr size_t MIN_FILTER_CAPACITY = 1024;
+
+void BPlusTreeIndex::BuildFilter() {
+  std::vector<uint64_t> hashes;
+  for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
+    hashes.push_back(processor_.HashKeyFields64((*iter).first));
+  }
+  filter_ = BloomFilter(std::max(MIN_FILTER_CAPACITY, 2 * hashes.size()));
+  for (auto hash : hashes) {
+    filter_.Insert(hash);
+  }
+  filter_entries_ = hashes.size();
+  filter_removed_ = 0;
+  filter_ready_ = true;
+}
+
+dberr_t BPlusTreeIndex::Vacuum([[maybe_unused]] Transaction *txn) {
+  return container_.Vacuum() ? DB_SUCCESS : DB_FAILED;
+}
+
 IndexIterator BPlusTreeIndex::GetBeginIterator() {
   return container_.Begin();
 }
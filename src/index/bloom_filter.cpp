@@ -0,0 +1,37 @@
+#include "index/bloom_filter.h"
+
+#include <algorithm>
+
+// odd constants spreading the low half of a hash over the 32 bit positions of each word
+static constexpr uint32_t BLOOM_SALT[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                           0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+BloomFilter::BloomFilter(size_t capacity, uint32_t bits_per_key) : capacity_(capacity) {
+  size_t bits = std::max<size_t>(1, capacity) * bits_per_key;
+  blocks_.assign((bits + 255) / 256, Block{});
+}
+
+void BloomFilter::Insert(uint64_t hash) {
+  if (blocks_.empty()) {
+    return;
+  }
+  auto &block = blocks_[BlockIndex(hash)];
+  auto low = static_cast<uint32_t>(hash);
+  for (int i = 0; i < 8; i++) {
+    block[i] |= 1U << ((low * BLOOM_SALT[i]) >> 27);
+  }
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  if (blocks_.empty()) {
+    return true;
+  }
+  const auto &block = blocks_[BlockIndex(hash)];
+  auto low = static_cast<uint32_t>(hash);
+  for (int i = 0; i < 8; i++) {
+    if ((block[i] & (1U << ((low * BLOOM_SALT[i]) >> 27))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,341 @@
+#include "index/extendible_hash_index.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "glog/logging.h"
+#include "page/index_roots_page.h"
+
+ExtendibleHashIndex::ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
+                                         BufferPoolManager *buffer_pool_manager, bool unique)
+    : Index(index_id, key_schema),
+      buffer_pool_manager_(buffer_pool_manager),
+      processor_(key_schema_, key_size),
+      unique_(unique) {
+  auto roots = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t directory_page_id;
+  if (roots->GetRootId(index_id, &directory_page_id)) {
+    directory_page_id_ = directory_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  auto directory = reinterpret_cast<DirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  global_depth_ = directory->GetGlobalDepth();
+  for (uint32_t i = 0; i < directory->GetSegmentCount(); i++) {
+    segment_page_ids_.push_back(directory->GetSegmentPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+}
+
+dberr_t ExtendibleHashIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  if (directory_page_id_ == INVALID_PAGE_ID && !StartNewDirectory()) {
+    return DB_FAILED;
+  }
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  uint32_t hash = processor_.HashKeyFields(index_key);
+  dberr_t result = DB_FAILED;
+  while (true) {
+    page_id_t head_page_id = GetBucketPageId(hash);
+    auto head = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(head_page_id)->GetData());
+    // walk the overflow chain: refuse a duplicate key, remember the first bucket with room and the last one
+    page_id_t free_page_id = INVALID_PAGE_ID, last_page_id = head_page_id;
+    bool duplicate = false;
+    for (page_id_t page_id = head_page_id; page_id != INVALID_PAGE_ID && !duplicate;) {
+      auto bucket = page_id == head_page_id
+                        ? head
+                        : reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+      for (int i = 0; unique_ && i < bucket->GetSize() && !duplicate; i++) {
+        duplicate = processor_.CompareKeys(bucket->KeyAt(i), index_key) == 0;
+      }
+      if (free_page_id == INVALID_PAGE_ID && !bucket->IsFull()) {
+        free_page_id = page_id;
+      }
+      last_page_id = page_id;
+      page_id_t next_page_id = bucket->GetNextPageId();
+      if (page_id != head_page_id) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+      }
+      page_id = next_page_id;
+    }
+    if (duplicate) {
+      buffer_pool_manager_->UnpinPage(head_page_id, false);
+      break;
+    }
+    if (free_page_id != INVALID_PAGE_ID) {
+      auto bucket = free_page_id == head_page_id
+                        ? head
+                        : reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(free_page_id)->GetData());
+      bucket->Insert(index_key, row_id);
+      if (free_page_id != head_page_id) {
+        buffer_pool_manager_->UnpinPage(free_page_id, true);
+      }
+      buffer_pool_manager_->UnpinPage(head_page_id, true);
+      result = DB_SUCCESS;
+      break;
+    }
+    // a full bucket splits while one more hash bit can tell its keys apart, then the insert starts over
+    if (head->GetNextPageId() == INVALID_PAGE_ID && CanSplit(head, hash)) {
+      bool split = SplitBucket(head, hash);
+      buffer_pool_manager_->UnpinPage(head_page_id, true);
+      if (!split) {
+        break;
+      }
+      continue;
+    }
+    // keys sharing all their usable hash bits go to an overflow bucket
+    page_id_t overflow_page_id;
+    auto overflow_page = buffer_pool_manager_->NewPage(overflow_page_id);
+    if (overflow_page == nullptr) {
+      LOG(ERROR) << "get page failed" << std::endl;
+      buffer_pool_manager_->UnpinPage(head_page_id, false);
+      break;
+    }
+    auto overflow = reinterpret_cast<BucketPage *>(overflow_page->GetData());
+    overflow->Init(processor_.GetKeySize(), head->GetLocalDepth());
+    overflow->Insert(index_key, row_id);
+    buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+    auto last = last_page_id == head_page_id
+                    ? head
+                    : reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(last_page_id)->GetData());
+    last->SetNextPageId(overflow_page_id);
+    if (last_page_id != head_page_id) {
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+    }
+    buffer_pool_manager_->UnpinPage(head_page_id, true);
+    result = DB_SUCCESS;
+    break;
+  }
+  free(index_key);
+  return result;
+}
+
+dberr_t ExtendibleHashIndex::RemoveEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_KEY_NOT_FOUND;
+  }
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  dberr_t result = DB_KEY_NOT_FOUND;
+  for (page_id_t page_id = GetBucketPageId(processor_.HashKeyFields(index_key));
+       page_id != INVALID_PAGE_ID && result != DB_SUCCESS;) {
+    auto bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize(); i++) {
+      // entries of a non-unique key are told apart by their row id
+      if (processor_.CompareKeys(bucket->KeyAt(i), index_key) == 0 &&
+          (unique_ || bucket->ValueAt(i).Get() == row_id.Get())) {
+        bucket->RemoveAt(i);
+        result = DB_SUCCESS;
+        break;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, result == DB_SUCCESS);
+    page_id = next_page_id;
+  }
+  free(index_key);
+  return result;
+}
+
+dberr_t ExtendibleHashIndex::ScanKey(const Row &key, std::vector<RowId> &result, [[maybe_unused]] Transaction *txn,
+                                     string compare_operator) {
+  if (compare_operator != "=") {
+    LOG(WARNING) << "Hash index only supports equality." << std::endl;
+    return DB_FAILED;
+  }
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_KEY_NOT_FOUND;
+  }
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  size_t found = result.size();
+  for (page_id_t page_id = GetBucketPageId(processor_.HashKeyFields(index_key)); page_id != INVALID_PAGE_ID;) {
+    auto bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize(); i++) {
+      if (processor_.CompareKeys(bucket->KeyAt(i), index_key) == 0) {
+        result.push_back(bucket->ValueAt(i));
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  free(index_key);
+  if (result.size() > found)
+    return DB_SUCCESS;
+  else
+    return DB_KEY_NOT_FOUND;
+}
+
+dberr_t ExtendibleHashIndex::Destroy() {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  // several directory entries share a bucket, free every bucket chain once
+  std::unordered_set<page_id_t> buckets;
+  std::vector<page_id_t> pages(segment_page_ids_.begin(), segment_page_ids_.end());
+  for (auto segment_page_id : segment_page_ids_) {
+    auto segment = reinterpret_cast<page_id_t *>(buffer_pool_manager_->FetchPage(segment_page_id)->GetData());
+    uint32_t count = std::min(DirectoryPage::DIRECTORY_SEGMENT_SIZE, 1u << global_depth_);
+    buckets.insert(segment, segment + count);
+    buffer_pool_manager_->UnpinPage(segment_page_id, false);
+  }
+  // each bucket is read for the head of its overflow chain, then the chain is followed to its end
+  for (auto page_id : buckets) {
+    pages.push_back(page_id);
+    auto bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    while (next_page_id != INVALID_PAGE_ID) {
+      pages.push_back(next_page_id);
+      bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+      page_id_t overflow_page_id = next_page_id;
+      next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(overflow_page_id, false);
+    }
+  }
+  pages.push_back(directory_page_id_);
+  buffer_pool_manager_->DeletePages(pages);
+  auto roots = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  roots->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  directory_page_id_ = INVALID_PAGE_ID;
+  global_depth_ = 0;
+  segment_page_ids_.clear();
+  return DB_SUCCESS;
+}
+
+bool ExtendibleHashIndex::StartNewDirectory() {
+  page_id_t directory_page_id, segment_page_id, bucket_page_id;
+  auto directory_page = buffer_pool_manager_->NewPage(directory_page_id);
+  if (directory_page == nullptr) {
+    LOG(ERROR) << "get page failed" << std::endl;
+    return false;
+  }
+  auto segment_page = buffer_pool_manager_->NewPage(segment_page_id);
+  auto bucket_page = buffer_pool_manager_->NewPage(bucket_page_id);
+  if (segment_page == nullptr || bucket_page == nullptr) {
+    LOG(ERROR) << "get page failed" << std::endl;
+    return false;
+  }
+  auto bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+  bucket->Init(processor_.GetKeySize(), 0);
+  reinterpret_cast<page_id_t *>(segment_page->GetData())[0] = bucket_page_id;
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(segment_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  directory_page_id_ = directory_page_id;
+  global_depth_ = 0;
+  segment_page_ids_.push_back(segment_page_id);
+  FlushDirectory();
+  auto roots = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  roots->Insert(index_id_, directory_page_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  return true;
+}
+
+page_id_t ExtendibleHashIndex::GetBucketPageId(uint32_t hash) {
+  uint32_t directory_index = hash & ((1u << global_depth_) - 1);
+  page_id_t segment_page_id = segment_page_ids_[directory_index / DirectoryPage::DIRECTORY_SEGMENT_SIZE];
+  auto segment = reinterpret_cast<page_id_t *>(buffer_pool_manager_->FetchPage(segment_page_id)->GetData());
+  page_id_t bucket_page_id = segment[directory_index % DirectoryPage::DIRECTORY_SEGMENT_SIZE];
+  buffer_pool_manager_->UnpinPage(segment_page_id, false);
+  return bucket_page_id;
+}
+
+void ExtendibleHashIndex::SetBucketPageId(uint32_t directory_index, page_id_t bucket_page_id) {
+  page_id_t segment_page_id = segment_page_ids_[directory_index / DirectoryPage::DIRECTORY_SEGMENT_SIZE];
+  auto segment = reinterpret_cast<page_id_t *>(buffer_pool_manager_->FetchPage(segment_page_id)->GetData());
+  segment[directory_index % DirectoryPage::DIRECTORY_SEGMENT_SIZE] = bucket_page_id;
+  buffer_pool_manager_->UnpinPage(segment_page_id, true);
+}
+
+bool ExtendibleHashIndex::GrowDirectory() {
+  if (global_depth_ >= DirectoryPage::MAX_GLOBAL_DEPTH) {
+    return false;
+  }
+  uint32_t size = 1u << global_depth_;
+  if (size < DirectoryPage::DIRECTORY_SEGMENT_SIZE) {
+    // the doubled directory still fits the first segment
+    auto segment = reinterpret_cast<page_id_t *>(buffer_pool_manager_->FetchPage(segment_page_ids_[0])->GetData());
+    memcpy(segment + size, segment, size * sizeof(page_id_t));
+    buffer_pool_manager_->UnpinPage(segment_page_ids_[0], true);
+  } else {
+    // every segment gets a twin holding the same bucket page ids
+    size_t segment_count = segment_page_ids_.size();
+    for (size_t i = 0; i < segment_count; i++) {
+      page_id_t twin_page_id;
+      auto twin = buffer_pool_manager_->NewPage(twin_page_id);
+      if (twin == nullptr) {
+        LOG(ERROR) << "get page failed" << std::endl;
+        return false;
+      }
+      auto segment = buffer_pool_manager_->FetchPage(segment_page_ids_[i]);
+      memcpy(twin->GetData(), segment->GetData(), PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(segment_page_ids_[i], false);
+      buffer_pool_manager_->UnpinPage(twin_page_id, true);
+      segment_page_ids_.push_back(twin_page_id);
+    }
+  }
+  global_depth_++;
+  FlushDirectory();
+  return true;
+}
+
+bool ExtendibleHashIndex::CanSplit(BucketPage *bucket, uint32_t hash) {
+  uint32_t local_depth = bucket->GetLocalDepth();
+  if (local_depth >= DirectoryPage::MAX_GLOBAL_DEPTH) {
+    return false;
+  }
+  // the bits from local_depth up to the deepest directory are the ones a split may still use
+  uint32_t mask = ((1u << DirectoryPage::MAX_GLOBAL_DEPTH) - 1) & ~((1u << local_depth) - 1);
+  for (int i = 0; i < bucket->GetSize(); i++) {
+    if ((processor_.HashKeyFields(bucket->KeyAt(i)) ^ hash) & mask) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ExtendibleHashIndex::SplitBucket(BucketPage *bucket, uint32_t hash) {
+  uint32_t local_depth = bucket->GetLocalDepth();
+  if (local_depth == global_depth_ && !GrowDirectory()) {
+    return false;
+  }
+  page_id_t image_page_id;
+  auto image_page = buffer_pool_manager_->NewPage(image_page_id);
+  if (image_page == nullptr) {
+    LOG(ERROR) << "get page failed" << std::endl;
+    return false;
+  }
+  auto image = reinterpret_cast<BucketPage *>(image_page->GetData());
+  image->Init(processor_.GetKeySize(), local_depth + 1);
+  bucket->SetLocalDepth(local_depth + 1);
+  // keys with the new hash bit set move to the split image
+  for (int i = bucket->GetSize() - 1; i >= 0; i--) {
+    if ((processor_.HashKeyFields(bucket->KeyAt(i)) >> local_depth) & 1) {
+      image->Insert(bucket->KeyAt(i), bucket->ValueAt(i));
+      bucket->RemoveAt(i);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  // the directory entries of the old bucket that carry the new bit now point to the image
+  uint32_t first = (hash & ((1u << local_depth) - 1)) | (1u << local_depth);
+  for (uint32_t i = first; i < (1u << global_depth_); i += 1u << (local_depth + 1)) {
+    SetBucketPageId(i, image_page_id);
+  }
+  return true;
+}
+
+void ExtendibleHashIndex::FlushDirectory() {
+  auto directory = reinterpret_cast<DirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  directory->Init();
+  directory->SetGlobalDepth(global_depth_);
+  for (auto segment_page_id : segment_page_ids_) {
+    directory->AddSegment(segment_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
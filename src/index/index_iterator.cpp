@@ -7,7 +7,13 @@ IndexIterator::IndexIterator() = default;
 
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
+  if (current_page_id == INVALID_PAGE_ID) {
+    item_index = 0;
+    return;
+  }
   page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+  // a start position just past the last key of a leaf belongs to the next leaf
+  SkipExhaustedPages();
 }
 
 IndexIterator::~IndexIterator() {
@@ -20,22 +26,26 @@ std::pair<GenericKey *, RowId> IndexIterator::operator*() {
 }
 
 IndexIterator &IndexIterator::operator++() {
-  if(item_index==(page->GetSize()-1)){
-    if(page->GetNextPageId() != INVALID_PAGE_ID){
-      item_index = 0;
-      page_id_t next_page = page->GetNextPageId();
-      buffer_pool_manager->UnpinPage(current_page_id,false);
-      current_page_id = next_page;
+  item_index++;
+  SkipExhaustedPages();
+  return (*this);
+}
+
+/*
+ * Move to the first item of the next non-empty leaf while the current one is used up,
+ * turning into the end iterator after the last leaf.
+ */
+void IndexIterator::SkipExhaustedPages() {
+  while (current_page_id != INVALID_PAGE_ID && item_index >= page->GetSize()) {
+    page_id_t next_page = page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(current_page_id, false);
+    current_page_id = next_page;
+    item_index = 0;
+    page = nullptr;
+    if (current_page_id != INVALID_PAGE_ID) {
       page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
     }
-    else{
-      return (*this);
-    }
   }
-  else{
-    item_index++;
-  }
-  return (*this);
 }
 
 bool IndexIterator::operator==(const IndexIterator &itr) const {
@@ -38,6 +38,14 @@ int main(int argc, char **argv) {
   char cmd[buf_size];
   // executor engine
   ExecuteEngine engine;
+  // --csv or --tsv prints the rows of a select in that format instead of a table
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--csv") == 0) {
+      engine.SetOutputFormat(OutputFormat::Csv);
+    } else if (strcmp(argv[i], "--tsv") == 0) {
+      engine.SetOutputFormat(OutputFormat::Tsv);
+    }
+  }
   // for print syntax tree
   TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
   uint32_t syntax_tree_id = 0;
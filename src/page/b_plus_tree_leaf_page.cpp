@@ -123,7 +123,7 @@ int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM)
         SetSize(size + 1);
         return GetSize();
     }
-    if(KeyAt(old_value_index) == key){
+    if(KM.CompareKeys(KeyAt(old_value_index), key) == 0){
         return -1;//represent already have this key
     }
     if(old_value_index == INVALID_PAGE_ID){
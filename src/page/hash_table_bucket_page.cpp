@@ -0,0 +1,34 @@
+#include "page/hash_table_bucket_page.h"
+
+void HashTableBucketPage::Init(int key_size, uint32_t local_depth) {
+  key_size_ = key_size;
+  local_depth_ = local_depth;
+  size_ = 0;
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+GenericKey *HashTableBucketPage::KeyAt(int index) {
+  return reinterpret_cast<GenericKey *>(PairPtrAt(index));
+}
+
+RowId HashTableBucketPage::ValueAt(int index) const {
+  return *reinterpret_cast<const RowId *>(PairPtrAt(index) + key_size_);
+}
+
+bool HashTableBucketPage::Insert(const GenericKey *key, const RowId &value) {
+  if (IsFull()) {
+    return false;
+  }
+  char *pair = PairPtrAt(size_);
+  memcpy(pair, key, key_size_);
+  memcpy(pair + key_size_, &value, sizeof(RowId));
+  size_++;
+  return true;
+}
+
+void HashTableBucketPage::RemoveAt(int index) {
+  size_--;
+  if (index != size_) {
+    memcpy(PairPtrAt(index), PairPtrAt(size_), key_size_ + sizeof(RowId));
+  }
+}
@@ -577,11 +577,37 @@ char *yytext;
 #line 1 "minisql.l"
 #line 2 "minisql.l"
     #include <stdio.h>
+    #include <string.h>
     #include "parser/parser.h"
     #include "parser/minisql_yacc.h"
     int yywrap();
     extern YYSTYPE yylval;
-#line 585 "../../parser/minisql_lex.c"
+
+    /* keywords looked up by the identifier rule instead of getting a rule of their own */
+    static const struct {
+      const char *name;
+      int token;
+    } minisql_keywords[] = {
+      {"vacuum", VACUUM},
+      {"group", GROUP},
+      {"by", BY},
+      {"order", ORDER},
+      {"asc", ASC},
+      {"desc", DESC},
+      {"limit", LIMIT},
+      {"offset", OFFSET},
+      {"analyze", ANALYZE},
+    };
+
+    static int MinisqlKeyword(const char *text) {
+      for (size_t i = 0; i < sizeof(minisql_keywords) / sizeof(minisql_keywords[0]); i++) {
+        if (strcmp(text, minisql_keywords[i].name) == 0) {
+          return minisql_keywords[i].token;
+        }
+      }
+      return 0;
+    }
+#line 603 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
 
@@ -763,10 +789,10 @@ YY_DECL
 	register char *yy_cp, *yy_bp;
 	register int yy_act;
     
-#line 15 "minisql.l"
+#line 33 "minisql.l"
 
 
-#line 770 "../../parser/minisql_lex.c"
+#line 788 "../../parser/minisql_lex.c"
 
 	if ( !(yy_init) )
 		{
@@ -862,7 +888,7 @@ do_action:	/* This label is used only to access EOF actions. */
 case 1:
 /* rule 1 can match eol */
 YY_RULE_SETUP
-#line 17 "minisql.l"
+#line 35 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeString, yytext);
@@ -871,7 +897,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 23 "minisql.l"
+#line 41 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return CREATE;
@@ -879,7 +905,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 28 "minisql.l"
+#line 46 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DROP;
@@ -887,7 +913,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 33 "minisql.l"
+#line 51 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SELECT;
@@ -895,7 +921,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 38 "minisql.l"
+#line 56 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INSERT;
@@ -903,7 +929,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 43 "minisql.l"
+#line 61 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DELETE;
@@ -911,7 +937,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 48 "minisql.l"
+#line 66 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return UPDATE;
@@ -919,7 +945,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 53 "minisql.l"
+#line 71 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXBEGIN;
@@ -927,7 +953,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 58 "minisql.l"
+#line 76 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXCOMMIT;
@@ -935,7 +961,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 63 "minisql.l"
+#line 81 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TRXROLLBACK;
@@ -943,7 +969,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 68 "minisql.l"
+#line 86 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return QUIT;
@@ -951,7 +977,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 73 "minisql.l"
+#line 91 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EXECFILE;
@@ -959,7 +985,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 78 "minisql.l"
+#line 96 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SHOW;
@@ -967,7 +993,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 83 "minisql.l"
+#line 101 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return USE;
@@ -975,7 +1001,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 88 "minisql.l"
+#line 106 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return USING;
@@ -983,7 +1009,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 93 "minisql.l"
+#line 111 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DATABASE;
@@ -991,7 +1017,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 98 "minisql.l"
+#line 116 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return DATABASES;
@@ -999,7 +1025,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 103 "minisql.l"
+#line 121 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TABLE;
@@ -1007,7 +1033,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 108 "minisql.l"
+#line 126 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return TABLES;
@@ -1015,7 +1041,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 113 "minisql.l"
+#line 131 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INDEX;
@@ -1023,7 +1049,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 118 "minisql.l"
+#line 136 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INDEXES;
@@ -1031,7 +1057,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 123 "minisql.l"
+#line 141 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ON;
@@ -1039,7 +1065,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 128 "minisql.l"
+#line 146 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FROM;
@@ -1047,7 +1073,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 133 "minisql.l"
+#line 151 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return WHERE;
@@ -1055,7 +1081,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 138 "minisql.l"
+#line 156 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INTO;
@@ -1063,7 +1089,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 143 "minisql.l"
+#line 161 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return SET;
@@ -1071,7 +1097,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 148 "minisql.l"
+#line 166 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return VALUES;
@@ -1079,7 +1105,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 153 "minisql.l"
+#line 171 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return PRIMARY;
@@ -1087,7 +1113,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 158 "minisql.l"
+#line 176 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return KEY;
@@ -1095,7 +1121,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 163 "minisql.l"
+#line 181 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return UNIQUE;
@@ -1103,7 +1129,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 168 "minisql.l"
+#line 186 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return CHAR;
@@ -1111,7 +1137,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 173 "minisql.l"
+#line 191 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return INT;
@@ -1119,7 +1145,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 178 "minisql.l"
+#line 196 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FLOAT;
@@ -1127,7 +1153,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 183 "minisql.l"
+#line 201 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return AND;
@@ -1135,7 +1161,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 188 "minisql.l"
+#line 206 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return OR;
@@ -1143,7 +1169,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 193 "minisql.l"
+#line 211 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NOT;
@@ -1151,7 +1177,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 198 "minisql.l"
+#line 216 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return IS;
@@ -1159,7 +1185,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 203 "minisql.l"
+#line 221 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return FLAGNULL;
@@ -1167,16 +1193,20 @@ YY_RULE_SETUP
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 208 "minisql.l"
+#line 226 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
+  int keyword = MinisqlKeyword(yytext);
+  if (keyword != 0) {
+    return keyword;
+  }
   yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
   return IDENTIFIER;
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 236 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1185,7 +1215,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 242 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1194,7 +1224,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 248 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EQ;
@@ -1202,7 +1232,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 253 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NE;
@@ -1210,7 +1240,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 258 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return LE;
@@ -1218,7 +1248,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 263 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return GE;
@@ -1226,7 +1256,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 268 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (',');
@@ -1234,7 +1264,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 273 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('*');
@@ -1242,7 +1272,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 278 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (';');
@@ -1250,7 +1280,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 283 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('\'');
@@ -1258,7 +1288,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 288 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('<');
@@ -1266,7 +1296,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 293 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('>');
@@ -1274,7 +1304,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 298 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('(');
@@ -1282,7 +1312,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 303 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (')');
@@ -1291,15 +1321,20 @@ YY_RULE_SETUP
 case 54:
 /* rule 54 can match eol */
 YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 308 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
 }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 312 "minisql.l"
 {
+  /* a lone dot only separates a table from its column, any other stray character is an error */
+  if (yytext[0] == '.') {
+    MinisqlParserMovePos(yylineno, yytext);
+    return ('.');
+  }
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
   MinisqlParserSetError(str);
@@ -1307,10 +1342,10 @@ YY_RULE_SETUP
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 323 "minisql.l"
 ECHO;
 	YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1341 "../../parser/minisql_lex.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2319,7 +2354,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 323 "minisql.l"
 
 
 int yywrap() {
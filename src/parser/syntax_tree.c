@@ -163,12 +163,26 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeCreateIndex";
     case kNodeDropIndex:
       return "kNodeDropIndex";
+    case kNodeVacuumIndex:
+      return "kNodeVacuumIndex";
     case kNodeTrxBegin:
       return "kNodeTrxBegin";
     case kNodeTrxCommit:
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeAggregate:
+      return "kNodeAggregate";
+    case kNodeGroupBy:
+      return "kNodeGroupBy";
+    case kNodeOrderBy:
+      return "kNodeOrderBy";
+    case kNodeOrderItem:
+      return "kNodeOrderItem";
+    case kNodeLimit:
+      return "kNodeLimit";
+    case kNodeAnalyze:
+      return "kNodeAnalyze";
     default:
       return "error type";
   }
@@ -2,6 +2,10 @@
 // Created by njz on 2023/2/2.
 //
 #include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <thread>
 #include "planner/planner.h"
 
 void Planner::PlanQuery(pSyntaxNode ast) {
@@ -35,25 +39,607 @@ void Planner::PlanQuery(pSyntaxNode ast) {
   }
 }
 AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> statement) {
-  auto out_schema = MakeOutputSchema(statement->column_list_);
+  if (statement->limit_ != LimitPlanNode::kNoLimit || statement->offset_ > 0) {
+    return PlanLimit(statement);
+  }
+  if (!statement->order_by_.empty()) {
+    return PlanSort(statement, SortPlanNode::kNoLimit);
+  }
+  if (statement->IsAggregation()) {
+    return PlanAggregation(statement);
+  }
+  if (statement->table_names_.size() > 1) {
+    return PlanJoin(statement);
+  }
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(statement->table_name_, info);
+  // the scan finds its columns by name, a qualified name in the select list is the plain column for it
+  auto columns = statement->column_list_;
+  vector<uint32_t> output_columns;
+  for (auto &column : columns) {
+    output_columns.push_back(dynamic_pointer_cast<ColumnValueExpression>(column.second)->GetColIdx());
+    column.first = info->GetSchema()->GetColumn(output_columns.back())->GetName();
+  }
+  return PlanScan(statement->table_name_, MakeOutputSchema(columns), statement->where_, output_columns);
+}
+
+AbstractPlanNodeRef Planner::PlanAggregation(std::shared_ptr<SelectStatement> statement) {
+  // the input of the aggregation selects each column it reads once, count(*) alone reads none
+  auto input = std::make_shared<SelectStatement>(*statement);
+  input->column_list_.clear();
+  input->group_by_.clear();
+  auto input_column = [&input](const AbstractExpressionRef &expr) {
+    auto column = dynamic_pointer_cast<ColumnValueExpression>(expr);
+    auto &columns = input->column_list_;
+    auto found = std::find_if(columns.begin(), columns.end(), [&column](const auto &input_column) {
+      auto selected = dynamic_pointer_cast<ColumnValueExpression>(input_column.second);
+      return selected->GetRowIdx() == column->GetRowIdx() && selected->GetColIdx() == column->GetColIdx();
+    });
+    uint32_t position = found - columns.begin();
+    if (found == columns.end()) {
+      columns.emplace_back("#" + std::to_string(position), column);
+    }
+    return std::make_shared<ColumnValueExpression>(0, position, column->GetReturnType());
+  };
+  vector<AbstractExpressionRef> group_bys, aggregates, output_exprs;
+  for (const auto &group_by : statement->group_by_) {
+    group_bys.push_back(input_column(group_by));
+  }
+  // the aggregated row holds the group by columns followed by the aggregates
+  for (const auto &column : statement->column_list_) {
+    auto type = column.second->GetReturnType();
+    auto aggregate = dynamic_pointer_cast<AggregateExpression>(column.second);
+    if (aggregate != nullptr) {
+      auto arg = aggregate->GetChildren().empty() ? nullptr : input_column(aggregate->GetChildAt(0));
+      aggregates.push_back(std::make_shared<AggregateExpression>(aggregate->GetAggregationType(), arg));
+      output_exprs.push_back(
+          std::make_shared<ColumnValueExpression>(0, group_bys.size() + aggregates.size() - 1, type));
+      continue;
+    }
+    auto grouped = dynamic_pointer_cast<ColumnValueExpression>(input_column(column.second));
+    auto group_by = std::find_if(group_bys.begin(), group_bys.end(), [&grouped](const AbstractExpressionRef &expr) {
+      return dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx() == grouped->GetColIdx();
+    });
+    output_exprs.push_back(std::make_shared<ColumnValueExpression>(0, group_by - group_bys.begin(), type));
+  }
+  vector<std::pair<std::string, AbstractExpressionRef>> output_columns;
+  for (size_t i = 0; i < output_exprs.size(); i++) {
+    output_columns.emplace_back(statement->column_list_[i].first, output_exprs[i]);
+  }
+  return std::make_shared<AggregationPlanNode>(MakeOutputSchema(output_columns), PlanSelect(input), group_bys,
+                                               aggregates, output_exprs);
+}
+
+AbstractPlanNodeRef Planner::PlanLimit(std::shared_ptr<SelectStatement> statement) {
+  auto input = std::make_shared<SelectStatement>(*statement);
+  input->limit_ = LimitPlanNode::kNoLimit;
+  input->offset_ = 0;
+  size_t offset = statement->offset_, limit = statement->limit_;
+  AbstractPlanNodeRef child;
+  if (!input->order_by_.empty()) {
+    bool bounded = limit != LimitPlanNode::kNoLimit && limit < SortPlanNode::kNoLimit - offset;
+    child = PlanSort(input, bounded ? offset + limit : SortPlanNode::kNoLimit);
+  } else {
+    child = PlanSelect(input);
+  }
+  auto scan = dynamic_pointer_cast<const SeqScanPlanNode>(child);
+  if (scan != nullptr && scan->parallel_) {
+    child = std::make_shared<SeqScanPlanNode>(scan->OutputSchema(), scan->GetTableName(), scan->GetPredicate());
+  }
+  return std::make_shared<LimitPlanNode>(child->OutputSchema(), child, offset, limit);
+}
+
+AbstractPlanNodeRef Planner::PlanSort(std::shared_ptr<SelectStatement> statement, size_t limit) {
+  auto input = std::make_shared<SelectStatement>(*statement);
+  input->order_by_.clear();
+  auto child = PlanSelect(input);
+  size_t column_count = statement->column_list_.size() - statement->order_by_columns_;
+  if (IsIndexOrdered(child, statement)) {
+    // the index gives the order, the columns only read by the sort are not needed
+    input->column_list_.resize(column_count);
+    input->order_by_columns_ = 0;
+    auto ordered = PlanSelect(input);
+    // with fewer columns read the scan may use another index, the rows then still need sorting
+    if (IsIndexOrdered(ordered, statement)) {
+      auto scan = dynamic_pointer_cast<const IndexScanPlanNode>(ordered);
+      return make_shared<IndexScanPlanNode>(scan->OutputSchema(), scan->table_name_, scan->indexes_,
+                                            scan->need_filter_, scan->filter_predicate_, scan->key_predicates_,
+                                            scan->index_only_, scan->probe_groups_, true);
+    }
+  }
+  std::vector<Column *> columns;
+  for (size_t i = 0; i < column_count; i++) {
+    columns.push_back(new Column(child->OutputSchema()->GetColumn(i)));
+  }
+  return std::make_shared<SortPlanNode>(new Schema(columns), child, statement->order_by_, limit);
+}
+
+bool Planner::IsIndexOrdered(const AbstractPlanNodeRef &plan, const std::shared_ptr<SelectStatement> &statement) {
+  auto scan = dynamic_pointer_cast<const IndexScanPlanNode>(plan);
+  if (scan == nullptr || scan->indexes_.size() != 1 || scan->indexes_[0]->GetIndexType() != "bptree") {
+    return false;
+  }
+  auto key_columns = scan->indexes_[0]->GetIndexKeySchema()->GetColumns();
+  // the equalities fix a leading run of key columns, the rows come out in the order of the columns after it
+  size_t fixed = std::count_if(scan->key_predicates_[0].begin(), scan->key_predicates_[0].end(),
+                               [](const AbstractExpressionRef &predicate) {
+                                 return dynamic_pointer_cast<ComparisonExpression>(predicate)->GetComparisonType() ==
+                                        "=";
+                               });
+  size_t next = fixed;
+  for (const auto &order_by : statement->order_by_) {
+    if (order_by.first != OrderByType::Asc) {
+      return false;
+    }
+    auto position = dynamic_pointer_cast<ColumnValueExpression>(order_by.second)->GetColIdx();
+    auto col_idx = dynamic_pointer_cast<ColumnValueExpression>(statement->column_list_[position].second)->GetColIdx();
+    auto is_key = [&key_columns, col_idx](size_t k) { return key_columns[k]->GetTableInd() == col_idx; };
+    bool is_fixed = false;
+    for (size_t k = 0; k < fixed; k++) {
+      is_fixed = is_fixed || is_key(k);
+    }
+    if (is_fixed) {
+      continue;
+    }
+    if (next == key_columns.size() || !is_key(next)) {
+      return false;
+    }
+    next++;
+  }
+  return true;
+}
+
+AbstractPlanNodeRef Planner::PlanScan(const std::string &table_name, const Schema *out_schema,
+                                      const AbstractExpressionRef &predicate, const vector<uint32_t> &output_columns,
+                                      bool read_only) {
+  // an access path scans one index for comparisons of the predicate, or one index per part of an OR of it
+  // and unites their row ids
+  struct AccessPath {
+    vector<IndexInfo *> indexes;
+    vector<vector<AbstractExpressionRef>> key_predicates;
+    bool disjunction;
+    // the rows the path finds, and the cost of finding them
+    double found;
+    double probe_cost;
+  };
   vector<IndexInfo *> indexes;
-  vector<IndexInfo *> available_index;
-  context_->GetCatalog()->GetTableIndexes(statement->table_name_, indexes);
+  vector<AbstractExpressionRef> conjuncts, parts;
+  bool only_conjuncts = predicate != nullptr && CollectConjuncts(predicate, conjuncts);
+  if (predicate != nullptr) {
+    SplitConjunction(predicate, parts);
+  }
+  context_->GetCatalog()->GetTableIndexes(table_name, indexes);
+  double pages, rows;
+  GetTableSize(table_name, &pages, &rows);
+  // a unique key found whole matches at most one row
+  auto probe_rows = [&](IndexInfo *index, const vector<AbstractExpressionRef> &matched) {
+    double found = rows * EstimateSelectivity(table_name, matched);
+    bool whole_key = matched.size() == index->GetIndexKeySchema()->GetColumnCount() &&
+                     std::all_of(matched.begin(), matched.end(), [](const AbstractExpressionRef &expr) {
+                       return dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType() == "=";
+                     });
+    return whole_key && index->IsUnique() ? std::min(found, 1.0) : found;
+  };
+  vector<AccessPath> paths;
   for (auto index : indexes) {
-    if (index->GetIndexKeySchema()->GetColumns().size() == 1) {
-      auto col_id = index->GetIndexKeySchema()->GetColumn(0)->GetTableInd();
-      if (std::find(statement->column_in_condition_.begin(), statement->column_in_condition_.end(), col_id) !=
-          statement->column_in_condition_.end()) {
-        available_index.push_back(index);
+    auto matched = MatchIndexPrefix(index, conjuncts);
+    if (!matched.empty()) {
+      double found = probe_rows(index, matched);
+      paths.push_back({{index}, {std::move(matched)}, false, found, IndexProbeCost(index, found, rows)});
+    }
+  }
+  // an OR is answered by indexes when each of its parts has one for the comparisons ANDed in it, each part
+  // scanning its cheapest
+  for (const auto &part : parts) {
+    vector<AbstractExpressionRef> disjuncts;
+    SplitDisjunction(part, disjuncts);
+    if (disjuncts.size() < 2) {
+      continue;
+    }
+    AccessPath path{{}, {}, true, 0, 0};
+    double missed = 1;
+    for (const auto &disjunct : disjuncts) {
+      vector<AbstractExpressionRef> comparisons;
+      CollectConjuncts(disjunct, comparisons);
+      IndexInfo *best = nullptr;
+      vector<AbstractExpressionRef> best_matched;
+      double best_found = 0, best_cost = 0;
+      for (auto index : indexes) {
+        auto matched = MatchIndexPrefix(index, comparisons);
+        if (matched.empty()) {
+          continue;
+        }
+        double found = probe_rows(index, matched);
+        double cost = IndexProbeCost(index, found, rows);
+        if (best == nullptr || cost < best_cost) {
+          best = index;
+          best_matched = std::move(matched);
+          best_found = found;
+          best_cost = cost;
+        }
+      }
+      if (best == nullptr) {
+        path.indexes.clear();
+        break;
+      }
+      path.indexes.push_back(best);
+      path.key_predicates.push_back(std::move(best_matched));
+      path.probe_cost += best_cost;
+      missed *= 1 - std::min(best_found / std::max(rows, 1.0), 1.0);
+    }
+    if (!path.indexes.empty()) {
+      path.found = rows * (1 - missed);
+      paths.push_back(std::move(path));
+    }
+  }
+  // a scan only for reading spreads over the cores when there are several
+  auto seq_scan = [&]() {
+    return make_shared<SeqScanPlanNode>(out_schema, table_name, predicate,
+                                        read_only && std::thread::hardware_concurrency() > 1);
+  };
+  if (paths.empty()) {
+    return seq_scan();
+  }
+  vector<vector<uint32_t>> read_columns(1, output_columns);
+  if (predicate != nullptr) {
+    CollectColumns(predicate, read_columns);
+  }
+  // a B+ tree whose key holds every column the query reads answers it without touching the table heap
+  auto covers = [&read_columns](const AccessPath &path) {
+    if (path.disjunction || path.indexes[0]->GetIndexType() != "bptree") {
+      return false;
+    }
+    auto key_columns = path.indexes[0]->GetIndexKeySchema()->GetColumns();
+    return std::all_of(read_columns[0].begin(), read_columns[0].end(), [&key_columns](uint32_t col_idx) {
+      return std::any_of(key_columns.begin(), key_columns.end(),
+                         [col_idx](const Column *column) { return column->GetTableInd() == col_idx; });
+    });
+  };
+  // a sequential scan reads every page once and checks every row
+  double best_cost = pages + rows * COST_ROW;
+  vector<size_t> chosen;
+  bool index_only = false;
+  for (size_t i = 0; i < paths.size(); i++) {
+    bool covering = covers(paths[i]);
+    double cost = paths[i].probe_cost + (covering ? paths[i].found * COST_ROW : HeapFetchCost(pages, paths[i].found));
+    if (cost < best_cost) {
+      best_cost = cost;
+      chosen = {i};
+      index_only = covering;
+    }
+  }
+  if (chosen.empty()) {
+    return seq_scan();
+  }
+  // the row ids of another path are intersected in when the heap fetches they save cost more than their probes,
+  // the most selective paths are tried first
+  if (!index_only) {
+    vector<size_t> order(paths.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&paths](size_t a, size_t b) { return paths[a].found < paths[b].found; });
+    // the comparisons the chosen paths answer, and the share of the rows their ORs keep
+    vector<AbstractExpressionRef> used;
+    double or_share = 1;
+    auto add_path = [&](const AccessPath &path, vector<AbstractExpressionRef> *with, double *share) {
+      if (path.disjunction) {
+        *share *= path.found / std::max(rows, 1.0);
+        return;
+      }
+      for (const auto &expr : path.key_predicates[0]) {
+        if (std::find(with->begin(), with->end(), expr) == with->end()) {
+          with->push_back(expr);
+        }
+      }
+    };
+    add_path(paths[chosen[0]], &used, &or_share);
+    double chosen_probe_cost = paths[chosen[0]].probe_cost;
+    for (auto i : order) {
+      if (i == chosen[0]) {
+        continue;
+      }
+      auto with = used;
+      double share = or_share;
+      add_path(paths[i], &with, &share);
+      double matched = std::min(rows * EstimateSelectivity(table_name, with) * share, paths[chosen[0]].found);
+      double cost = chosen_probe_cost + paths[i].probe_cost + HeapFetchCost(pages, matched);
+      if (cost < best_cost) {
+        best_cost = cost;
+        chosen.push_back(i);
+        chosen_probe_cost += paths[i].probe_cost;
+        used = std::move(with);
+        or_share = share;
       }
     }
   }
-  if (available_index.empty() || statement->has_or) {
-    return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+  vector<IndexInfo *> chosen_indexes;
+  vector<vector<AbstractExpressionRef>> key_predicates;
+  vector<uint32_t> probe_groups;
+  size_t matched_count = 0;
+  for (uint32_t group = 0; group < chosen.size(); group++) {
+    const auto &path = paths[chosen[group]];
+    for (size_t k = 0; k < path.indexes.size(); k++) {
+      chosen_indexes.push_back(path.indexes[k]);
+      key_predicates.push_back(path.key_predicates[k]);
+      probe_groups.push_back(group);
+      matched_count += path.key_predicates[k].size();
+    }
   }
-  return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index,
-                                        available_index.size() != statement->column_in_condition_.size(),
-                                        statement->where_);
+  // every comparison consumed by exactly one index scan means the rows need no further check
+  bool need_filter = !only_conjuncts || chosen_indexes.size() > 1 || matched_count != conjuncts.size();
+  return make_shared<IndexScanPlanNode>(out_schema, table_name, chosen_indexes, need_filter, predicate,
+                                        key_predicates, index_only, probe_groups);
+}
+
+AbstractPlanNodeRef Planner::PlanJoin(std::shared_ptr<SelectStatement> statement) {
+  size_t table_count = statement->table_names_.size();
+  vector<AbstractExpressionRef> parts;
+  if (statement->where_ != nullptr) {
+    SplitConjunction(statement->where_, parts);
+  }
+  // each part of the where clause is checked as soon as every table it reads is joined: a part of a
+  // single table filters its scan, a part reading table m is checked by the join adding table m
+  vector<vector<AbstractExpressionRef>> scan_predicates(table_count);
+  vector<vector<AbstractExpressionRef>> outer_keys(table_count), inner_keys(table_count);
+  vector<vector<AbstractExpressionRef>> join_predicates(table_count);
+  vector<vector<uint32_t>> read_columns(table_count);
+  for (const auto &column : statement->column_list_) {
+    CollectColumns(column.second, read_columns);
+  }
+  for (const auto &part : parts) {
+    vector<vector<uint32_t>> columns(table_count);
+    CollectColumns(part, columns);
+    size_t tables = 0, last = 0;
+    for (size_t i = 0; i < table_count; i++) {
+      if (!columns[i].empty()) {
+        tables++;
+        last = i;
+      }
+    }
+    if (tables == 1) {
+      scan_predicates[last].push_back(RebindColumns(part, [](const std::shared_ptr<ColumnValueExpression> &column) {
+        return std::make_shared<ColumnValueExpression>(0, column->GetColIdx(), column->GetReturnType());
+      }));
+      continue;
+    }
+    for (size_t i = 0; i < table_count; i++) {
+      read_columns[i].insert(read_columns[i].end(), columns[i].begin(), columns[i].end());
+    }
+    // an equality between a column of table last and a column of a table joined before is a key of the join
+    if (part->GetType() == ExpressionType::ComparisonExpression &&
+        dynamic_pointer_cast<ComparisonExpression>(part)->GetComparisonType() == "=") {
+      auto lhs = dynamic_pointer_cast<ColumnValueExpression>(part->GetChildAt(0));
+      auto rhs = dynamic_pointer_cast<ColumnValueExpression>(part->GetChildAt(1));
+      if (lhs != nullptr && rhs != nullptr && (lhs->GetRowIdx() == last) != (rhs->GetRowIdx() == last)) {
+        outer_keys[last].push_back(lhs->GetRowIdx() == last ? rhs : lhs);
+        inner_keys[last].push_back(lhs->GetRowIdx() == last ? lhs : rhs);
+        continue;
+      }
+    }
+    join_predicates[last].push_back(part);
+  }
+
+  // every table is read for the columns the joins and the select list use
+  vector<Schema *> scan_schemas;
+  vector<double> table_rows, table_sizes, table_pages;
+  for (size_t i = 0; i < table_count; i++) {
+    auto &table_columns = read_columns[i];
+    std::sort(table_columns.begin(), table_columns.end());
+    table_columns.erase(std::unique(table_columns.begin(), table_columns.end()), table_columns.end());
+    if (table_columns.empty()) {
+      // a table only multiplying the rows still needs a column to produce them
+      table_columns.push_back(0);
+    }
+    TableInfo *info = nullptr;
+    context_->GetCatalog()->GetTable(statement->table_names_[i], info);
+    vector<std::pair<std::string, AbstractExpressionRef>> columns;
+    for (auto col_idx : table_columns) {
+      auto column = info->GetSchema()->GetColumn(col_idx);
+      columns.emplace_back(column->GetName(), std::make_shared<ColumnValueExpression>(0, col_idx, column->GetType()));
+    }
+    scan_schemas.push_back(MakeOutputSchema(columns));
+    double pages, rows;
+    GetTableSize(statement->table_names_[i], &pages, &rows);
+    table_pages.push_back(pages);
+    table_sizes.push_back(rows);
+    table_rows.push_back(rows * EstimateSelectivity(statement->table_names_[i], scan_predicates[i]));
+  }
+
+  // a left deep tree of joins, the rows of the left side hold the columns of the tables joined so far
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> left_layout;
+  vector<std::pair<std::string, AbstractExpressionRef>> left_columns;
+  auto add_columns = [&](uint32_t table, uint32_t row_idx, bool full_row) {
+    TableInfo *info = nullptr;
+    context_->GetCatalog()->GetTable(statement->table_names_[table], info);
+    for (uint32_t j = 0; j < read_columns[table].size(); j++) {
+      auto column = info->GetSchema()->GetColumn(read_columns[table][j]);
+      left_layout[{table, read_columns[table][j]}] = left_columns.size();
+      left_columns.emplace_back(statement->table_names_[table] + "." + column->GetName(),
+                                std::make_shared<ColumnValueExpression>(row_idx, full_row ? column->GetTableInd() : j,
+                                                                        column->GetType()));
+    }
+  };
+  add_columns(0, 0, false);
+  AbstractPlanNodeRef plan = PlanScan(statement->table_names_[0], scan_schemas[0],
+                                      MakeConjunction(scan_predicates[0]), read_columns[0]);
+  double outer_rows = table_rows[0];
+  for (uint32_t m = 1; m < table_count; m++) {
+    // few outer rows look their matches up in an index of table m rather than have all of it read
+    vector<size_t> index_keys;
+    IndexInfo *index = MatchJoinIndex(statement->table_names_[m], inner_keys[m], &index_keys);
+    if (index != nullptr) {
+      double matches = table_sizes[m];
+      for (auto k : index_keys) {
+        auto inner = dynamic_pointer_cast<ColumnValueExpression>(inner_keys[m][k]);
+        matches *= EstimateEqualSelectivity(statement->table_names_[m], inner->GetColIdx());
+      }
+      if (index->IsUnique() && index_keys.size() == index->GetIndexKeySchema()->GetColumnCount()) {
+        matches = std::min(matches, 1.0);
+      }
+      double probe_cost =
+          outer_rows * (IndexProbeCost(index, matches, table_sizes[m]) + HeapFetchCost(table_pages[m], matches));
+      double hash_cost = table_pages[m] + (table_sizes[m] + outer_rows) * COST_ROW;
+      if (probe_cost >= hash_cost) {
+        // every key goes to the hash join then
+        index = nullptr;
+        index_keys.clear();
+      }
+    }
+    // the right side is table m as scanned, or its full rows fetched through the index
+    auto bind = [&](const std::shared_ptr<ColumnValueExpression> &column) {
+      if (column->GetRowIdx() == m) {
+        auto &right_columns = read_columns[m];
+        uint32_t position =
+            std::lower_bound(right_columns.begin(), right_columns.end(), column->GetColIdx()) - right_columns.begin();
+        return std::make_shared<ColumnValueExpression>(1, index != nullptr ? column->GetColIdx() : position,
+                                                       column->GetReturnType());
+      }
+      return std::make_shared<ColumnValueExpression>(0, left_layout.at({column->GetRowIdx(), column->GetColIdx()}),
+                                                     column->GetReturnType());
+    };
+    vector<AbstractExpressionRef> left_keys, right_keys, predicates;
+    for (size_t k = 0; k < outer_keys[m].size(); k++) {
+      if (index == nullptr) {
+        left_keys.push_back(RebindColumns(outer_keys[m][k], bind));
+        right_keys.push_back(RebindColumns(inner_keys[m][k], bind));
+      } else if (std::find(index_keys.begin(), index_keys.end(), k) == index_keys.end()) {
+        // an equality the index does not look up is checked on the joined rows
+        predicates.push_back(std::make_shared<ComparisonExpression>(RebindColumns(outer_keys[m][k], bind),
+                                                                    RebindColumns(inner_keys[m][k], bind), "="));
+      }
+    }
+    // the index is looked up with the values of its key columns, in key order
+    for (auto k : index_keys) {
+      left_keys.push_back(RebindColumns(outer_keys[m][k], bind));
+    }
+    for (const auto &predicate : join_predicates[m]) {
+      predicates.push_back(RebindColumns(predicate, bind));
+    }
+    vector<AbstractExpressionRef> output_exprs;
+    const Schema *out_schema;
+    if (m + 1 == table_count) {
+      for (const auto &column : statement->column_list_) {
+        output_exprs.push_back(RebindColumns(column.second, bind));
+      }
+      out_schema = MakeOutputSchema(statement->column_list_);
+    } else {
+      // the columns of the left side stay in place, those of table m follow
+      for (uint32_t i = 0; i < left_columns.size(); i++) {
+        left_columns[i].second =
+            std::make_shared<ColumnValueExpression>(0, i, left_columns[i].second->GetReturnType());
+      }
+      add_columns(m, 1, index != nullptr);
+      for (const auto &column : left_columns) {
+        output_exprs.push_back(column.second);
+      }
+      out_schema = MakeOutputSchema(left_columns);
+    }
+    if (index != nullptr) {
+      plan = make_shared<IndexNestedLoopJoinPlanNode>(out_schema, plan, statement->table_names_[m], index, left_keys,
+                                                      MakeConjunction(scan_predicates[m]),
+                                                      MakeConjunction(predicates), output_exprs);
+    } else {
+      auto scan = PlanScan(statement->table_names_[m], scan_schemas[m], MakeConjunction(scan_predicates[m]),
+                           read_columns[m]);
+      plan = make_shared<HashJoinPlanNode>(out_schema, plan, scan, left_keys, right_keys, MakeConjunction(predicates),
+                                           output_exprs);
+    }
+    // a key of a unique index matches at most one row, with statistics a pair of rows agrees on a key column
+    // as often as one value of the side with more distinct values comes up, without them the keys are taken
+    // to match like a foreign key
+    vector<size_t> unique_keys;
+    auto unique_index = MatchJoinIndex(statement->table_names_[m], inner_keys[m], &unique_keys);
+    double key_selectivity = 1;
+    bool analyzed = false;
+    for (size_t k = 0; k < outer_keys[m].size(); k++) {
+      auto outer = dynamic_pointer_cast<ColumnValueExpression>(outer_keys[m][k]);
+      auto inner = dynamic_pointer_cast<ColumnValueExpression>(inner_keys[m][k]);
+      double distinct = std::max(GetDistinctValues(statement->table_names_[outer->GetRowIdx()], outer->GetColIdx()),
+                                 GetDistinctValues(statement->table_names_[m], inner->GetColIdx()));
+      if (distinct >= 1) {
+        key_selectivity /= distinct;
+        analyzed = true;
+      }
+    }
+    if (unique_index != nullptr && unique_index->IsUnique() &&
+        unique_keys.size() == unique_index->GetIndexKeySchema()->GetColumnCount()) {
+      outer_rows *= EstimateSelectivity(statement->table_names_[m], scan_predicates[m]);
+    } else if (analyzed) {
+      outer_rows *= table_rows[m] * key_selectivity;
+    } else if (!outer_keys[m].empty()) {
+      outer_rows = std::max(outer_rows, table_rows[m]);
+    } else {
+      outer_rows *= table_rows[m];
+    }
+  }
+  return plan;
+}
+
+bool Planner::CollectConjuncts(const AbstractExpressionRef &predicate, vector<AbstractExpressionRef> &conjuncts) {
+  if (predicate->GetType() == ExpressionType::ComparisonExpression) {
+    conjuncts.push_back(predicate);
+    return true;
+  }
+  if (predicate->GetType() == ExpressionType::LogicExpression &&
+      dynamic_pointer_cast<LogicExpression>(predicate)->logic_type_ == LogicType::And) {
+    bool only_conjuncts = true;
+    for (const auto &child : predicate->GetChildren()) {
+      only_conjuncts = CollectConjuncts(child, conjuncts) && only_conjuncts;
+    }
+    return only_conjuncts;
+  }
+  return false;
+}
+
+vector<AbstractExpressionRef> Planner::MatchIndexPrefix(IndexInfo *index,
+                                                        const vector<AbstractExpressionRef> &conjuncts) {
+  vector<AbstractExpressionRef> matched;
+  for (auto key_column : index->GetIndexKeySchema()->GetColumns()) {
+    AbstractExpressionRef equal = nullptr, lower = nullptr, upper = nullptr;
+    for (const auto &expr : conjuncts) {
+      auto column = dynamic_pointer_cast<ColumnValueExpression>(expr->GetChildAt(0));
+      auto constant = dynamic_pointer_cast<ConstantValueExpression>(expr->GetChildAt(1));
+      if (column == nullptr || constant == nullptr || constant->val_.IsNull() ||
+          column->GetColIdx() != key_column->GetTableInd()) {
+        continue;
+      }
+      // a string wider than the key column cannot be encoded into a key, leave it to the filter
+      if (constant->val_.GetTypeId() == TypeId::kTypeChar && constant->val_.GetLength() > key_column->GetLength()) {
+        continue;
+      }
+      auto op = dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+      if (op == "=" && equal == nullptr) {
+        equal = expr;
+      } else if ((op == ">" || op == ">=") && lower == nullptr) {
+        lower = expr;
+      } else if ((op == "<" || op == "<=") && upper == nullptr) {
+        upper = expr;
+      }
+    }
+    if (equal != nullptr) {
+      matched.push_back(equal);
+      continue;
+    }
+    // a range ends the usable prefix, later key columns are no longer ordered
+    if (lower != nullptr) {
+      matched.push_back(lower);
+    }
+    if (upper != nullptr) {
+      matched.push_back(upper);
+    }
+    break;
+  }
+  // a hash index answers equality on its whole key and nothing else, an ART index is only used for it
+  if (index->GetIndexType() != "bptree") {
+    bool whole_key = matched.size() == index->GetIndexKeySchema()->GetColumnCount() &&
+                     std::all_of(matched.begin(), matched.end(), [](const AbstractExpressionRef &expr) {
+                       return dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType() == "=";
+                     });
+    if (!whole_key) {
+      matched.clear();
+    }
+  }
+  return matched;
 }
 
 AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> statement) {
@@ -64,18 +650,28 @@ AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> stateme
 AbstractPlanNodeRef Planner::PlanDelete(std::shared_ptr<DeleteStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
-  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
+  auto scan_plan = PlanModifiedRows(statement->table_name_, statement->where_);
   return std::make_shared<DeletePlanNode>(info->GetSchema(), scan_plan, statement->table_name_);
 }
 
 AbstractPlanNodeRef Planner::PlanUpdate(std::shared_ptr<UpdateStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
-  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
+  auto scan_plan = PlanModifiedRows(statement->table_name_, statement->where_);
   return std::make_shared<UpdatePlanNode>(info->GetSchema(), scan_plan, statement->table_name_,
                                           statement->update_attrs);
 }
 
+AbstractPlanNodeRef Planner::PlanModifiedRows(const std::string &table_name, const AbstractExpressionRef &predicate) {
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(table_name, info);
+  // the rows are found like those of a select, read whole to maintain the indexes. The index scan collects
+  // its row ids before the first row changes, a changed row is never found again
+  vector<uint32_t> columns(info->GetSchema()->GetColumnCount());
+  std::iota(columns.begin(), columns.end(), 0);
+  return PlanScan(table_name, info->GetSchema(), predicate, columns, false);
+}
+
 Schema *Planner::MakeOutputSchema(const vector<std::pair<std::string, AbstractExpressionRef>> &exprs) {
   std::vector<Column *> cols;
   cols.reserve(exprs.size());
@@ -90,3 +686,224 @@ Schema *Planner::MakeOutputSchema(const vector<std::pair<std::string, AbstractEx
   }
   return new Schema(cols);
 }
+
+void Planner::SplitConjunction(const AbstractExpressionRef &predicate, vector<AbstractExpressionRef> &parts) {
+  if (predicate->GetType() == ExpressionType::LogicExpression &&
+      dynamic_pointer_cast<LogicExpression>(predicate)->logic_type_ == LogicType::And) {
+    for (const auto &child : predicate->GetChildren()) {
+      SplitConjunction(child, parts);
+    }
+    return;
+  }
+  parts.push_back(predicate);
+}
+
+void Planner::SplitDisjunction(const AbstractExpressionRef &predicate, vector<AbstractExpressionRef> &parts) {
+  if (predicate->GetType() == ExpressionType::LogicExpression &&
+      dynamic_pointer_cast<LogicExpression>(predicate)->logic_type_ == LogicType::Or) {
+    for (const auto &child : predicate->GetChildren()) {
+      SplitDisjunction(child, parts);
+    }
+    return;
+  }
+  parts.push_back(predicate);
+}
+
+AbstractExpressionRef Planner::MakeConjunction(const vector<AbstractExpressionRef> &parts) {
+  AbstractExpressionRef conjunction = nullptr;
+  for (const auto &part : parts) {
+    conjunction = conjunction == nullptr ? part : std::make_shared<LogicExpression>(conjunction, part, LogicType::And);
+  }
+  return conjunction;
+}
+
+void Planner::CollectColumns(const AbstractExpressionRef &expr, vector<vector<uint32_t>> &columns) {
+  auto column = dynamic_pointer_cast<ColumnValueExpression>(expr);
+  if (column != nullptr) {
+    columns[column->GetRowIdx()].push_back(column->GetColIdx());
+    return;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+AbstractExpressionRef Planner::RebindColumns(const AbstractExpressionRef &expr, const ColumnBinder &bind) {
+  switch (expr->GetType()) {
+    case ExpressionType::ColumnExpression:
+      return bind(dynamic_pointer_cast<ColumnValueExpression>(expr));
+    case ExpressionType::ComparisonExpression: {
+      auto comp_type = dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+      return std::make_shared<ComparisonExpression>(RebindColumns(expr->GetChildAt(0), bind),
+                                                    RebindColumns(expr->GetChildAt(1), bind), comp_type);
+    }
+    case ExpressionType::LogicExpression:
+      return std::make_shared<LogicExpression>(RebindColumns(expr->GetChildAt(0), bind),
+                                               RebindColumns(expr->GetChildAt(1), bind),
+                                               dynamic_pointer_cast<LogicExpression>(expr)->logic_type_);
+    default:
+      return expr;
+  }
+}
+
+IndexInfo *Planner::MatchJoinIndex(const std::string &table_name, const vector<AbstractExpressionRef> &inner_keys,
+                                   vector<size_t> *matched) {
+  vector<IndexInfo *> indexes;
+  context_->GetCatalog()->GetTableIndexes(table_name, indexes);
+  IndexInfo *best = nullptr;
+  bool best_unique = false;
+  matched->clear();
+  for (auto index : indexes) {
+    vector<size_t> keys;
+    for (auto key_column : index->GetIndexKeySchema()->GetColumns()) {
+      auto key = std::find_if(inner_keys.begin(), inner_keys.end(), [key_column](const AbstractExpressionRef &expr) {
+        return dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx() == key_column->GetTableInd();
+      });
+      if (key == inner_keys.end()) {
+        break;
+      }
+      keys.push_back(key - inner_keys.begin());
+    }
+    bool whole_key = keys.size() == index->GetIndexKeySchema()->GetColumnCount();
+    // only a B+ tree finds the rows of a prefix of its key
+    if (keys.empty() || (!whole_key && index->GetIndexType() != "bptree")) {
+      continue;
+    }
+    // a unique key matches at most one row, otherwise the longer the key the fewer the rows
+    bool unique = whole_key && index->IsUnique();
+    if (best == nullptr || (unique && !best_unique) || (unique == best_unique && keys.size() > matched->size())) {
+      best = index;
+      best_unique = unique;
+      *matched = std::move(keys);
+    }
+  }
+  return best;
+}
+
+double Planner::EstimateSelectivity(const std::string &table_name, const vector<AbstractExpressionRef> &conjuncts) {
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(table_name, info);
+  auto statistics = info->GetStatistics();
+  double selectivity = 1;
+  // a lower and an upper bound on one column select the rows between them, not the product of their shares
+  std::map<uint32_t, std::pair<double, double>> ranges;
+  for (const auto &conjunct : conjuncts) {
+    if (conjunct->GetType() == ExpressionType::LogicExpression &&
+        dynamic_pointer_cast<LogicExpression>(conjunct)->logic_type_ == LogicType::Or) {
+      // a row fails an OR when it fails each of its parts, taken to be independent
+      vector<AbstractExpressionRef> disjuncts;
+      SplitDisjunction(conjunct, disjuncts);
+      double none = 1;
+      for (const auto &disjunct : disjuncts) {
+        vector<AbstractExpressionRef> parts;
+        SplitConjunction(disjunct, parts);
+        none *= 1 - EstimateSelectivity(table_name, parts);
+      }
+      selectivity *= 1 - none;
+      continue;
+    }
+    if (conjunct->GetType() != ExpressionType::ComparisonExpression) {
+      selectivity *= 0.5;
+      continue;
+    }
+    auto op = dynamic_pointer_cast<ComparisonExpression>(conjunct)->GetComparisonType();
+    auto column = dynamic_pointer_cast<ColumnValueExpression>(conjunct->GetChildAt(0));
+    auto constant = dynamic_pointer_cast<ConstantValueExpression>(conjunct->GetChildAt(1));
+    bool comparable = column != nullptr &&
+                      (op == "is" || op == "not" ||
+                       (constant != nullptr &&
+                        (constant->val_.IsNull() || constant->val_.GetTypeId() == column->GetReturnType())));
+    if (statistics != nullptr && comparable) {
+      const Field null_value(column->GetReturnType());
+      const Field &value = constant != nullptr ? constant->val_ : null_value;
+      double share = statistics->EstimateSelectivity(column->GetColIdx(), op, value);
+      auto &range = ranges.emplace(column->GetColIdx(), std::make_pair(-1.0, -1.0)).first->second;
+      if ((op == ">" || op == ">=") && range.first < 0) {
+        range.first = share;
+      } else if ((op == "<" || op == "<=") && range.second < 0) {
+        range.second = share;
+      } else {
+        selectivity *= share;
+      }
+      continue;
+    }
+    // the usual defaults for predicates on columns nothing is known about
+    if (op == "=" || op == "is") {
+      selectivity *= 0.005;
+    } else if (op == "<>" || op == "not") {
+      selectivity *= 0.995;
+    } else {
+      selectivity *= 1.0 / 3;
+    }
+  }
+  for (const auto &range : ranges) {
+    double lower = range.second.first, upper = range.second.second;
+    if (lower >= 0 && upper >= 0) {
+      double non_null = 1 - statistics->GetColumn(range.first).null_fraction;
+      selectivity *= std::max(lower + upper - non_null, 0.0);
+    } else if (lower >= 0 || upper >= 0) {
+      selectivity *= std::max(lower, upper);
+    }
+  }
+  return selectivity;
+}
+
+double Planner::EstimateEqualSelectivity(const std::string &table_name, uint32_t col_idx) {
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(table_name, info);
+  auto statistics = info->GetStatistics();
+  if (statistics == nullptr || statistics->GetColumn(col_idx).distinct_count < 1) {
+    return 0.005;
+  }
+  const auto &column = statistics->GetColumn(col_idx);
+  return (1 - column.null_fraction) / column.distinct_count;
+}
+
+double Planner::GetDistinctValues(const std::string &table_name, uint32_t col_idx) {
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(table_name, info);
+  auto statistics = info->GetStatistics();
+  return statistics == nullptr ? 0 : statistics->GetColumn(col_idx).distinct_count;
+}
+
+void Planner::GetTableSize(const std::string &table_name, double *pages, double *rows) {
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(table_name, info);
+  auto statistics = info->GetStatistics();
+  if (statistics != nullptr) {
+    *pages = std::max<double>(statistics->GetPageCount(), 1);
+    *rows = statistics->GetRowCount();
+    return;
+  }
+  // a table opened from disk is not measured here, reading every page would cost more than most plans
+  size_t page_count, slot_count;
+  if (!info->GetTableHeap()->GetKnownSize(&page_count, &slot_count)) {
+    page_count = PLANNER_DEFAULT_PAGES;
+    slot_count = PLANNER_DEFAULT_ROWS;
+  }
+  *pages = std::max<double>(page_count, 1);
+  *rows = slot_count;
+}
+
+double Planner::IndexProbeCost(IndexInfo *index, double entries, double table_rows) {
+  if (index->GetIndexType() == "art") {
+    return entries * COST_ROW;
+  }
+  if (index->GetIndexType() == "hash") {
+    return COST_RANDOM_PAGE + entries * COST_ROW;
+  }
+  double key_size = KeyManager::GetEncodedSize(index->GetIndexKeySchema()) + (index->IsUnique() ? 0 : sizeof(int64_t));
+  double fanout = PAGE_SIZE * INDEX_FILL_FACTOR / (key_size + sizeof(RowId));
+  double height = 1 + std::ceil(std::log(std::max(table_rows / fanout, 1.0)) / std::log(fanout));
+  double descent = std::max(height - INDEX_PINNED_LEVELS, 0.0) * COST_RANDOM_PAGE;
+  return descent + entries / fanout + entries * COST_ROW;
+}
+
+double Planner::HeapFetchCost(double pages, double rows) {
+  if (rows <= 0) {
+    return 0;
+  }
+  double touched = pages * (1 - std::pow(1 - 1 / pages, rows));
+  double page_cost = COST_RANDOM_PAGE - (COST_RANDOM_PAGE - 1) * std::sqrt(touched / pages);
+  return touched * page_cost + rows * COST_ROW;
+}
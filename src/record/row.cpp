@@ -32,7 +32,7 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-    fields_.resize(0);
+    destroy();
     ASSERT(schema != nullptr, "Invalid schema before serialize.");
     ASSERT(fields_.empty(), "Non empty field in row.");
     uint32_t SerializedSize = 0;
@@ -102,3 +102,28 @@ void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key
   }
   key_row = Row(fields);
 }
+
+TupleView::TupleView(const Schema *schema) : offsets_(schema->GetColumnCount(), 0) {
+    for(auto column : schema->GetColumns()){
+        types_.push_back(column->GetType());
+    }
+}
+
+void TupleView::Reset(const char *data, uint32_t limit) {
+    data_ = data;
+    null_bitmap_ = data + sizeof(uint32_t);
+    //各字段依次存放，只能从头走到最后一个要读的列
+    uint32_t offset = sizeof(uint32_t) + (types_.size() + 7) / 8;
+    for(uint32_t i = 0; i < limit; i++){
+        offsets_[i] = offset;
+        if(IsNull(i)){
+            continue;
+        }
+        if(types_[i] == TypeId::kTypeChar){
+            offset += sizeof(uint32_t) + MACH_READ_UINT32(data + offset);
+        }
+        else{
+            offset += sizeof(int32_t);
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include "storage/disk_manager.h"
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <filesystem>
 #include <stdexcept>
 
@@ -89,21 +90,34 @@ page_id_t DiskManager::AllocatePage() {
 
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+    DeAllocatePages({logical_page_id});
+}
+
+void DiskManager::DeAllocatePages(std::vector<page_id_t> logical_page_ids) {
+    // grouped by extent, each bitmap page is read and written once however many of its pages go
+    std::sort(logical_page_ids.begin(), logical_page_ids.end());
+    DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
     char buf[PAGE_SIZE];
-    page_id_t physical_page_id = (logical_page_id/BITMAP_SIZE) * (BITMAP_SIZE+1)+1;
-    ReadPhysicalPage(physical_page_id, buf);
     BitmapPage<PAGE_SIZE> *bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
-    uint32_t page_offset = MapPageId(logical_page_id) - physical_page_id - 1;
-    if(bitmap->DeAllocatePage(page_offset)){
-        DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-        meta_page->num_allocated_pages_--;
-        if(!(--meta_page->extent_used_page_[logical_page_id/BITMAP_SIZE])){
-            meta_page->num_extents_--;
+    size_t i = 0;
+    while(i < logical_page_ids.size()){
+        uint32_t extent_id = logical_page_ids[i]/BITMAP_SIZE;
+        page_id_t physical_page_id = extent_id * (BITMAP_SIZE+1)+1;
+        ReadPhysicalPage(physical_page_id, buf);
+        bool changed = false;
+        for(; i < logical_page_ids.size() && logical_page_ids[i]/BITMAP_SIZE == extent_id; i++){
+            uint32_t page_offset = MapPageId(logical_page_ids[i]) - physical_page_id - 1;
+            if(bitmap->DeAllocatePage(page_offset)){
+                changed = true;
+                meta_page->num_allocated_pages_--;
+                if(!(--meta_page->extent_used_page_[extent_id])){
+                    meta_page->num_extents_--;
+                }
+            }
+        }
+        if(changed){
+            WritePhysicalPage(physical_page_id,buf);
         }
-        WritePhysicalPage(physical_page_id,buf);
-    }
-    else{
-        //LOG(WARNING) << "no page to deallocate" <<std::endl;
     }
 }
 
@@ -5,7 +5,10 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
     page_id_t cur_page_id = first_page_id_,pre_page_id=INVALID_PAGE_ID;
     while(cur_page_id != INVALID_PAGE_ID){
         auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
+        uint32_t tuple_count = page->GetTupleCount();
         if(page->InsertTuple(row, schema_, txn, lock_manager_,log_manager_)){
+            //空出的槽会被重用，只有新开的槽才计数
+            slot_count_ += page->GetTupleCount() - tuple_count;
             buffer_pool_manager_->UnpinPage(cur_page_id,true);
             return true;
         }
@@ -21,6 +24,8 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
     auto pre_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(pre_page_id));
     pre_page->SetNextPageId(new_page_id);
     buffer_pool_manager_->UnpinPage(pre_page_id,true);
+    page_count_++;
+    slot_count_++;
     return true;
 }
 
@@ -99,17 +104,48 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
 }
 
 void TableHeap::DeleteTable(page_id_t page_id) {
-  if (page_id != INVALID_PAGE_ID) {
-    auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
-    if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
-      DeleteTable(temp_table_page->GetNextPageId());
+  // 沿页链收集页号，最后按区批量释放
+  std::vector<page_id_t> pages;
+  GetPageIds(&pages, page_id);
+  buffer_pool_manager_->DeletePages(pages);
+}
+
+void TableHeap::GetPageIds(std::vector<page_id_t> *page_ids, page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    page_id = first_page_id_;
+  }
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_ids->push_back(page_id);
+    page_id_t next_page_id = page->GetNextPageId();
     buffer_pool_manager_->UnpinPage(page_id, false);
-    buffer_pool_manager_->DeletePage(page_id);
-  } else {
-    DeleteTable(first_page_id_);
+    page_id = next_page_id;
   }
 }
 
+void TableHeap::GetSize(size_t *page_count, size_t *slot_count) {
+  *page_count = 0;
+  *slot_count = 0;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    (*page_count)++;
+    *slot_count += page->GetTupleCount();
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  page_count_ = *page_count;
+  slot_count_ = *slot_count;
+  size_known_ = true;
+}
+
+bool TableHeap::GetKnownSize(size_t *page_count, size_t *slot_count) const {
+  *page_count = page_count_;
+  *slot_count = slot_count_;
+  return size_known_;
+}
+
 
 TableIterator TableHeap::Begin(Transaction *txn) {
     page_id_t cur_page_id = first_page_id_;
@@ -118,9 +154,10 @@ TableIterator TableHeap::Begin(Transaction *txn) {
         auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(cur_page_id));
         if(page->GetFirstTupleRid(&first_rid)){
             buffer_pool_manager_->UnpinPage(cur_page_id,false);
+            //迭代器直接持有读出的第一行，不必再读一遍
             Row *row = new Row(first_rid);
             GetTuple(row, nullptr);
-            return TableIterator(row->GetRowId(),this);
+            return TableIterator(row,this);
         }
         buffer_pool_manager_->UnpinPage(cur_page_id,false);
         cur_page_id = page->GetNextPageId();
@@ -9,6 +9,11 @@ TableIterator::TableIterator(RowId rowId,TableHeap *tableheap) {
     ite_tableheap = tableheap;
 }
 
+TableIterator::TableIterator(Row *row,TableHeap *tableheap) {
+    ite_row = row;
+    ite_tableheap = tableheap;
+}
+
 TableIterator::TableIterator(const TableIterator &other) {
     this->ite_row = new Row(*(other.ite_row));
     this->ite_tableheap = other.ite_tableheap;
@@ -0,0 +1,47 @@
+#include "storage/table_scanner.h"
+
+#include "storage/table_heap.h"
+
+TableScanner::TableScanner(TableHeap *table_heap)
+    : TableScanner(table_heap, table_heap->GetFirstPageId(), INVALID_PAGE_ID) {}
+
+TableScanner::TableScanner(TableHeap *table_heap, page_id_t first_page_id, page_id_t end_page_id) {
+    buffer_pool_manager_ = table_heap->buffer_pool_manager_;
+    next_page_id_ = first_page_id;
+    end_page_id_ = end_page_id;
+}
+
+TableScanner::~TableScanner() {
+    if(page_ != nullptr){
+        buffer_pool_manager_->UnpinPage(page_->GetPageId(),false);
+    }
+}
+
+bool TableScanner::Next() {
+    while(true){
+        if(page_ != nullptr){
+            //当前页还没读过就从第一个元组开始，否则找当前槽之后的下一个
+            RowId next_rid;
+            bool found = (rid_.GetPageId() == page_->GetTablePageId()) ? page_->GetNextTupleRid(rid_,&next_rid)
+                                                                        : page_->GetFirstTupleRid(&next_rid);
+            if(found){
+                rid_ = next_rid;
+                tuple_data_ = page_->GetTupleData(next_rid.GetSlotNum());
+                return true;
+            }
+            next_page_id_ = page_->GetNextPageId();
+            buffer_pool_manager_->UnpinPage(page_->GetPageId(),false);
+            page_ = nullptr;
+        }
+        if(next_page_id_ == INVALID_PAGE_ID || next_page_id_ == end_page_id_){
+            rid_ = RowId(INVALID_PAGE_ID,0);
+            tuple_data_ = nullptr;
+            return false;
+        }
+        page_ = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id_));
+        if(page_ == nullptr){
+            LOG(ERROR)<<"Failed to fetch table page "<<next_page_id_<<std::endl;
+            next_page_id_ = INVALID_PAGE_ID;
+        }
+    }
+}
@@ -39,6 +39,27 @@ TEST(CatalogTest, CatalogMetaTest) {
   delete other;
 }
 
+TEST(CatalogTest, IndexMetadataFormatTest) {
+  char *buf = new char[PAGE_SIZE];
+  auto meta = IndexMetadata::Create(3, "index-1", 5, {0, 2}, false, "hash");
+  uint32_t size = meta->SerializeTo(buf);
+  IndexMetadata *other = nullptr;
+  ASSERT_EQ(size, IndexMetadata::DeserializeFrom(buf, other));
+  ASSERT_NE(nullptr, other);
+  EXPECT_EQ("index-1", other->GetIndexName());
+  EXPECT_EQ(5, other->GetTableId());
+  EXPECT_FALSE(other->IsUnique());
+  EXPECT_EQ("hash", other->GetIndexType());
+  delete other;
+  // metadata of the format before the unique flag and the index type is rejected, not misread
+  other = nullptr;
+  MACH_WRITE_UINT32(buf, 344528);
+  IndexMetadata::DeserializeFrom(buf, other);
+  EXPECT_EQ(nullptr, other);
+  delete meta;
+  delete[] buf;
+}
+
 TEST(CatalogTest, CatalogTableTest) {
   /** Stage 2: Testing simple operation */
   auto db_01 = new DBStorageEngine(db_file_name, true);
@@ -125,4 +146,113 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogStatisticsTest) {
+  /** Stage 1: Testing analyze, the table has more rows than the sample */
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("grp", TypeId::kTypeInt, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  catalog_01->CreateTable("table-1", schema.get(), &txn, table_info);
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  // grp is null in a tenth of the rows, 7 in four tenths and unique in the rest
+  const int row_count = 40000;
+  for (int i = 0; i < row_count; i++) {
+    std::string name = "name" + std::to_string(i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              i % 10 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, i % 2 == 0 ? 7 : i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->AnalyzeTable("table-0", &txn));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", &txn));
+  auto check = [row_count](const TableStatistics *statistics) {
+    ASSERT_NE(nullptr, statistics);
+    ASSERT_EQ(row_count, statistics->GetRowCount());
+    ASSERT_GT(statistics->GetPageCount(), 0);
+    EXPECT_NEAR(row_count, statistics->GetColumn(0).distinct_count, row_count * 0.05);
+    EXPECT_NEAR(0.25, statistics->EstimateSelectivity(0, "<", Field(TypeId::kTypeInt, row_count / 4)), 0.02);
+    EXPECT_NEAR(0.75, statistics->EstimateSelectivity(0, ">=", Field(TypeId::kTypeInt, row_count / 4)), 0.02);
+    EXPECT_NEAR(1.0 / row_count, statistics->EstimateSelectivity(0, "=", Field(TypeId::kTypeInt, 5)), 0.001);
+    EXPECT_EQ(0, statistics->EstimateSelectivity(0, ">", Field(TypeId::kTypeInt, row_count * 2)));
+    EXPECT_NEAR(0.1, statistics->EstimateSelectivity(1, "is", Field(TypeId::kTypeInt)), 0.01);
+    EXPECT_NEAR(0.9, statistics->EstimateSelectivity(1, "not", Field(TypeId::kTypeInt)), 0.01);
+    EXPECT_NEAR(0.4, statistics->EstimateSelectivity(1, "=", Field(TypeId::kTypeInt, 7)), 0.02);
+    EXPECT_NEAR(0.5, statistics->EstimateSelectivity(1, "<>", Field(TypeId::kTypeInt, 7)), 0.02);
+    EXPECT_NEAR(row_count / 2, statistics->GetColumn(1).distinct_count, row_count * 0.1);
+    EXPECT_NEAR(100, statistics->GetColumn(2).distinct_count, 5);
+    char name[] = "name42";
+    EXPECT_NEAR(0.01, statistics->EstimateSelectivity(2, "=", Field(TypeId::kTypeChar, name, 6, false)), 0.005);
+  };
+  check(table_info->GetStatistics());
+  delete db_01;
+  /** Stage 2: Testing statistics loading */
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  check(table_info_02->GetStatistics());
+  // analyzing again rewrites the same statistics page
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->AnalyzeTable("table-1", &txn));
+  check(table_info_02->GetStatistics());
+  delete db_02;
+}
+
+TEST(CatalogTest, CatalogStatisticsShrinkTest) {
+  // wide values: the histograms are thinned until the statistics fit on a page, each keeping its end points,
+  // also that of a column with two values only
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns;
+  for (uint32_t c = 0; c < 3; c++) {
+    columns.push_back(new Column("text" + std::to_string(c), TypeId::kTypeChar, 600, c, false, false));
+  }
+  columns.push_back(new Column("few", TypeId::kTypeInt, 3, true, false));
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info);
+  auto text = [](int i) {
+    std::string digits = std::to_string(1000 + i);
+    return std::string(600 - digits.length(), 'a') + digits;
+  };
+  for (int i = 0; i < 200; i++) {
+    std::string value = text(i);
+    std::vector<Field> fields;
+    for (uint32_t c = 0; c < 3; c++) {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(value.c_str()), value.length(), true);
+    }
+    fields.emplace_back(i == 10 ? Field(TypeId::kTypeInt, 5) : i == 20 ? Field(TypeId::kTypeInt, 9)
+                                                                       : Field(TypeId::kTypeInt));
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->AnalyzeTable("table-1", &txn));
+  auto statistics = table_info->GetStatistics();
+  ASSERT_NE(nullptr, statistics);
+  ASSERT_LE(statistics->GetSerializedSize(), PAGE_SIZE);
+  std::string first = text(0), last = text(199);
+  Field min_value(TypeId::kTypeChar, const_cast<char *>(first.c_str()), first.length(), false);
+  Field max_value(TypeId::kTypeChar, const_cast<char *>(last.c_str()), last.length(), false);
+  std::string beyond(600, 'b');
+  Field beyond_value(TypeId::kTypeChar, const_cast<char *>(beyond.c_str()), beyond.length(), false);
+  for (uint32_t c = 0; c < 3; c++) {
+    const auto &bounds = statistics->GetColumn(c).bounds;
+    ASSERT_GE(bounds.size(), 2);
+    EXPECT_EQ(CmpBool::kTrue, bounds.front().CompareEquals(min_value));
+    EXPECT_EQ(CmpBool::kTrue, bounds.back().CompareEquals(max_value));
+    EXPECT_EQ(0, statistics->EstimateSelectivity(c, ">=", beyond_value));
+    EXPECT_EQ(1, statistics->EstimateSelectivity(c, "<", beyond_value));
+    EXPECT_EQ(0, statistics->EstimateSelectivity(c, "<", min_value));
+  }
+  const auto &few_bounds = statistics->GetColumn(3).bounds;
+  ASSERT_EQ(2, few_bounds.size());
+  EXPECT_EQ(CmpBool::kTrue, few_bounds.front().CompareEquals(Field(TypeId::kTypeInt, 5)));
+  EXPECT_EQ(CmpBool::kTrue, few_bounds.back().CompareEquals(Field(TypeId::kTypeInt, 9)));
+  EXPECT_EQ(0, statistics->EstimateSelectivity(3, ">", Field(TypeId::kTypeInt, 9)));
+  EXPECT_NEAR(0.005, statistics->EstimateSelectivity(3, "<", Field(TypeId::kTypeInt, 7)), 0.001);
+  delete db_01;
+}
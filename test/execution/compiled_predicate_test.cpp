@@ -0,0 +1,103 @@
+#include "executor/compiled_predicate.h"
+
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "utils/utils.h"
+
+using Fields = std::vector<Field>;
+
+namespace {
+
+AbstractExpressionRef MakeColumn(uint32_t index, TypeId type) {
+  return std::make_shared<ColumnValueExpression>(0, index, type);
+}
+
+AbstractExpressionRef MakeConstant(const Field &value) { return std::make_shared<ConstantValueExpression>(value); }
+
+AbstractExpressionRef MakeCompare(const AbstractExpressionRef &lhs, const AbstractExpressionRef &rhs,
+                                  const std::string &op) {
+  return std::make_shared<ComparisonExpression>(lhs, rhs, op);
+}
+
+AbstractExpressionRef MakeLogic(const AbstractExpressionRef &lhs, const AbstractExpressionRef &rhs,
+                                LogicType type) {
+  return std::make_shared<LogicExpression>(lhs, rhs, type);
+}
+
+}  // namespace
+
+// The compiled program must accept exactly the rows the expression tree evaluates to true, on rows and on batches
+TEST(CompiledPredicateTest, MatchesTreeEvaluation) {
+  std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, true, false),
+                                   new Column("b", TypeId::kTypeFloat, 1, true, false),
+                                   new Column("c", TypeId::kTypeChar, 4, 2, true, false),
+                                   new Column("d", TypeId::kTypeInt, 3, true, false)};
+  Schema schema(columns);
+  const char *words[] = {"", "a", "ab", "abc", "b"};
+  RowBatch batch;
+  batch.Reset(&schema);
+  std::vector<Row> rows;
+  for (int i = 0; i < 500; i++) {
+    Fields fields;
+    fields.push_back(i % 7 == 0 ? Field(kTypeInt) : Field(kTypeInt, RandomUtils::RandomInt(0, 9)));
+    fields.push_back(i % 11 == 0 ? Field(kTypeFloat)
+                                 : Field(kTypeFloat, static_cast<float>(RandomUtils::RandomInt(0, 9))));
+    const char *word = words[RandomUtils::RandomInt(0, 4)];
+    fields.push_back(i % 13 == 0 ? Field(kTypeChar)
+                                 : Field(kTypeChar, const_cast<char *>(word), strlen(word), true));
+    fields.push_back(Field(kTypeInt, RandomUtils::RandomInt(0, 9)));
+    rows.emplace_back(fields);
+    batch.Append(rows.back());
+  }
+
+  auto a = MakeColumn(0, kTypeInt), b = MakeColumn(1, kTypeFloat);
+  auto c = MakeColumn(2, kTypeChar), d = MakeColumn(3, kTypeInt);
+  auto ab = MakeConstant(Field(kTypeChar, const_cast<char *>("ab"), 2, true));
+  std::vector<AbstractExpressionRef> predicates = {
+      MakeCompare(a, MakeConstant(Field(kTypeInt, 5)), "="),
+      MakeCompare(a, MakeConstant(Field(kTypeInt, 5)), "<>"),
+      MakeCompare(b, MakeConstant(Field(kTypeFloat, 4.0f)), "<="),
+      MakeCompare(MakeConstant(Field(kTypeInt, 3)), a, "<"),
+      MakeCompare(c, ab, ">="),
+      MakeCompare(c, ab, "<"),
+      MakeCompare(a, d, ">"),
+      MakeCompare(a, MakeConstant(Field(kTypeInt)), "="),
+      MakeCompare(a, MakeConstant(Field(kTypeInt)), "is"),
+      MakeCompare(c, MakeConstant(Field(kTypeChar)), "not"),
+      MakeCompare(MakeConstant(Field(kTypeInt, 1)), MakeConstant(Field(kTypeInt, 2)), "<"),
+      MakeLogic(MakeCompare(a, MakeConstant(Field(kTypeInt, 2)), ">"),
+                MakeCompare(b, MakeConstant(Field(kTypeFloat, 6.0f)), "<"), LogicType::And),
+      MakeLogic(MakeLogic(MakeCompare(a, MakeConstant(Field(kTypeInt, 1)), "="), MakeCompare(c, ab, "="),
+                          LogicType::Or),
+                MakeLogic(MakeCompare(d, MakeConstant(Field(kTypeInt, 5)), ">="),
+                          MakeCompare(b, MakeConstant(Field(kTypeFloat)), "is"), LogicType::Or),
+                LogicType::And),
+      // comparing columns of different types cannot be compiled
+      MakeCompare(a, b, "="),
+  };
+  for (size_t p = 0; p < predicates.size(); p++) {
+    CompiledPredicate compiled(predicates[p]);
+    ASSERT_EQ(p + 1 != predicates.size(), compiled.IsCompiled()) << "predicate " << p;
+    if (!compiled.IsCompiled()) {
+      continue;
+    }
+    batch.GetSelection().clear();
+    for (uint32_t i = 0; i < rows.size(); i++) {
+      batch.GetSelection().push_back(i);
+    }
+    compiled.Filter(&batch);
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < rows.size(); i++) {
+      bool accepted = predicates[p]->Evaluate(&rows[i]).CompareEquals(Field(kTypeInt, 1)) == CmpBool::kTrue;
+      ASSERT_EQ(accepted, compiled.Evaluate(rows[i])) << "predicate " << p << " row " << i;
+      if (accepted) {
+        expected.push_back(i);
+      }
+    }
+    ASSERT_EQ(expected, batch.GetSelection()) << "predicate " << p;
+  }
+  ASSERT_TRUE(CompiledPredicate().AcceptsAll());
+}
@@ -1,9 +1,23 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include "common/result_writer.h"
+#include "executor/executors/hash_aggregation_executor.h"
+#include "executor/executors/hash_join_executor.h"
+#include "executor/executors/index_nested_loop_join_executor.h"
+#include "executor/executors/limit_executor.h"
+#include "executor/executors/parallel_seq_scan_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/executors/sort_executor.h"
+#include "executor/plans/aggregation_plan.h"
 #include "executor/plans/delete_plan.h"
+#include "executor/plans/hash_join_plan.h"
+#include "executor/plans/index_nested_loop_join_plan.h"
+#include "executor/plans/index_scan_plan.h"
 #include "executor/plans/insert_plan.h"
+#include "executor/plans/limit_plan.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "executor/plans/sort_plan.h"
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
 #include "executor_test_util.h"  // NOLINT
@@ -30,6 +44,39 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   }
 }
 
+// SELECT id FROM table-1 WHERE id < 900, handed over batch by batch
+TEST_F(ExecutorTest, StreamingExecutePlanTest) {
+  TableInfo *table_info = nullptr;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto const900 = MakeConstantValueExpression(Field(kTypeInt, 900));
+  auto predicate = MakeComparisonExpression(col_a, const900, "<");
+  auto out_schema = MakeOutputSchema({{"id", col_a}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+  size_t batches = 0;
+  size_t rows = 0;
+  auto consume = [&](const RowBatch &batch) {
+    ASSERT_LE(batch.SelectedCount(), EXECUTOR_BATCH_SIZE);
+    batches++;
+    rows += batch.SelectedCount();
+  };
+  ASSERT_EQ(GetExecutionEngine()->ExecutePlan(plan, consume, GetTxn(), GetExecutorContext()), DB_SUCCESS);
+  ASSERT_EQ(rows, 900);
+  ASSERT_GE(batches, 1);
+}
+
+TEST(ResultWriterTest, DelimitedRowTest) {
+  std::vector<std::string> cells{"plain", "a,b", "say \"hi\"", "", "tab\there", "NULL"};
+  std::vector<bool> nulls{false, false, false, false, false, true};
+  std::stringstream csv;
+  ResultWriter(csv).WriteDelimitedRow(OutputFormat::Csv, cells, nulls);
+  ASSERT_EQ(csv.str(), "plain,\"a,b\",\"say \"\"hi\"\"\",\"\",tab\there,\n");
+  std::stringstream tsv;
+  ResultWriter(tsv).WriteDelimitedRow(OutputFormat::Tsv, cells, nulls);
+  ASSERT_EQ(tsv.str(), "plain\ta,b\tsay \"hi\"\t\ttab\\there\t\\N\n");
+}
+
 // DELETE FROM table-1 WHERE id == 50;
 TEST_F(ExecutorTest, SimpleDeleteTest) {
   // Construct query plan
@@ -71,6 +118,144 @@ TEST_F(ExecutorTest, SimpleDeleteTest) {
   ASSERT_TRUE(rids.empty());
 }
 
+// UPDATE table-1 SET account = 0.5 WHERE id >= 100 AND id < 200, then DELETE FROM table-1 with the same
+// where clause, the rows found through an index on id
+TEST_F(ExecutorTest, IndexUpdateDeleteTest) {
+  TableInfo *table_info;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  catalog->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-1", {"id"}, GetTxn(), index_info, "bptree"));
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto lower = MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 100)), ">=");
+  auto upper = MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 200)), "<");
+  auto index_scan = std::make_shared<IndexScanPlanNode>(schema, "table-1", std::vector<IndexInfo *>{index_info},
+                                                        false, nullptr,
+                                                        std::vector<std::vector<AbstractExpressionRef>>{{lower, upper}});
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  Field half(kTypeFloat, 0.5f);
+  update_attrs.emplace(static_cast<uint32_t>(2), MakeConstantValueExpression(half));
+  std::vector<Row> result_set;
+  ASSERT_EQ(DB_SUCCESS,
+            GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, index_scan, "table-1",
+                                                                               update_attrs),
+                                              &result_set, GetTxn(), GetExecutorContext()));
+  result_set.clear();
+  auto updated = MakeComparisonExpression(MakeColumnValueExpression(*schema, 0, "account"),
+                                          MakeConstantValueExpression(half), "=");
+  auto seq_scan = std::make_shared<SeqScanPlanNode>(schema, "table-1", updated);
+  GetExecutionEngine()->ExecutePlan(seq_scan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(100, result_set.size());
+  for (const auto &row : result_set) {
+    ASSERT_TRUE(row.GetField(0)->CompareGreaterThanEquals(Field(kTypeInt, 100)) == CmpBool::kTrue);
+    ASSERT_TRUE(row.GetField(0)->CompareLessThan(Field(kTypeInt, 200)) == CmpBool::kTrue);
+  }
+  result_set.clear();
+
+  GetExecutionEngine()->ExecutePlan(std::make_shared<DeletePlanNode>(schema, index_scan, "table-1"), &result_set,
+                                    GetTxn(), GetExecutorContext());
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(std::make_shared<SeqScanPlanNode>(schema, "table-1"), &result_set, GetTxn(),
+                                    GetExecutorContext());
+  ASSERT_EQ(900, result_set.size());
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(index_scan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_TRUE(result_set.empty());
+}
+
+// UPDATE table-1 SET name = "xx...x" WHERE id < 500, the rows grow past the room left in their pages and are
+// moved to other pages, the index on id following them
+TEST_F(ExecutorTest, UpdateMovedRowTest) {
+  TableInfo *table_info;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  catalog->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-1", {"id"}, GetTxn(), index_info, "bptree"));
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto predicate = MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 500)), "<");
+  std::string name(64, 'x');
+  Field long_name(kTypeChar, const_cast<char *>(name.c_str()), name.length(), false);
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  update_attrs.emplace(static_cast<uint32_t>(1), MakeConstantValueExpression(long_name));
+  std::vector<Row> result_set;
+  auto seq_scan = std::make_shared<SeqScanPlanNode>(schema, "table-1", predicate);
+  ASSERT_EQ(DB_SUCCESS,
+            GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, seq_scan, "table-1",
+                                                                               update_attrs),
+                                              &result_set, GetTxn(), GetExecutorContext()));
+  result_set.clear();
+  auto updated = MakeComparisonExpression(MakeColumnValueExpression(*schema, 0, "name"),
+                                          MakeConstantValueExpression(long_name), "=");
+  GetExecutionEngine()->ExecutePlan(std::make_shared<SeqScanPlanNode>(schema, "table-1", updated), &result_set,
+                                    GetTxn(), GetExecutorContext());
+  ASSERT_EQ(500, result_set.size());
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(std::make_shared<SeqScanPlanNode>(schema, "table-1"), &result_set, GetTxn(),
+                                    GetExecutorContext());
+  ASSERT_EQ(1000, result_set.size());
+  // every id is found through the index at the row id its row now has
+  for (const auto &row : result_set) {
+    std::vector<RowId> rids;
+    Fields fields;
+    fields.emplace_back(*row.GetField(0));
+    index_info->GetIndex()->ScanKey(Row(fields), rids, GetTxn());
+    ASSERT_EQ(std::vector<RowId>{row.GetRowId()}, rids);
+  }
+}
+
+// UPDATE table-2 SET a = ..., b = ... WHERE a = 1, the new key of the index checked last taken by another row:
+// the update fails and every index still finds the row by its old keys only
+TEST_F(ExecutorTest, UpdateUniqueConflictTest) {
+  std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, false, true),
+                                   new Column("b", TypeId::kTypeInt, 1, false, true)};
+  TableInfo *table_2 = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_2));
+  for (int i = 1; i <= 2; i++) {
+    Fields fields{Field(kTypeInt, i), Field(kTypeInt, i * 10)};
+    Row row(fields);
+    ASSERT_TRUE(table_2->GetTableHeap()->InsertTuple(row, GetTxn()));
+  }
+  IndexInfo *index_a = nullptr, *index_b = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-2", "index-a", {"a"}, GetTxn(), index_a, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-2", "index-b", {"b"}, GetTxn(), index_b, "bptree"));
+  // the index switched first keeps a free new key, the other one conflicts
+  std::vector<IndexInfo *> indexes;
+  catalog->GetTableIndexes("table-2", indexes);
+  bool a_conflicts = indexes.back() == index_a;
+  int new_a = a_conflicts ? 2 : 3, new_b = a_conflicts ? 30 : 20;
+  auto schema = table_2->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "a");
+  auto predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(Field(kTypeInt, 1)), "=");
+  auto scan_plan = std::make_shared<SeqScanPlanNode>(schema, "table-2", predicate);
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  update_attrs.emplace(0, MakeConstantValueExpression(Field(kTypeInt, new_a)));
+  update_attrs.emplace(1, MakeConstantValueExpression(Field(kTypeInt, new_b)));
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(std::make_shared<UpdatePlanNode>(schema, scan_plan, "table-2", update_attrs),
+                                    &result_set, GetTxn(), GetExecutorContext());
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(scan_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(1, result_set.size());
+  ASSERT_EQ(CmpBool::kTrue, result_set[0].GetField(1)->CompareEquals(Field(kTypeInt, 10)));
+  RowId rid = result_set[0].GetRowId();
+  auto lookup = [this](IndexInfo *index, int value) {
+    std::vector<RowId> rids;
+    Fields fields{Field(kTypeInt, value)};
+    index->GetIndex()->ScanKey(Row(fields), rids, GetTxn());
+    return rids;
+  };
+  ASSERT_EQ(std::vector<RowId>{rid}, lookup(index_a, 1));
+  ASSERT_EQ(std::vector<RowId>{rid}, lookup(index_b, 10));
+  if (a_conflicts) {
+    ASSERT_TRUE(lookup(index_b, new_b).empty());
+  } else {
+    ASSERT_TRUE(lookup(index_a, new_a).empty());
+  }
+}
+
 // INSERT INTO table-1 VALUES (1001, "aaa", 2.33);
 TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // Create values plan node
@@ -151,3 +336,511 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// SELECT account, id FROM table-1 WHERE id >= 100, pulled batch by batch
+TEST_F(ExecutorTest, BatchSeqScanTest) {
+  TableInfo *table_info = nullptr;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  // grow the table past one batch
+  for (int i = 1000; i < 3000; i++) {
+    Fields fields{Field(kTypeInt, i), Field(kTypeChar, const_cast<char *>("batch"), 5, true), Field(kTypeFloat)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+  }
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_account = MakeColumnValueExpression(*schema, 0, "account");
+  auto const100 = MakeConstantValueExpression(Field(kTypeInt, 100));
+  auto predicate = MakeComparisonExpression(col_id, const100, ">=");
+  auto out_schema = MakeOutputSchema({{"account", col_account}, {"id", col_id}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+  // as a DML parent does, ask for every column
+  SeqScanExecutor executor(GetExecutorContext(), plan.get());
+  executor.RequireFullRows();
+  executor.Init();
+  RowBatch batch;
+  size_t batches = 0, rows = 0;
+  std::vector<bool> seen(3000, false);
+  while (executor.NextBatch(&batch)) {
+    batches++;
+    ASSERT_LE(batch.SelectedCount(), EXECUTOR_BATCH_SIZE);
+    ASSERT_EQ(3, batch.GetColumnCount());
+    for (size_t i = 0; i < batch.SelectedCount(); i++) {
+      Row row, full_row;
+      batch.GetRow(i, &row);
+      batch.GetFullRow(i, &full_row);
+      ASSERT_EQ(2, row.GetFieldCount());
+      ASSERT_EQ(3, full_row.GetFieldCount());
+      ASSERT_EQ(kTypeFloat, row.GetField(0)->GetTypeId());
+      ASSERT_EQ(row.GetField(0)->IsNull(), full_row.GetField(2)->IsNull());
+      ASSERT_TRUE(row.GetField(1)->CompareEquals(*full_row.GetField(0)));
+      // the stored row is still reachable through the row id
+      Row stored(batch.GetRowId(i));
+      ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&stored, GetTxn()));
+      ASSERT_TRUE(stored.GetField(1)->CompareEquals(*full_row.GetField(1)));
+      int32_t id;
+      row.GetField(1)->SerializeTo(reinterpret_cast<char *>(&id));
+      ASSERT_TRUE(id >= 100 && id < 3000 && !seen[id]);
+      seen[id] = true;
+      rows++;
+    }
+  }
+  ASSERT_EQ(2900, rows);
+  ASSERT_GE(batches, 3);
+  // otherwise only the output columns are decoded
+  SeqScanExecutor projecting(GetExecutorContext(), plan.get());
+  projecting.Init();
+  size_t projected_rows = 0;
+  while (projecting.NextBatch(&batch)) {
+    ASSERT_EQ(batch.Size(), batch.GetColumn(0).Size());
+    ASSERT_EQ(0, batch.GetColumn(1).Size());
+    ASSERT_EQ(batch.Size(), batch.GetColumn(2).Size());
+    projected_rows += batch.SelectedCount();
+  }
+  ASSERT_EQ(rows, projected_rows);
+  // the row at a time interface sees the same rows
+  projecting.Init();
+  Row row;
+  RowId rid;
+  size_t next_rows = 0;
+  while (projecting.Next(&row, &rid)) {
+    ASSERT_EQ(2, row.GetFieldCount());
+    next_rows++;
+  }
+  ASSERT_EQ(rows, next_rows);
+}
+
+// the parallel scan returns the rows of the serial one, in the same order
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableInfo *table_info = nullptr;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  // many morsels
+  for (int i = 1000; i < 20000; i++) {
+    Fields fields{Field(kTypeInt, i), Field(kTypeChar, const_cast<char *>("parallel"), 8, true),
+                  Field(kTypeFloat, static_cast<float>(i % 100))};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+  }
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_account = MakeColumnValueExpression(*schema, 0, "account");
+  auto predicate = MakeComparisonExpression(col_account, MakeConstantValueExpression(Field(kTypeFloat, 50.0f)), "<");
+  auto out_schema = MakeOutputSchema({{"id", col_id}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate, true);
+  std::vector<RowId> expected;
+  SeqScanExecutor serial(GetExecutorContext(), plan.get());
+  serial.Init();
+  Row row;
+  RowId rid;
+  while (serial.Next(&row, &rid)) {
+    expected.push_back(rid);
+  }
+  ASSERT_GT(expected.size(), 9000);
+  for (size_t workers : {1, 4}) {
+    ParallelSeqScanExecutor parallel(GetExecutorContext(), plan.get(), workers);
+    // scanned twice to check that Init() restarts the workers
+    for (int round = 0; round < 2; round++) {
+      parallel.Init();
+      std::vector<RowId> rids;
+      while (parallel.Next(&row, &rid)) {
+        ASSERT_EQ(1, row.GetFieldCount());
+        rids.push_back(rid);
+      }
+      ASSERT_EQ(expected.size(), rids.size());
+      for (size_t i = 0; i < rids.size(); i++) {
+        ASSERT_EQ(expected[i].Get(), rids[i].Get());
+      }
+    }
+  }
+  // abandoned after one batch, the workers stop
+  {
+    ParallelSeqScanExecutor parallel(GetExecutorContext(), plan.get(), 4);
+    parallel.Init();
+    RowBatch batch;
+    ASSERT_TRUE(parallel.NextBatch(&batch));
+  }
+  // the execution engine picks it for a parallel plan
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(expected.size(), result_set.size());
+}
+
+// SELECT id, tag FROM table-1, table-2 WHERE id = ref AND tag > id, in memory and spilled
+TEST_F(ExecutorTest, HashJoinTest) {
+  std::vector<Column *> columns = {new Column("ref", TypeId::kTypeInt, 0, true, false),
+                                   new Column("tag", TypeId::kTypeInt, 1, false, false)};
+  TableInfo *table_2 = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_2));
+  std::vector<int> expected;
+  for (int i = 0; i < 3000; i++) {
+    // a null key never matches
+    Fields fields{i % 100 == 0 ? Field(kTypeInt) : Field(kTypeInt, i % 1500), Field(kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_2->GetTableHeap()->InsertTuple(row, GetTxn()));
+    if (i % 100 != 0 && i % 1500 < 1000 && i >= 1500) {
+      expected.push_back(i);
+    }
+  }
+  TableInfo *table_1 = nullptr;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_1);
+  auto col_id = MakeColumnValueExpression(*table_1->GetSchema(), 0, "id");
+  auto col_account = MakeColumnValueExpression(*table_1->GetSchema(), 0, "account");
+  auto col_ref = MakeColumnValueExpression(*table_2->GetSchema(), 0, "ref");
+  auto col_tag = MakeColumnValueExpression(*table_2->GetSchema(), 0, "tag");
+  auto scan_1 = std::make_shared<SeqScanPlanNode>(MakeOutputSchema({{"id", col_id}, {"account", col_account}}),
+                                                  table_1->GetTableName());
+  auto scan_2 = std::make_shared<SeqScanPlanNode>(MakeOutputSchema({{"ref", col_ref}, {"tag", col_tag}}),
+                                                  table_2->GetTableName());
+  // table-1 on either side, so that each side gets to be the build side
+  for (bool table_1_left : {true, false}) {
+    uint32_t side_1 = table_1_left ? 0 : 1, side_2 = 1 - side_1;
+    auto id = std::make_shared<ColumnValueExpression>(side_1, 0, kTypeInt);
+    auto ref = std::make_shared<ColumnValueExpression>(side_2, 0, kTypeInt);
+    auto tag = std::make_shared<ColumnValueExpression>(side_2, 1, kTypeInt);
+    auto out_schema = MakeOutputSchema({{"id", id}, {"tag", tag}});
+    auto plan = std::make_shared<HashJoinPlanNode>(
+        out_schema, table_1_left ? scan_1 : scan_2, table_1_left ? scan_2 : scan_1,
+        std::vector<AbstractExpressionRef>{table_1_left ? id : ref},
+        std::vector<AbstractExpressionRef>{table_1_left ? ref : id}, MakeComparisonExpression(tag, id, ">"),
+        std::vector<AbstractExpressionRef>{id, tag});
+    auto verify = [&expected](std::vector<Row> &result_set) {
+      std::vector<int> tags;
+      for (const auto &row : result_set) {
+        ASSERT_EQ(2, row.GetFieldCount());
+        int32_t id_value, tag_value;
+        row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&id_value));
+        row.GetField(1)->SerializeTo(reinterpret_cast<char *>(&tag_value));
+        ASSERT_EQ(tag_value % 1500, id_value);
+        tags.push_back(tag_value);
+      }
+      std::sort(tags.begin(), tags.end());
+      ASSERT_EQ(expected, tags);
+    };
+    std::vector<Row> result_set;
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    verify(result_set);
+    // a budget of a page spills both sides into partitions, Init() twice to check the restart
+    auto left = std::make_unique<SeqScanExecutor>(GetExecutorContext(), table_1_left ? scan_1.get() : scan_2.get());
+    auto right = std::make_unique<SeqScanExecutor>(GetExecutorContext(), table_1_left ? scan_2.get() : scan_1.get());
+    HashJoinExecutor spilled(GetExecutorContext(), plan.get(), std::move(left), std::move(right), PAGE_SIZE);
+    for (int round = 0; round < 2; round++) {
+      spilled.Init();
+      result_set.clear();
+      Row row;
+      RowId rid;
+      while (spilled.Next(&row, &rid)) {
+        result_set.push_back(row);
+      }
+      verify(result_set);
+    }
+  }
+}
+
+// SELECT tag, id FROM table-2, table-1 WHERE ref = id AND id < 800 AND tag > id, through an index of table-1
+TEST_F(ExecutorTest, IndexNestedLoopJoinTest) {
+  std::vector<Column *> columns = {new Column("ref", TypeId::kTypeInt, 0, true, false),
+                                   new Column("tag", TypeId::kTypeInt, 1, false, false)};
+  TableInfo *table_2 = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_2));
+  std::vector<int> expected;
+  for (int i = 0; i < 3000; i++) {
+    // each key is looked up twice, a null key never matches
+    Fields fields{i % 100 == 0 ? Field(kTypeInt) : Field(kTypeInt, i % 1500), Field(kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_2->GetTableHeap()->InsertTuple(row, GetTxn()));
+    if (i % 100 != 0 && i % 1500 < 800 && i >= 1500) {
+      expected.push_back(i);
+    }
+  }
+  auto col_ref = MakeColumnValueExpression(*table_2->GetSchema(), 0, "ref");
+  auto col_tag = MakeColumnValueExpression(*table_2->GetSchema(), 0, "tag");
+  auto scan_2 = std::make_shared<SeqScanPlanNode>(MakeOutputSchema({{"ref", col_ref}, {"tag", col_tag}}),
+                                                  table_2->GetTableName());
+  auto ref = std::make_shared<ColumnValueExpression>(0, 0, kTypeInt);
+  auto tag = std::make_shared<ColumnValueExpression>(0, 1, kTypeInt);
+  auto id = std::make_shared<ColumnValueExpression>(1, 0, kTypeInt);
+  auto inner_predicate =
+      MakeComparisonExpression(std::make_shared<ColumnValueExpression>(0, 0, kTypeInt),
+                               MakeConstantValueExpression(Field(kTypeInt, 800)), "<");
+  // the whole key of an index on id, then the prefix of an index on (id, name)
+  IndexInfo *id_index = nullptr, *id_name_index = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-1", {"id"}, GetTxn(), id_index, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-2", {"id", "name"}, GetTxn(), id_name_index, "bptree"));
+  for (auto index : {id_index, id_name_index}) {
+    auto plan = std::make_shared<IndexNestedLoopJoinPlanNode>(
+        MakeOutputSchema({{"tag", tag}, {"id", id}}), scan_2, "table-1", index, std::vector<AbstractExpressionRef>{ref},
+        inner_predicate, MakeComparisonExpression(tag, id, ">"), std::vector<AbstractExpressionRef>{tag, id});
+    std::vector<Row> result_set;
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int> tags;
+    for (const auto &row : result_set) {
+      ASSERT_EQ(2, row.GetFieldCount());
+      int32_t tag_value, id_value;
+      row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&tag_value));
+      row.GetField(1)->SerializeTo(reinterpret_cast<char *>(&id_value));
+      ASSERT_EQ(tag_value % 1500, id_value);
+      tags.push_back(tag_value);
+    }
+    std::sort(tags.begin(), tags.end());
+    ASSERT_EQ(expected, tags);
+  }
+}
+
+// SELECT id FROM table-1 WHERE (id < 100 OR id >= 900 OR account = ...) AND id >= 50, the OR united from
+// the row ids of its parts, intersected with those of id >= 50
+TEST_F(ExecutorTest, IndexScanOrTest) {
+  auto catalog = GetExecutorContext()->GetCatalog();
+  IndexInfo *id_index = nullptr, *account_index = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-1", {"id"}, GetTxn(), id_index, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-2", {"account"}, GetTxn(), account_index, "bptree"));
+  TableInfo *table_info = nullptr;
+  catalog->GetTable("table-1", table_info);
+  // the account of row 500 is looked up through the other index
+  Row row_500;
+  for (auto iter = table_info->GetTableHeap()->Begin(GetTxn()); iter != table_info->GetTableHeap()->End(); ++iter) {
+    if (iter->GetField(0)->CompareEquals(Field(kTypeInt, 500)) == CmpBool::kTrue) {
+      row_500 = *iter;
+    }
+  }
+  auto id = std::make_shared<ColumnValueExpression>(0, 0, kTypeInt);
+  auto account = std::make_shared<ColumnValueExpression>(0, 2, kTypeFloat);
+  auto below = MakeComparisonExpression(id, MakeConstantValueExpression(Field(kTypeInt, 100)), "<");
+  auto above = MakeComparisonExpression(id, MakeConstantValueExpression(Field(kTypeInt, 900)), ">=");
+  auto equal = MakeComparisonExpression(account, MakeConstantValueExpression(*row_500.GetField(2)), "=");
+  auto lower = MakeComparisonExpression(id, MakeConstantValueExpression(Field(kTypeInt, 50)), ">=");
+  auto col_id = MakeColumnValueExpression(*table_info->GetSchema(), 0, "id");
+  auto plan = std::make_shared<IndexScanPlanNode>(
+      MakeOutputSchema({{"id", col_id}}), "table-1", std::vector<IndexInfo *>{id_index, id_index, account_index, id_index},
+      false, nullptr, std::vector<std::vector<AbstractExpressionRef>>{{below}, {above}, {equal}, {lower}}, false,
+      std::vector<uint32_t>{0, 0, 0, 1});
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<int> ids;
+  for (const auto &row : result_set) {
+    int32_t id_value;
+    row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&id_value));
+    ids.push_back(id_value);
+  }
+  std::sort(ids.begin(), ids.end());
+  std::vector<int> expected;
+  for (auto iter = table_info->GetTableHeap()->Begin(GetTxn()); iter != table_info->GetTableHeap()->End(); ++iter) {
+    int32_t id_value;
+    iter->GetField(0)->SerializeTo(reinterpret_cast<char *>(&id_value));
+    bool same_account = iter->GetField(2)->CompareEquals(*row_500.GetField(2)) == CmpBool::kTrue;
+    if (id_value >= 50 && (id_value < 100 || id_value >= 900 || same_account)) {
+      expected.push_back(id_value);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(expected, ids);
+}
+
+// SELECT grp, count(*), sum(val), min(val), max(val) FROM table-2 GROUP BY grp, in memory and spilled
+TEST_F(ExecutorTest, HashAggregationTest) {
+  std::vector<Column *> columns = {new Column("grp", TypeId::kTypeInt, 0, true, false),
+                                   new Column("val", TypeId::kTypeInt, 1, false, false)};
+  TableInfo *table_info = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_info));
+  // count, sum, min and max of each group, the null group under -1
+  std::map<int, std::vector<int64_t>> expected;
+  for (int i = 0; i < 5000; i++) {
+    Fields fields{i % 7 == 0 ? Field(kTypeInt) : Field(kTypeInt, i % 700), Field(kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+    auto &group = expected[i % 7 == 0 ? -1 : i % 700];
+    if (group.empty()) {
+      group = {0, 0, i, i};
+    }
+    group[0]++;
+    group[1] += i;
+    group[3] = i;
+  }
+  auto col_grp = MakeColumnValueExpression(*table_info->GetSchema(), 0, "grp");
+  auto col_val = MakeColumnValueExpression(*table_info->GetSchema(), 0, "val");
+  auto scan_schema = MakeOutputSchema({{"grp", col_grp}, {"val", col_val}});
+  auto scan = std::make_shared<SeqScanPlanNode>(scan_schema, table_info->GetTableName());
+  auto parallel_scan = std::make_shared<SeqScanPlanNode>(scan_schema, table_info->GetTableName(), nullptr, true);
+  auto grp = std::make_shared<ColumnValueExpression>(0, 0, kTypeInt);
+  auto val = std::make_shared<ColumnValueExpression>(0, 1, kTypeInt);
+  std::vector<AbstractExpressionRef> aggregates{
+      std::make_shared<AggregateExpression>(AggregationType::CountStar, nullptr),
+      std::make_shared<AggregateExpression>(AggregationType::Sum, val),
+      std::make_shared<AggregateExpression>(AggregationType::Min, val),
+      std::make_shared<AggregateExpression>(AggregationType::Max, val)};
+  std::vector<AbstractExpressionRef> output_exprs;
+  for (uint32_t i = 0; i < 5; i++) {
+    output_exprs.push_back(std::make_shared<ColumnValueExpression>(0, i, kTypeInt));
+  }
+  auto out_schema = MakeOutputSchema({{"grp", output_exprs[0]},
+                                      {"count", output_exprs[1]},
+                                      {"sum", output_exprs[2]},
+                                      {"min", output_exprs[3]},
+                                      {"max", output_exprs[4]}});
+  auto verify = [&expected](std::vector<Row> &result_set) {
+    ASSERT_EQ(expected.size(), result_set.size());
+    std::map<int, std::vector<int64_t>> groups;
+    for (auto &row : result_set) {
+      ASSERT_EQ(5, row.GetFieldCount());
+      std::vector<int64_t> values;
+      for (uint32_t i = 1; i < 5; i++) {
+        int32_t value;
+        row.GetField(i)->SerializeTo(reinterpret_cast<char *>(&value));
+        values.push_back(value);
+      }
+      int32_t key = -1;
+      if (!row.GetField(0)->IsNull()) {
+        row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&key));
+      }
+      ASSERT_TRUE(groups.emplace(key, values).second);
+    }
+    ASSERT_EQ(expected, groups);
+  };
+  for (const auto &child : {scan, parallel_scan}) {
+    auto plan = std::make_shared<AggregationPlanNode>(out_schema, child, std::vector<AbstractExpressionRef>{grp},
+                                                      aggregates, output_exprs);
+    std::vector<Row> result_set;
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    verify(result_set);
+  }
+  // a budget of a page spills the rows of most groups, Init() twice to check the restart
+  auto plan = std::make_shared<AggregationPlanNode>(out_schema, scan, std::vector<AbstractExpressionRef>{grp},
+                                                    aggregates, output_exprs);
+  HashAggregationExecutor spilled(GetExecutorContext(), plan.get(),
+                                  std::make_unique<SeqScanExecutor>(GetExecutorContext(), scan.get()), PAGE_SIZE);
+  for (int round = 0; round < 2; round++) {
+    spilled.Init();
+    std::vector<Row> result_set;
+    Row row;
+    RowId rid;
+    while (spilled.Next(&row, &rid)) {
+      result_set.push_back(row);
+    }
+    verify(result_set);
+  }
+  // without group by there is one group, even over no rows
+  auto empty_filter = MakeComparisonExpression(col_val, MakeConstantValueExpression(Field(kTypeInt, 0)), "<");
+  auto empty_scan = std::make_shared<SeqScanPlanNode>(scan_schema, table_info->GetTableName(), empty_filter);
+  auto total = std::make_shared<AggregationPlanNode>(
+      MakeOutputSchema({{"count", output_exprs[0]}, {"sum", output_exprs[1]}}), empty_scan,
+      std::vector<AbstractExpressionRef>{}, std::vector<AbstractExpressionRef>{aggregates[0], aggregates[1]},
+      std::vector<AbstractExpressionRef>{output_exprs[0], output_exprs[1]});
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(total, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(1, result_set.size());
+  int32_t count;
+  result_set[0].GetField(0)->SerializeTo(reinterpret_cast<char *>(&count));
+  ASSERT_EQ(0, count);
+  ASSERT_TRUE(result_set[0].GetField(1)->IsNull());
+}
+
+// SELECT val FROM table-2 ORDER BY grp, val DESC [LIMIT n], in memory, spilled and with a heap
+TEST_F(ExecutorTest, SortTest) {
+  std::vector<Column *> columns = {new Column("grp", TypeId::kTypeInt, 0, true, false),
+                                   new Column("val", TypeId::kTypeInt, 1, false, false)};
+  TableInfo *table_info = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_info));
+  // the vals in order, null groups first
+  std::vector<std::pair<int, int>> keys;
+  for (int i = 0; i < 5000; i++) {
+    int grp = (i * 7919) % 97;
+    Fields fields{grp == 0 ? Field(kTypeInt) : Field(kTypeInt, grp), Field(kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+    keys.emplace_back(grp, -i);
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<int> expected;
+  for (const auto &key : keys) {
+    expected.push_back(-key.second);
+  }
+  auto col_grp = MakeColumnValueExpression(*table_info->GetSchema(), 0, "grp");
+  auto col_val = MakeColumnValueExpression(*table_info->GetSchema(), 0, "val");
+  // val first, grp after it read by the sort only
+  auto scan = std::make_shared<SeqScanPlanNode>(MakeOutputSchema({{"val", col_val}, {"grp", col_grp}}),
+                                                table_info->GetTableName());
+  auto val = std::make_shared<ColumnValueExpression>(0, 0, kTypeInt);
+  auto grp = std::make_shared<ColumnValueExpression>(0, 1, kTypeInt);
+  std::vector<OrderBy> order_bys{{OrderByType::Asc, grp}, {OrderByType::Desc, val}};
+  auto out_schema = MakeOutputSchema({{"val", val}});
+  auto verify = [&expected](AbstractExecutor *executor, size_t limit) {
+    std::vector<int> vals;
+    Row row;
+    RowId rid;
+    while (executor->Next(&row, &rid)) {
+      ASSERT_EQ(1, row.GetFieldCount());
+      int32_t value;
+      row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&value));
+      vals.push_back(value);
+    }
+    ASSERT_EQ(std::vector<int>(expected.begin(), expected.begin() + std::min(limit, expected.size())), vals);
+  };
+  // a budget of a page writes more runs than are merged at once, a heap of 3000 rows outgrows it
+  for (size_t limit : {SortPlanNode::kNoLimit, size_t(10), size_t(3000)}) {
+    auto plan = std::make_shared<SortPlanNode>(out_schema, scan, order_bys, limit);
+    for (size_t budget : {EXECUTOR_MEMORY_BUDGET, size_t(PAGE_SIZE)}) {
+      SortExecutor sort(GetExecutorContext(), plan.get(),
+                        std::make_unique<SeqScanExecutor>(GetExecutorContext(), scan.get()), budget);
+      // Init() twice to check the restart
+      for (int round = 0; round < 2; round++) {
+        sort.Init();
+        verify(&sort, limit);
+      }
+    }
+  }
+}
+
+// SELECT id FROM table-1 LIMIT n OFFSET m
+TEST_F(ExecutorTest, LimitTest) {
+  TableInfo *table_info = nullptr;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  auto col_id = MakeColumnValueExpression(*table_info->GetSchema(), 0, "id");
+  auto out_schema = MakeOutputSchema({{"id", col_id}});
+  auto scan = std::make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName());
+  auto ids = [](const std::vector<Row> &result_set) {
+    std::vector<int> values;
+    for (const auto &row : result_set) {
+      int32_t value;
+      row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&value));
+      values.push_back(value);
+    }
+    return values;
+  };
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(scan, &result_set, GetTxn(), GetExecutorContext());
+  auto all = ids(result_set);
+  ASSERT_EQ(1000, all.size());
+  const size_t no_limit = LimitPlanNode::kNoLimit;
+  std::vector<std::pair<size_t, size_t>> cases{{0, 0},    {0, 10},   {5, 10},        {995, 10},
+                                               {1000, 5}, {2000, 1}, {10, no_limit}, {0, no_limit}};
+  for (const auto &[offset, limit] : cases) {
+    auto plan = std::make_shared<LimitPlanNode>(out_schema, scan, offset, limit);
+    result_set.clear();
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    size_t first = std::min(offset, all.size());
+    size_t last = limit == no_limit ? all.size() : std::min(all.size(), first + limit);
+    ASSERT_EQ(std::vector<int>(all.begin() + first, all.begin() + last), ids(result_set));
+  }
+  // reaching the limit closes the scan, which unpins its page at once
+  auto plan = std::make_shared<LimitPlanNode>(out_schema, scan, 2, 3);
+  LimitExecutor limit(GetExecutorContext(), plan.get(),
+                      std::make_unique<SeqScanExecutor>(GetExecutorContext(), scan.get()));
+  for (int round = 0; round < 2; round++) {
+    limit.Init();
+    RowBatch batch;
+    ASSERT_TRUE(limit.NextBatch(&batch));
+    ASSERT_EQ(3, batch.SelectedCount());
+    Row row;
+    batch.GetRow(0, &row);
+    int32_t value;
+    row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&value));
+    ASSERT_EQ(all[2], value);
+    ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+    ASSERT_FALSE(limit.NextBatch(&batch));
+    // the batch gets its capacity back after the child filled it
+    ASSERT_EQ(EXECUTOR_BATCH_SIZE, batch.GetCapacity());
+  }
+}
@@ -0,0 +1,125 @@
+#include "executor/filter_kernels.h"
+
+#include <cmath>
+#include <vector>
+
+#include "executor/compiled_predicate.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "utils/utils.h"
+
+namespace {
+
+const CompareOp kAllOps[] = {CompareOp::kEqual,          CompareOp::kNotEqual,    CompareOp::kLessThan,
+                             CompareOp::kLessThanEquals, CompareOp::kGreaterThan, CompareOp::kGreaterThanEquals};
+
+template <typename T>
+bool Expected(CompareOp op, T lhs, T rhs) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return lhs == rhs;
+    case CompareOp::kNotEqual:
+      return lhs != rhs;
+    case CompareOp::kLessThan:
+      return lhs < rhs;
+    case CompareOp::kLessThanEquals:
+      return lhs <= rhs;
+    case CompareOp::kGreaterThan:
+      return lhs > rhs;
+    default:
+      return lhs >= rhs;
+  }
+}
+
+template <typename T>
+void CheckBitmap(const std::vector<T> &values, CompareOp op, T constant, const std::vector<uint64_t> &bitmap) {
+  for (size_t i = 0; i < bitmap.size() * 64; i++) {
+    bool bit = (bitmap[i / 64] >> (i % 64)) & 1;
+    ASSERT_EQ(i < values.size() && Expected(op, values[i], constant), bit) << "row " << i;
+  }
+}
+
+std::vector<const FilterKernels *> AllKernels() {
+  std::vector<const FilterKernels *> kernels{&FilterKernels::Scalar()};
+  if (FilterKernels::Avx2() != nullptr) {
+    kernels.push_back(FilterKernels::Avx2());
+  }
+  return kernels;
+}
+
+}  // namespace
+
+TEST(FilterKernelsTest, CompareMatchesScalarLoop) {
+  for (auto kernels : AllKernels()) {
+    for (size_t count : {0, 1, 7, 63, 64, 65, 200, 1024}) {
+      std::vector<int32_t> ints(count);
+      std::vector<float> floats(count);
+      for (size_t i = 0; i < count; i++) {
+        ints[i] = RandomUtils::RandomInt(-5, 5);
+        floats[i] = i % 17 == 0 ? NAN : static_cast<float>(RandomUtils::RandomInt(-5, 5)) / 2;
+      }
+      for (auto op : kAllOps) {
+        // words past the bitmap must not be touched
+        std::vector<uint64_t> bitmap((count + 63) / 64 + 1, ~0ULL);
+        kernels->compare_ints(ints.data(), count, op, 1, bitmap.data());
+        ASSERT_EQ(~0ULL, bitmap.back()) << kernels->name;
+        bitmap.pop_back();
+        CheckBitmap(ints, op, 1, bitmap);
+        bitmap.assign((count + 63) / 64, ~0ULL);
+        kernels->compare_floats(floats.data(), count, op, 0.5f, bitmap.data());
+        CheckBitmap(floats, op, 0.5f, bitmap);
+      }
+    }
+  }
+}
+
+// a conjunction over int / float columns is filtered with the kernels, starting from the current selection
+TEST(FilterKernelsTest, VectorizedFilter) {
+  std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, true, false),
+                                   new Column("b", TypeId::kTypeFloat, 1, true, false)};
+  Schema schema(columns);
+  RowBatch batch;
+  batch.Reset(&schema);
+  std::vector<Row> rows;
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Field> fields{i % 9 == 0 ? Field(kTypeInt) : Field(kTypeInt, i % 100),
+                              Field(kTypeFloat, static_cast<float>(i % 10))};
+    rows.emplace_back(fields);
+    batch.Append(rows.back());
+  }
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, kTypeInt);
+  auto b = std::make_shared<ColumnValueExpression>(0, 1, kTypeFloat);
+  // a between 10 and 60 and b <> 3
+  AbstractExpressionRef predicate = std::make_shared<LogicExpression>(
+      std::make_shared<LogicExpression>(
+          std::make_shared<ComparisonExpression>(a, std::make_shared<ConstantValueExpression>(Field(kTypeInt, 10)),
+                                                 ">="),
+          std::make_shared<ComparisonExpression>(a, std::make_shared<ConstantValueExpression>(Field(kTypeInt, 60)),
+                                                 "<="),
+          LogicType::And),
+      std::make_shared<ComparisonExpression>(b, std::make_shared<ConstantValueExpression>(Field(kTypeFloat, 3.0f)),
+                                             "<>"),
+      LogicType::And);
+  CompiledPredicate compiled(predicate);
+  ASSERT_TRUE(compiled.IsVectorized());
+  // keep only every other row before filtering
+  auto &selection = batch.GetSelection();
+  selection.clear();
+  for (uint32_t i = 0; i < rows.size(); i += 2) {
+    selection.push_back(i);
+  }
+  compiled.Filter(&batch);
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < rows.size(); i += 2) {
+    if (predicate->Evaluate(&rows[i]).CompareEquals(Field(kTypeInt, 1)) == CmpBool::kTrue) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, batch.GetSelection());
+  // an or cannot be combined with and over bitmaps
+  auto either = std::make_shared<LogicExpression>(predicate, predicate, LogicType::Or);
+  ASSERT_FALSE(CompiledPredicate(either).IsVectorized());
+}
@@ -0,0 +1,87 @@
+#include "executor/rowid_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/utils.h"
+
+namespace {
+
+using RowIdKeys = std::set<std::pair<page_id_t, uint32_t>>;
+
+// a row id as a pair ordered by page, then by slot
+std::pair<page_id_t, uint32_t> Key(const RowId &rid) { return {rid.GetPageId(), rid.GetSlotNum()}; }
+
+// some pages hold a few slots, the others most of theirs
+RowIdBitmap RandomBitmap(RowIdKeys *expected) {
+  RowIdBitmap bitmap;
+  for (page_id_t page = 0; page < 40; page++) {
+    int slots = RandomUtils::RandomInt(0, 1) == 0 ? RandomUtils::RandomInt(0, 8) : RandomUtils::RandomInt(100, 300);
+    for (int i = 0; i < slots; i++) {
+      RowId rid(page * 3, RandomUtils::RandomInt(0, 511));
+      bitmap.Add(rid);
+      expected->insert(Key(rid));
+    }
+  }
+  return bitmap;
+}
+
+void ExpectEqual(const RowIdKeys &expected, const RowIdBitmap &bitmap) {
+  std::vector<RowId> rids;
+  bitmap.AppendTo(&rids);
+  std::vector<std::pair<page_id_t, uint32_t>> keys;
+  std::transform(rids.begin(), rids.end(), std::back_inserter(keys), Key);
+  // the row ids come out in page order, then in slot order
+  std::vector<std::pair<page_id_t, uint32_t>> expected_keys(expected.begin(), expected.end());
+  ASSERT_EQ(expected_keys, keys);
+  ASSERT_EQ(expected.size(), bitmap.Size());
+  for (const auto &rid : rids) {
+    ASSERT_TRUE(bitmap.Contains(rid));
+  }
+}
+
+}  // namespace
+
+TEST(RowIdBitmapTest, AddTest) {
+  RowIdKeys expected;
+  RowIdBitmap bitmap = RandomBitmap(&expected);
+  ExpectEqual(expected, bitmap);
+  ASSERT_FALSE(bitmap.Contains(RowId(1, 0)));
+  ASSERT_FALSE(bitmap.Contains(RowId(1000, 0)));
+}
+
+TEST(RowIdBitmapTest, IntersectUnionTest) {
+  for (int round = 0; round < 20; round++) {
+    RowIdKeys a, b, expected;
+    RowIdBitmap x = RandomBitmap(&a);
+    RowIdBitmap y = RandomBitmap(&b);
+    RowIdBitmap both = x;
+    both.IntersectWith(y);
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+    ExpectEqual(expected, both);
+    expected.clear();
+    RowIdBitmap either = x;
+    either.UnionWith(y);
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+    ExpectEqual(expected, either);
+  }
+  // a dense page intersected down to a few slots, and those united into a dense page again
+  RowIdBitmap dense, sparse;
+  for (uint32_t slot = 0; slot < 400; slot++) {
+    dense.Add(RowId(7, slot));
+  }
+  sparse.Add(RowId(7, 3));
+  sparse.Add(RowId(7, 399));
+  sparse.Add(RowId(7, 450));
+  sparse.Add(RowId(8, 3));
+  RowIdBitmap result = sparse;
+  result.IntersectWith(dense);
+  ExpectEqual({{7, 3}, {7, 399}}, result);
+  result.UnionWith(dense);
+  ASSERT_EQ(400, result.Size());
+  result.IntersectWith(RowIdBitmap());
+  ASSERT_TRUE(result.Empty());
+}
@@ -0,0 +1,99 @@
+#include "index/art_index.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+
+TEST(ArtIndexTests, InsertScanRemoveTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, true, false)};
+  std::vector<uint32_t> index_key_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  ArtIndex index(0, index_schema, KeyManager::GetEncodedSize(index_schema));
+  // negative and positive ids spread over every byte of the key, so nodes of all sizes grow and shrink
+  std::mt19937 rng(2023);
+  std::uniform_int_distribution<int> dist(-1000000, 1000000);
+  std::map<int, int> expected;
+  char name[] = "minisql";
+  while (expected.size() < 30000) {
+    int id = dist(rng);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 7, true)};
+    bool fresh = expected.emplace(id, static_cast<int>(expected.size())).second;
+    ASSERT_EQ(fresh ? DB_SUCCESS : DB_FAILED, index.InsertEntry(Row(fields), RowId(expected[id], 0), nullptr));
+  }
+  for (const auto &entry : expected) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, entry.first), Field(TypeId::kTypeChar, name, 7, true)};
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(fields), ret, nullptr));
+    ASSERT_EQ(1, ret.size());
+    ASSERT_EQ(entry.second, ret[0].GetPageId());
+  }
+  // the keys come back in order, like from a B+ tree
+  std::vector<Field> probe{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, name, 7, true)};
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(probe), ret, nullptr, "<"));
+  auto end = expected.lower_bound(0);
+  ASSERT_EQ(std::distance(expected.begin(), end), ret.size());
+  auto it = expected.begin();
+  for (size_t i = 0; i < ret.size(); i++, ++it) {
+    ASSERT_EQ(it->second, ret[i].GetPageId());
+  }
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(probe), ret, nullptr, ">="));
+  ASSERT_EQ(std::distance(end, expected.end()), ret.size());
+  // remove every other key, the rest is still found
+  bool remove = true;
+  for (auto iter = expected.begin(); iter != expected.end(); remove = !remove) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, iter->first), Field(TypeId::kTypeChar, name, 7, true)};
+    if (remove) {
+      ASSERT_EQ(DB_SUCCESS, index.RemoveEntry(Row(fields), RowId(iter->second, 0), nullptr));
+      ASSERT_EQ(DB_KEY_NOT_FOUND, index.RemoveEntry(Row(fields), RowId(iter->second, 0), nullptr));
+      iter = expected.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  for (const auto &entry : expected) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, entry.first), Field(TypeId::kTypeChar, name, 7, true)};
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(fields), ret, nullptr));
+    ASSERT_EQ(entry.second, ret[0].GetPageId());
+  }
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(probe), ret, nullptr, "<>"));
+  ASSERT_EQ(expected.size() - expected.count(0), ret.size());
+  ASSERT_EQ(DB_SUCCESS, index.Destroy());
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.ScanKey(Row(probe), ret, nullptr, "<>"));
+}
+
+TEST(ArtIndexTests, DuplicateKeyTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  ArtIndex index(0, index_schema, KeyManager::GetEncodedSize(index_schema) + sizeof(int64_t), false);
+  for (int i = 0; i < 3000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i < 2000 ? 7 : i)};
+    ASSERT_EQ(DB_SUCCESS, index.InsertEntry(Row(fields), RowId(i, 0), nullptr));
+  }
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 7)};
+  Row key(fields);
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(key, ret, nullptr));
+  ASSERT_EQ(2000, ret.size());
+  // the row id picks the one entry to remove
+  ASSERT_EQ(DB_SUCCESS, index.RemoveEntry(key, RowId(1500, 0), nullptr));
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(key, ret, nullptr));
+  ASSERT_EQ(1999, ret.size());
+  ASSERT_TRUE(std::find(ret.begin(), ret.end(), RowId(1500, 0)) == ret.end());
+  std::vector<Field> other{Field(TypeId::kTypeInt, 2500)};
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(other), ret, nullptr, "<="));
+  ASSERT_EQ(1999 + 501, ret.size());
+}
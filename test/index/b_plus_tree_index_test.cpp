@@ -1,5 +1,7 @@
 #include "index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <random>
 #include <string>
 
 #include "common/instance.h"
@@ -67,3 +69,327 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     }
     delete index;
 }
+
+TEST(BPlusTreeTests, BPlusTreeIndexPrefixScanTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, false, false),
+                                     new Column("b", TypeId::kTypeInt, 1, false, false)};
+    std::vector<uint32_t> index_key_map{0, 1};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto *index = new BPlusTreeIndex(0, index_schema, 32, engine.bpm_);
+    // keys (a, b) for a in [0, 10), b in [0, 100)
+    for (int a = 0; a < 10; a++) {
+        for (int b = 0; b < 100; b++) {
+            std::vector<Field> fields{Field(TypeId::kTypeInt, a), Field(TypeId::kTypeInt, b)};
+            Row row(fields);
+            ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(a, b), nullptr));
+        }
+    }
+    // a = 3
+    std::vector<Field> prefix{Field(TypeId::kTypeInt, 3)};
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanPrefix(prefix, ret, nullptr));
+    ASSERT_EQ(100, ret.size());
+    for (uint32_t i = 0; i < ret.size(); i++) {
+        ASSERT_EQ(3, ret[i].GetPageId());
+        ASSERT_EQ(i, ret[i].GetSlotNum());
+    }
+    // a = 3 and b > 5 and b <= 20
+    Field lower(TypeId::kTypeInt, 5);
+    Field upper(TypeId::kTypeInt, 20);
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanPrefix(prefix, ret, nullptr, &lower, false, &upper, true));
+    ASSERT_EQ(15, ret.size());
+    ASSERT_EQ(6, ret.front().GetSlotNum());
+    ASSERT_EQ(20, ret.back().GetSlotNum());
+    // the same range again, decoding the keys for an index-only scan
+    std::vector<Row> key_rows;
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanPrefix(prefix, ret, nullptr, &lower, false, &upper, true, &key_rows));
+    ASSERT_EQ(ret.size(), key_rows.size());
+    for (uint32_t i = 0; i < key_rows.size(); i++) {
+        ASSERT_EQ(ret[i].Get(), key_rows[i].GetRowId().Get());
+        ASSERT_EQ(CmpBool::kTrue, key_rows[i].GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 3)));
+        ASSERT_EQ(CmpBool::kTrue, key_rows[i].GetField(1)->CompareEquals(Field(TypeId::kTypeInt, 6 + (int)i)));
+    }
+    // b < 0 and a > 9 select nothing
+    Field below(TypeId::kTypeInt, 0);
+    ret.clear();
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanPrefix(prefix, ret, nullptr, nullptr, true, &below, false));
+    std::vector<Field> no_prefix;
+    Field above(TypeId::kTypeInt, 9);
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanPrefix(no_prefix, ret, nullptr, &above, false));
+    // a >= 9 reaches the last key of the tree
+    ASSERT_EQ(DB_SUCCESS, index->ScanPrefix(no_prefix, ret, nullptr, &above, true));
+    ASSERT_EQ(100, ret.size());
+    ASSERT_EQ(99, ret.back().GetSlotNum());
+    delete index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexDuplicateKeyTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto *unique_index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_);
+    auto *index = new BPlusTreeIndex(1, index_schema, 32, engine.bpm_, false);
+    // 5 distinct keys, 200 entries each, spread over many leaves
+    for (int i = 0; i < 1000; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i % 5)};
+        Row row(fields);
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i, 0), nullptr));
+        ASSERT_EQ(i < 5 ? DB_SUCCESS : DB_FAILED, unique_index->InsertEntry(row, RowId(i, 0), nullptr));
+    }
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2)};
+    Row key(fields);
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(200, ret.size());
+    for (uint32_t i = 0; i < ret.size(); i++) {
+        ASSERT_EQ(i * 5 + 2, ret[i].GetPageId());
+    }
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr, ">"));
+    ASSERT_EQ(400, ret.size());
+    // remove exactly one of the duplicates
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, RowId(502, 0), nullptr));
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(199, ret.size());
+    ASSERT_TRUE(std::find(ret.begin(), ret.end(), RowId(502, 0)) == ret.end());
+    delete index;
+    delete unique_index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexBulkLoadTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto *index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_);
+    // enough shuffled keys to take the parallel sort path
+    const int n = 100000;
+    std::vector<int> ids(n);
+    for (int i = 0; i < n; i++) {
+        ids[i] = i * 2;
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+    std::vector<Row> key_rows;
+    for (int id : ids) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+        key_rows.emplace_back(fields);
+        key_rows.back().SetRowId(RowId(id, 0));
+    }
+    ASSERT_EQ(DB_SUCCESS, index->BulkLoad(key_rows, nullptr));
+    // the leaves hold every key in order
+    int expected = 0;
+    for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+        ASSERT_EQ(expected, (*iter).second.GetPageId());
+        expected += 2;
+    }
+    ASSERT_EQ(2 * n, expected);
+    // the tree keeps working with ordinary inserts and removes
+    for (int i = 0; i < 1000; i++) {
+        std::vector<Field> odd{Field(TypeId::kTypeInt, i * 2 + 1)};
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(odd), RowId(i * 2 + 1, 0), nullptr));
+        std::vector<Field> even{Field(TypeId::kTypeInt, i * 4)};
+        ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(Row(even), RowId(i * 4, 0), nullptr));
+    }
+    for (int id = 0; id < 2000; id++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+        std::vector<RowId> ret;
+        bool present = (id % 2 == 1) || (id % 4 == 2);
+        ASSERT_EQ(present ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    // a duplicate key leaves a unique index empty
+    auto *unique_index = new BPlusTreeIndex(1, index_schema, 16, engine.bpm_);
+    key_rows.push_back(key_rows.front());
+    ASSERT_EQ(DB_FAILED, unique_index->BulkLoad(key_rows, nullptr));
+    ASSERT_TRUE(unique_index->GetBeginIterator() == unique_index->GetEndIterator());
+    delete index;
+    delete unique_index;
+}
+
+// a bulk load over its memory budget sorts runs of keys on temporary pages and merges them into the tree
+TEST(BPlusTreeTests, BPlusTreeIndexSpilledBulkLoadTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("account", TypeId::kTypeFloat, 1, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    const int n = 50000;
+    std::vector<int> ids(n);
+    for (int i = 0; i < n; i++) {
+        ids[i] = i * 2;
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+    // table rows, the key is taken from their first column
+    std::vector<Row> rows;
+    for (int id : ids) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, 0.5f)};
+        rows.emplace_back(fields);
+        rows.back().SetRowId(RowId(id, 0));
+    }
+    size_t next_row = 0;
+    auto next = [&rows, &next_row]() { return next_row < rows.size() ? &rows[next_row++] : nullptr; };
+    auto meta = reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData());
+    uint32_t allocated = meta->GetAllocatedPages();
+    // about 80 runs of 640 keys, more than one merge takes
+    auto *index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_);
+    ASSERT_EQ(DB_SUCCESS, index->BulkLoad({0}, next, nullptr, 640 * 24));
+    int expected = 0;
+    for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+        ASSERT_EQ(expected, (*iter).second.GetPageId());
+        expected += 2;
+    }
+    ASSERT_EQ(2 * n, expected);
+    for (int id = 0; id < 1000; id++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+        std::vector<RowId> ret;
+        ASSERT_EQ(id % 2 == 0 ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    // the runs are freed, only the tree keeps pages: 331 leaves of 151 keys, their parents and the bloom filter
+    uint32_t tree_pages = meta->GetAllocatedPages() - allocated;
+    ASSERT_LE(tree_pages, n / 100);
+    // a key repeated in two runs leaves a unique index empty and frees what was built
+    auto *unique_index = new BPlusTreeIndex(1, index_schema, 16, engine.bpm_);
+    rows.push_back(rows.front());
+    next_row = 0;
+    ASSERT_EQ(DB_FAILED, unique_index->BulkLoad({0}, next, nullptr, 640 * 24));
+    ASSERT_TRUE(unique_index->GetBeginIterator() == unique_index->GetEndIterator());
+    ASSERT_EQ(allocated + tree_pages, meta->GetAllocatedPages());
+    delete index;
+    delete unique_index;
+}
+
+// the pages a char(64) index takes with keys at their encoded width, against slots as wide as the 128 bytes
+// a serialized key row was rounded up to, both trees bulk loaded at the same fill factor
+TEST(BPlusTreeTests, BPlusTreeIndexFanOutTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 64, 0, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    ASSERT_EQ(67, KeyManager::GetEncodedSize(index_schema));
+    const int n = 20000;
+    std::vector<Row> key_rows;
+    for (int i = 0; i < n; i++) {
+        std::string name = "user" + std::to_string(i * 7919 % n) + std::string(i % 40, 'x');
+        std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true)};
+        key_rows.emplace_back(fields);
+        key_rows.back().SetRowId(RowId(i, 0));
+    }
+    auto meta = reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData());
+    auto pages_of = [&](index_id_t index_id, size_t key_size) {
+        uint32_t before = meta->GetAllocatedPages();
+        auto *index = new BPlusTreeIndex(index_id, index_schema, key_size, engine.bpm_);
+        EXPECT_EQ(DB_SUCCESS, index->BulkLoad(key_rows, nullptr));
+        delete index;
+        return meta->GetAllocatedPages() - before;
+    };
+    uint32_t encoded_pages = pages_of(0, 67);
+    uint32_t padded_pages = pages_of(1, 128);
+    // 53 entries a leaf against 28, the pages nearly halve (436 against 834 here); prefix compression is left
+    // out, see KeyManager. Beyond the leaves come the internal pages and the bloom filter
+    ASSERT_LE(encoded_pages, n / (53 * INDEX_FILL_FACTOR) + 32);
+    ASSERT_GE(padded_pages * 10, encoded_pages * 18);
+}
+
+TEST(BPlusTreeTests, GenericKeyOrderTest) {
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                     new Column("account", TypeId::kTypeFloat, 1, true, false),
+                                     new Column("name", TypeId::kTypeChar, 8, 2, true, false)};
+    Schema schema(columns);
+    // the encoded key is as wide as its columns, not a rounded serialized row
+    ASSERT_EQ(5 + 5 + 11, KeyManager::GetEncodedSize(&schema));
+    KeyManager KP(&schema, KeyManager::GetEncodedSize(&schema));
+    char a[] = "ab", ab0[] = "ab\0", b[] = "b";
+    // listed in ascending key order
+    std::vector<std::vector<Field>> rows = {
+        {Field(TypeId::kTypeInt), Field(TypeId::kTypeFloat, 1.0f), Field(TypeId::kTypeChar, a, 2, true)},
+        {Field(TypeId::kTypeInt, -7), Field(TypeId::kTypeFloat, 1.0f), Field(TypeId::kTypeChar, a, 2, true)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, -2.5f), Field(TypeId::kTypeChar, a, 2, true)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, -0.5f), Field(TypeId::kTypeChar, a, 2, true)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.5f), Field(TypeId::kTypeChar)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.5f), Field(TypeId::kTypeChar, a, 2, true)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.5f), Field(TypeId::kTypeChar, ab0, 3, true)},
+        {Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeFloat, 0.5f), Field(TypeId::kTypeChar, b, 1, true)},
+        {Field(TypeId::kTypeInt, 3), Field(TypeId::kTypeFloat, 0.5f), Field(TypeId::kTypeChar, a, 2, true)},
+    };
+    std::vector<GenericKey *> keys;
+    for (auto &fields : rows) {
+        Row row(fields);
+        GenericKey *key = KP.InitKey();
+        KP.SerializeFromKey(key, row, &schema);
+        keys.push_back(key);
+        // round trip
+        Row decoded(INVALID_ROWID);
+        KP.DeserializeToKey(key, decoded, &schema);
+        for (uint32_t i = 0; i < fields.size(); i++) {
+            ASSERT_EQ(fields[i].IsNull(), decoded.GetField(i)->IsNull());
+            if (!fields[i].IsNull()) {
+                ASSERT_EQ(CmpBool::kTrue, fields[i].CompareEquals(*decoded.GetField(i)));
+            }
+        }
+    }
+    for (uint32_t i = 0; i + 1 < keys.size(); i++) {
+        ASSERT_LT(KP.CompareKeys(keys[i], keys[i + 1]), 0);
+        ASSERT_GT(KP.CompareKeys(keys[i + 1], keys[i]), 0);
+        ASSERT_EQ(0, KP.CompareKeys(keys[i], keys[i]));
+    }
+    for (auto key : keys) {
+        free(key);
+    }
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexBloomFilterTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto *index = new BPlusTreeIndex(0, index_schema, KeyManager::GetEncodedSize(index_schema) + sizeof(int64_t),
+                                     engine.bpm_, false);
+    // even keys only, every odd probe is a miss the filter should answer
+    const int n = 4000;
+    for (int i = 0; i < n; i += 2) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(i, 0), nullptr));
+    }
+    std::vector<RowId> ret;
+    for (int i = 0; i < n; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ret.clear();
+        ASSERT_EQ(i % 2 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(Row(fields), ret, nullptr));
+        ret.clear();
+        ASSERT_EQ(i % 2 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanPrefix(fields, ret, nullptr));
+    }
+    // inserts after the filter is built, enough of them to outgrow it, are found as well
+    for (int i = 1; i < 4 * n; i += 2) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(i, 0), nullptr));
+        ret.clear();
+        ASSERT_EQ(DB_SUCCESS, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    // removed keys are gone, a key inserted again after its removal is back
+    for (int i = 0; i < n; i += 2) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(Row(fields), RowId(i, 0), nullptr));
+        ret.clear();
+        ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    for (int i = 0; i < n; i += 4) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(i, 1), nullptr));
+    }
+    for (int i = 0; i < n; i += 2) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        ret.clear();
+        ASSERT_EQ(i % 4 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    delete index;
+}
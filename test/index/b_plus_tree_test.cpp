@@ -80,3 +80,163 @@ TEST(BPlusTreeTests, SampleTest) {
         ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
     }
 }
+
+static uint32_t AllocatedPages(DBStorageEngine &engine) {
+    return reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData())->GetAllocatedPages();
+}
+
+TEST(BPlusTreeTests, LazyDeleteTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {
+            new Column("int", TypeId::kTypeInt, 0, false, false),
+    };
+    Schema *table_schema = new Schema(columns);
+    KeyManager KP(table_schema, 16);
+    const int n = 20000;
+    vector<GenericKey *> keys;
+    for (int i = 0; i < n; i++) {
+        GenericKey *key = KP.InitKey();
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        KP.SerializeFromKey(key, Row(fields), table_schema);
+        keys.push_back(key);
+    }
+    // delete a third of the keys and insert them again, an eager tree merges pages only to split them again
+    uint32_t churn[2];
+    for (int lazy = 0; lazy < 2; lazy++) {
+        BPlusTree tree(lazy, engine.bpm_, KP);
+        tree.SetLazyDelete(lazy);
+        for (int i = 0; i < n; i++) {
+            tree.Insert(keys[i], RowId(i));
+        }
+        uint32_t pages = AllocatedPages(engine);
+        for (int i = 0; i < n; i += 3) {
+            tree.Remove(keys[i]);
+        }
+        ASSERT_TRUE(tree.Check());
+        uint32_t after_delete = AllocatedPages(engine);
+        for (int i = 0; i < n; i += 3) {
+            tree.Insert(keys[i], RowId(i));
+        }
+        ASSERT_TRUE(tree.Check());
+        churn[lazy] = pages - after_delete + AllocatedPages(engine) - after_delete;
+        vector<RowId> ans;
+        for (int i = 0; i < n; i++) {
+            ASSERT_TRUE(tree.GetValue(keys[i], ans));
+            ASSERT_EQ(RowId(i), ans.back());
+        }
+    }
+    ASSERT_GT(churn[0], 0);
+    ASSERT_EQ(0, churn[1]);
+    // thin the lazy tree out, vacuum packs the survivors into fewer pages
+    BPlusTree tree(1, engine.bpm_, KP);
+    for (int i = 0; i < n; i++) {
+        if (i % 10 != 0) {
+            tree.Remove(keys[i]);
+        }
+    }
+    ASSERT_TRUE(tree.Check());
+    uint32_t sparse = AllocatedPages(engine);
+    ASSERT_TRUE(tree.Vacuum());
+    ASSERT_TRUE(tree.Check());
+    ASSERT_LT(AllocatedPages(engine), sparse);
+    vector<RowId> ans;
+    for (int i = 0; i < n; i++) {
+        ASSERT_EQ(i % 10 == 0, tree.GetValue(keys[i], ans));
+    }
+    // the new root is registered, a reopened tree finds the same entries
+    BPlusTree reopened(1, engine.bpm_, KP);
+    ASSERT_EQ(tree.root_page_id_, reopened.root_page_id_);
+    for (auto key : keys) {
+        free(key);
+    }
+}
+
+TEST(BPlusTreeTests, DestroyTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {
+            new Column("int", TypeId::kTypeInt, 0, false, false),
+    };
+    Schema *table_schema = new Schema(columns);
+    KeyManager KP(table_schema, 16);
+    const int n = 20000;
+    vector<GenericKey *> keys;
+    for (int i = 0; i < n; i++) {
+        GenericKey *key = KP.InitKey();
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        KP.SerializeFromKey(key, Row(fields), table_schema);
+        keys.push_back(key);
+    }
+    uint32_t empty = AllocatedPages(engine);
+    BPlusTree tree(2, engine.bpm_, KP);
+    for (int i = 0; i < n; i++) {
+        tree.Insert(keys[i], RowId(i));
+    }
+    uint32_t full = AllocatedPages(engine);
+    ASSERT_GT(full, empty);
+    // every page goes back to the disk manager and the index id is unregistered
+    tree.Destroy();
+    ASSERT_EQ(empty, AllocatedPages(engine));
+    ASSERT_TRUE(tree.IsEmpty());
+    BPlusTree reopened(2, engine.bpm_, KP);
+    ASSERT_TRUE(reopened.IsEmpty());
+    // the freed pages are handed out again
+    for (int i = 0; i < n; i++) {
+        reopened.Insert(keys[i], RowId(i));
+    }
+    ASSERT_TRUE(reopened.Check());
+    ASSERT_EQ(full, AllocatedPages(engine));
+    for (auto key : keys) {
+        free(key);
+    }
+}
+
+TEST(BPlusTreeTests, PinnedLevelsTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {
+            new Column("int", TypeId::kTypeInt, 0, false, false),
+    };
+    Schema *table_schema = new Schema(columns);
+    KeyManager KP(table_schema, 16);
+    const int n = 5000;
+    vector<GenericKey *> keys;
+    for (int i = 0; i < n; i++) {
+        GenericKey *key = KP.InitKey();
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+        KP.SerializeFromKey(key, Row(fields), table_schema);
+        keys.push_back(key);
+    }
+    vector<GenericKey *> shuffled(keys);
+    ShuffleArray(shuffled);
+    // small pages give a deep tree, so splits and merges keep changing the pinned levels
+    BPlusTree tree(4, engine.bpm_, KP, 8, 8);
+    tree.SetLazyDelete(false);
+    for (auto key : shuffled) {
+        ASSERT_TRUE(tree.Insert(key, RowId(0)));
+    }
+    vector<RowId> ans;
+    for (int i = 0; i < n; i++) {
+        ASSERT_TRUE(tree.GetValue(keys[i], ans));
+    }
+    // the root stays pinned by the tree between lookups
+    Page *root = engine.bpm_->FetchPage(tree.root_page_id_);
+    ASSERT_EQ(2, root->GetPinCount());
+    engine.bpm_->UnpinPage(tree.root_page_id_, false);
+    for (int i = 0; i < n; i += 2) {
+        tree.Remove(shuffled[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        ans.clear();
+        ASSERT_EQ(i % 2 == 1, tree.GetValue(shuffled[i], ans));
+    }
+    ASSERT_TRUE(tree.Check());
+    // without pinning every page is released after each lookup
+    tree.SetPinnedLevels(0);
+    for (int i = 1; i < n; i += 2) {
+        ans.clear();
+        ASSERT_TRUE(tree.GetValue(shuffled[i], ans));
+    }
+    ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+    for (auto key : keys) {
+        free(key);
+    }
+}
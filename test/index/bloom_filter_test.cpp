@@ -0,0 +1,34 @@
+#include "index/bloom_filter.h"
+
+#include <random>
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+
+TEST(BloomFilterTests, FalsePositiveRateTest) {
+  const size_t n = 100000;
+  BloomFilter filter(n);
+  std::mt19937_64 rng(2023);
+  std::unordered_set<uint64_t> inserted;
+  while (inserted.size() < n) {
+    uint64_t hash = rng();
+    inserted.insert(hash);
+    filter.Insert(hash);
+  }
+  // no key that went in is ever ruled out
+  for (auto hash : inserted) {
+    ASSERT_TRUE(filter.MayContain(hash));
+  }
+  // at ten bits per key a blocked filter lets through roughly one miss in a hundred
+  size_t false_positives = 0;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t hash = rng();
+    if (inserted.count(hash) == 0 && filter.MayContain(hash)) {
+      false_positives++;
+    }
+  }
+  ASSERT_LT(false_positives, n * 3 / 100);
+  // an empty filter rules out everything
+  BloomFilter empty(n);
+  ASSERT_FALSE(empty.MayContain(rng()));
+}
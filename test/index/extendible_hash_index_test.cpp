@@ -0,0 +1,92 @@
+#include "index/extendible_hash_index.h"
+
+#include <algorithm>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+
+static const std::string db_name = "hash_index_test.db";
+
+TEST(ExtendibleHashIndexTests, InsertScanRemoveTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("name", TypeId::kTypeChar, 16, 1, true, false)};
+    std::vector<uint32_t> index_key_map{0, 1};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto key_size = KeyManager::GetEncodedSize(index_schema);
+    auto *index = new ExtendibleHashIndex(0, index_schema, key_size, engine.bpm_);
+    // far more keys than one bucket holds, the directory has to grow several times
+    const int n = 20000;
+    char name[] = "minisql";
+    for (int i = 0; i < n; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)};
+        Row row(fields);
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i, 0), nullptr));
+    }
+    // a unique index refuses a key it already holds
+    std::vector<Field> dup{Field(TypeId::kTypeInt, 42), Field(TypeId::kTypeChar, name, 7, true)};
+    ASSERT_EQ(DB_FAILED, index->InsertEntry(Row(dup), RowId(42, 1), nullptr));
+    for (int i = 0; i < n; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)};
+        std::vector<RowId> ret;
+        ASSERT_EQ(DB_SUCCESS, index->ScanKey(Row(fields), ret, nullptr));
+        ASSERT_EQ(1, ret.size());
+        ASSERT_EQ(i, ret[0].GetPageId());
+    }
+    std::vector<Field> missing{Field(TypeId::kTypeInt, n), Field(TypeId::kTypeChar, name, 7, true)};
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(Row(missing), ret, nullptr));
+    ASSERT_EQ(DB_FAILED, index->ScanKey(Row(missing), ret, nullptr, "<"));
+    // remove the even keys
+    for (int i = 0; i < n; i += 2) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)};
+        ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(Row(fields), RowId(i, 0), nullptr));
+    }
+    delete index;
+    // reopen the index from its directory page
+    index = new ExtendibleHashIndex(0, index_schema, key_size, engine.bpm_);
+    for (int i = 0; i < n; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)};
+        ret.clear();
+        ASSERT_EQ(i % 2 ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(Row(fields), ret, nullptr));
+    }
+    ASSERT_EQ(DB_SUCCESS, index->Destroy());
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(Row(dup), ret, nullptr));
+    delete index;
+}
+
+TEST(ExtendibleHashIndexTests, DuplicateKeyTest) {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+    std::vector<uint32_t> index_key_map{0};
+    const TableSchema table_schema(columns);
+    auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+    auto *index = new ExtendibleHashIndex(0, index_schema, KeyManager::GetEncodedSize(index_schema), engine.bpm_,
+                                          false);
+    // 2000 entries of one key can not be split apart and fill a chain of overflow buckets
+    for (int i = 0; i < 3000; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i < 2000 ? 7 : i)};
+        ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(i, 0), nullptr));
+    }
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 7)};
+    Row key(fields);
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(2000, ret.size());
+    // the row id picks the one entry to remove
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, RowId(1500, 0), nullptr));
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(1999, ret.size());
+    ASSERT_TRUE(std::find(ret.begin(), ret.end(), RowId(1500, 0)) == ret.end());
+    for (int i = 2000; i < 3000; i++) {
+        std::vector<Field> other{Field(TypeId::kTypeInt, i)};
+        ret.clear();
+        ASSERT_EQ(DB_SUCCESS, index->ScanKey(Row(other), ret, nullptr));
+        ASSERT_EQ(1, ret.size());
+    }
+    delete index;
+}
@@ -0,0 +1,184 @@
+#include "planner/planner.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "executor/plans/delete_plan.h"
+#include "executor/plans/hash_join_plan.h"
+#include "executor/plans/index_nested_loop_join_plan.h"
+#include "executor/plans/index_scan_plan.h"
+#include "executor/plans/seq_scan_plan.h"
+#include "executor/plans/update_plan.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * The PlannerTest fixture plans statements over table s(id, g, name): id is its primary key, g is 0 in nine
+ * rows out of ten and otherwise equal to id, both are indexed.
+ */
+class PlannerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    db_ = new DBStorageEngine("planner_test.db", true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("g", TypeId::kTypeInt, 1, false, false),
+                                     new Column("name", TypeId::kTypeChar, 16, 2, true, false)};
+    auto catalog = db_->catalog_mgr_;
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("s", new Schema(columns), &txn_, table_info));
+    for (int i = 0; i < kRows; i++) {
+      std::string name = "n" + std::to_string(i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % 10 == 0 ? i : 0),
+                                Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn_));
+    }
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("s", "pk", {"id"}, &txn_, id_index_, "bptree"));
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("s", "ig", {"g"}, &txn_, g_index_, "bptree", false));
+    context_ = db_->MakeExecuteContext(&txn_);
+  }
+
+  void TearDown() override { delete db_; }
+
+  /** Parse one statement and plan it */
+  AbstractPlanNodeRef Plan(const std::string &sql) {
+    YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+    yy_switch_to_buffer(bp);
+    MinisqlParserInit();
+    yyparse();
+    AbstractPlanNodeRef plan = nullptr;
+    EXPECT_FALSE(MinisqlParserGetError()) << sql;
+    if (!MinisqlParserGetError()) {
+      Planner planner(context_.get());
+      planner.PlanQuery(MinisqlGetParserRootNode());
+      plan = planner.plan_;
+    }
+    MinisqlParserFinish();
+    yy_delete_buffer(bp);
+    yylex_destroy();
+    return plan;
+  }
+
+ protected:
+  static constexpr int kRows = 20000;
+  DBStorageEngine *db_{nullptr};
+  Transaction txn_;
+  std::unique_ptr<ExecuteContext> context_;
+  IndexInfo *id_index_{nullptr};
+  IndexInfo *g_index_{nullptr};
+};
+
+TEST_F(PlannerTest, CostBasedAccessPathTest) {
+  ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->AnalyzeTable("s", &txn_));
+  // g = 0 keeps nine rows out of ten, reading the whole table costs less than fetching them through the index
+  auto plan = Plan("select * from s where g = 0;");
+  ASSERT_EQ(PlanType::SeqScan, plan->GetType());
+  plan = Plan("select * from s where id > 100;");
+  ASSERT_EQ(PlanType::SeqScan, plan->GetType());
+  // a value of g held by a single row, and a short range of id, are looked up in their index
+  plan = Plan("select * from s where g = 70;");
+  ASSERT_EQ(PlanType::IndexScan, plan->GetType());
+  auto scan = std::dynamic_pointer_cast<const IndexScanPlanNode>(plan);
+  ASSERT_EQ(std::vector<IndexInfo *>{g_index_}, scan->indexes_);
+  plan = Plan("select * from s where id < 50;");
+  ASSERT_EQ(PlanType::IndexScan, plan->GetType());
+  scan = std::dynamic_pointer_cast<const IndexScanPlanNode>(plan);
+  ASSERT_EQ(std::vector<IndexInfo *>{id_index_}, scan->indexes_);
+  // the selective index is scanned, the common value of g is left to the filter
+  plan = Plan("select * from s where id < 50 and g = 0;");
+  ASSERT_EQ(PlanType::IndexScan, plan->GetType());
+  scan = std::dynamic_pointer_cast<const IndexScanPlanNode>(plan);
+  ASSERT_EQ(std::vector<IndexInfo *>{id_index_}, scan->indexes_);
+  ASSERT_TRUE(scan->need_filter_);
+}
+
+TEST_F(PlannerTest, IndexDrivenUpdateDeleteTest) {
+  ExecuteEngine engine;
+  std::vector<Row> result_set;
+  auto rows_with = [&](const std::string &predicate) {
+    result_set.clear();
+    engine.ExecutePlan(Plan("select id from s where " + predicate + ";"), &result_set, &txn_, context_.get());
+    return result_set.size();
+  };
+  // a row found by its primary key is deleted through the index
+  auto plan = Plan("delete from s where id = 5;");
+  ASSERT_EQ(PlanType::Delete, plan->GetType());
+  auto child = std::dynamic_pointer_cast<const DeletePlanNode>(plan)->GetChildPlan();
+  ASSERT_EQ(PlanType::IndexScan, child->GetType());
+  ASSERT_EQ(std::vector<IndexInfo *>{id_index_},
+            std::dynamic_pointer_cast<const IndexScanPlanNode>(child)->indexes_);
+  ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(plan, &result_set, &txn_, context_.get()));
+  ASSERT_EQ(0, rows_with("id = 5"));
+  ASSERT_EQ(kRows - 1, rows_with("id >= 0"));
+  // the new value of g falls in the range the index scan reads, later in key order than most of the rows it
+  // changes: the row ids are collected before the first change, so moving keys ahead of the scan neither
+  // hides a row from it nor leaves the index out of step with the table
+  plan = Plan("update s set g = 1500 where g >= 10 and g < 2000;");
+  ASSERT_EQ(PlanType::Update, plan->GetType());
+  child = std::dynamic_pointer_cast<const UpdatePlanNode>(plan)->GetChildPlan();
+  ASSERT_EQ(PlanType::IndexScan, child->GetType());
+  ASSERT_EQ(std::vector<IndexInfo *>{g_index_}, std::dynamic_pointer_cast<const IndexScanPlanNode>(child)->indexes_);
+  ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(plan, &result_set, &txn_, context_.get()));
+  ASSERT_EQ(199, rows_with("g = 1500"));
+  ASSERT_EQ(0, rows_with("g = 10"));
+  ASSERT_EQ(0, rows_with("g > 1500 and g < 2000"));
+  // g = 0 in row 0 and in the nine rows out of ten whose id is not a multiple of 10, row 5 among them
+  ASSERT_EQ(kRows / 10 * 9, rows_with("g = 0"));
+  ASSERT_EQ(kRows - 1, rows_with("id >= 0"));
+}
+
+TEST_F(PlannerTest, JoinTest) {
+  auto catalog = db_->catalog_mgr_;
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  for (std::string name : {"t", "u"}) {
+    std::vector<Column *> columns = {new Column(name == "t" ? "a" : "x", TypeId::kTypeInt, 0, false, true),
+                                     new Column(name == "t" ? "b" : "y", TypeId::kTypeInt, 1, false, false)};
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateTable(name, new Schema(columns), &txn_, table_info));
+    ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex(name, name + "_pk", {columns[0]->GetName()}, &txn_, index_info,
+                                               "bptree"));
+  }
+  ExecuteEngine engine;
+  std::vector<Row> result_set;
+  for (std::string sql : {"insert into t values(1, 10);", "insert into t values(2, 20);",
+                          "insert into t values(3, 10);", "insert into u values(10, 100);",
+                          "insert into u values(20, 200);"}) {
+    ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(Plan(sql), &result_set, &txn_, context_.get()));
+  }
+  auto expect_pairs = [&](const std::vector<std::pair<int, int>> &expected) {
+    ASSERT_EQ(expected.size(), result_set.size());
+    for (const auto &pair : expected) {
+      auto it = std::find_if(result_set.begin(), result_set.end(), [&pair](Row &row) {
+        return row.GetField(0)->CompareEquals(Field(kTypeInt, pair.first)) == CmpBool::kTrue &&
+               row.GetField(1)->CompareEquals(Field(kTypeInt, pair.second)) == CmpBool::kTrue;
+      });
+      ASSERT_NE(result_set.end(), it) << pair.first << " " << pair.second;
+    }
+  };
+  // u is indexed on the join column but takes a single page, hashing it costs less than probing the index
+  auto plan = Plan("select t.a, u.y from t, u where t.b = u.x;");
+  ASSERT_EQ(PlanType::HashJoin, plan->GetType());
+  result_set.clear();
+  ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(plan, &result_set, &txn_, context_.get()));
+  expect_pairs({{1, 100}, {2, 200}, {3, 100}});
+  // three rows of t look their matches up in the primary key of s rather than have all of s read
+  plan = Plan("select t.a, s.g from t, s where t.b = s.id;");
+  ASSERT_EQ(PlanType::IndexNestedLoopJoin, plan->GetType());
+  result_set.clear();
+  ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(plan, &result_set, &txn_, context_.get()));
+  expect_pairs({{1, 10}, {2, 20}, {3, 10}});
+  // an equality beyond the looked up key is checked on the joined rows
+  plan = Plan("select t.a, s.g from t, s where t.b = s.id and t.b = s.g and t.a < 3;");
+  ASSERT_EQ(PlanType::IndexNestedLoopJoin, plan->GetType());
+  result_set.clear();
+  ASSERT_EQ(DB_SUCCESS, engine.ExecutePlan(plan, &result_set, &txn_, context_.get()));
+  expect_pairs({{1, 10}, {2, 20}});
+}
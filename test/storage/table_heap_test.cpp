@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "record/field.h"
 #include "record/schema.h"
+#include "storage/table_scanner.h"
 #include "utils/utils.h"
 
 static string db_file_name = "table_heap_test.db";
@@ -48,6 +49,17 @@ TEST(TableHeapTest, TableHeapSampleTest) {
 
   ASSERT_EQ(row_nums, row_values.size());
   ASSERT_EQ(row_nums, size);
+  // the heap counts its pages and slots as rows go in, a heap opened from disk has to measure them first
+  size_t known_pages, known_slots, pages, slots;
+  ASSERT_TRUE(table_heap->GetKnownSize(&known_pages, &known_slots));
+  auto reopened = TableHeap::Create(bpm_, table_heap->GetFirstPageId(), schema.get(), nullptr, nullptr);
+  ASSERT_FALSE(reopened->GetKnownSize(&pages, &slots));
+  reopened->GetSize(&pages, &slots);
+  ASSERT_EQ(known_pages, pages);
+  ASSERT_EQ(row_nums, known_slots);
+  ASSERT_EQ(row_nums, slots);
+  ASSERT_TRUE(reopened->GetKnownSize(&pages, &slots));
+  delete reopened;
   for (auto row_kv : row_values) {
     size--;
     Row row(RowId(row_kv.first));
@@ -62,3 +74,103 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   ASSERT_EQ(size, 0);
     remove(db_file_name.c_str());//
 }
+
+TEST(TableHeapTest, DeleteTableTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  auto meta = reinterpret_cast<DiskFileMetaPage *>(disk_mgr_->GetMetaData());
+  uint32_t empty = meta->GetAllocatedPages();
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char name[64] = "minisql";
+  // far more pages than the buffer pool holds, most of them are only on disk when dropped
+  for (int i = 0; i < 3000; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  uint32_t full = meta->GetAllocatedPages();
+  ASSERT_GT(full - empty, 32);
+  table_heap->DeleteTable();
+  ASSERT_EQ(empty, meta->GetAllocatedPages());
+  // a new heap reuses the freed pages
+  delete table_heap;
+  table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  for (int i = 0; i < 3000; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  ASSERT_EQ(full, meta->GetAllocatedPages());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+// the scanner visits the live tuples in the order of the iterator, and TupleView reads them in place
+TEST(TableHeapTest, TableScannerTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(32, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("age", TypeId::kTypeInt, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char name[64];
+  for (int i = 0; i < 3000; i++) {
+    int32_t len = RandomUtils::RandomInt(0, 64);
+    RandomUtils::RandomString(name, len);
+    Fields fields{i % 7 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, i),
+                  i % 5 == 0 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, name, len, true),
+                  Field(TypeId::kTypeFloat, RandomUtils::RandomFloat(-999.f, 999.f)), Field(TypeId::kTypeInt, -i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    if (i % 3 == 0) {
+      table_heap->ApplyDelete(row.GetRowId(), nullptr);
+    }
+  }
+  TupleView tuple(schema.get());
+  size_t count = 0;
+  {
+    TableScanner scanner(table_heap);
+    for (auto ite = table_heap->Begin(nullptr); ite != table_heap->End(); ++ite, count++) {
+      ASSERT_TRUE(scanner.Next());
+      ASSERT_EQ(ite->GetRowId().Get(), scanner.GetRowId().Get());
+      // locating only the leading columns is enough to read them
+      uint32_t limit = count % 2 == 0 ? 2 : 4;
+      tuple.Reset(scanner.GetTupleData(), limit);
+      for (uint32_t i = 0; i < limit; i++) {
+        const Field *field = ite->GetField(i);
+        ASSERT_EQ(field->IsNull(), tuple.IsNull(i));
+        if (field->IsNull()) {
+          continue;
+        }
+        switch (field->GetTypeId()) {
+          case TypeId::kTypeInt:
+            ASSERT_EQ(CmpBool::kTrue, field->CompareEquals(Field(TypeId::kTypeInt, tuple.GetInt(i))));
+            break;
+          case TypeId::kTypeFloat:
+            ASSERT_EQ(CmpBool::kTrue, field->CompareEquals(Field(TypeId::kTypeFloat, tuple.GetFloat(i))));
+            break;
+          default:
+            ASSERT_EQ(std::string(field->GetData(), field->GetLength()),
+                      std::string(tuple.GetChars(i), tuple.GetCharLength(i)));
+        }
+      }
+    }
+    ASSERT_FALSE(scanner.Next());
+    ASSERT_FALSE(scanner.Next());
+  }
+  ASSERT_EQ(2000, count);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}